@@ -82,6 +82,7 @@ if(GISMO_BUILD_CPP11 AND NOT MSVC)
       set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=c++0x")
     else()
       message(STATUS "The compiler ${CMAKE_CXX_COMPILER} has no C++11 support.")
+      set(GISMO_BUILD_CPP11 OFF)
     endif()
   endif()
 endif()
@@ -142,6 +142,63 @@ int main(int argc, char *argv[])
     CGSolver.solve(rhs,x0);
     gsIterativeSolverInfo(CGSolver, "CG", clock.stop());
 
+    //CG preconditioned by a Chebyshev accelerated Jacobi polynomial
+    gsChebyshevOp<gsSparseMatrix<> >::Ptr chebyshev = gsChebyshevOp<gsSparseMatrix<> >::make(mat, 4);
+    chebyshev->setEigenvalueRatio(10);
+    gsConjugateGradient ChebCGSolver(mat,chebyshev);
+    ChebCGSolver.setOptions(opt);
+    x0.setZero(N,1);
+    gsInfo << "\nCG with Chebyshev preconditioner: Started solving..."  << "\n";
+    clock.restart();
+    ChebCGSolver.solve(rhs,x0);
+    gsIterativeSolverInfo(ChebCGSolver, "CG-Chebyshev", clock.stop());
+
+    //Initialize the pipelined CG solver (one fused reduction per iteration)
+    gsPipelinedConjugateGradient PCGSolver(mat,preConMat);
+    PCGSolver.setOptions(opt);
+    x0.setZero(N,1);
+    gsInfo << "\nPipelined CG: Started solving..."  << "\n";
+    clock.restart();
+    PCGSolver.solve(rhs,x0);
+    gsIterativeSolverInfo(PCGSolver, "Pipelined CG", clock.stop());
+
+    //Initialize the s-step CG solver (one reduction per s steps)
+    gsSStepConjugateGradient SCGSolver(mat,preConMat);
+    SCGSolver.setOptions(opt);
+    SCGSolver.setSSteps(3);
+    x0.setZero(N,1);
+    gsInfo << "\ns-step CG: Started solving..."  << "\n";
+    clock.restart();
+    SCGSolver.solve(rhs,x0);
+    gsIterativeSolverInfo(SCGSolver, "s-step CG", clock.stop());
+
+
+    //Solve for several right-hand sides at once with the block solvers
+    gsMatrix<> rhsBlock(N,3), xBlock;
+    rhsBlock.col(0) = rhs;
+    rhsBlock.col(1).setOnes();
+    rhsBlock.col(2).setLinSpaced(N,0,1);
+
+    gsBlockConjugateGradient BCGSolver(mat,preConMat);
+    BCGSolver.setOptions(opt);
+    gsInfo << "\nBlock CG (3 right-hand sides): Started solving..."  << "\n";
+    clock.restart();
+    BCGSolver.solve(rhsBlock,xBlock);
+    gsIterativeSolverInfo(BCGSolver, "Block CG", clock.stop());
+
+    // The block Krylov space grows by 3 vectors per iteration
+    if (N < 1000)
+    {
+        gsBlockGMRes BGMResSolver(mat,preConMat);
+        BGMResSolver.setOptions(opt);
+        xBlock.clear();
+        gsInfo << "\nBlock GMRes (3 right-hand sides): Started solving..."  << "\n";
+        clock.restart();
+        BGMResSolver.solve(rhsBlock,xBlock);
+        gsIterativeSolverInfo(BGMResSolver, "Block GMRes", clock.stop());
+    }
+    else
+        gsInfo << "\nSkipping block GMRes due to high number of iterations...\n";
 
     ///----------------------EIGEN-ITERATIVE-SOLVERS----------------------///
     gsInfo << "Testing Eigen's interative solvers:\n";
@@ -0,0 +1,124 @@
+/** @file mpiAdaptiveRefinement.cpp
+
+    @brief Adaptive refinement of a Poisson problem distributed over
+    the processes
+
+    Every process estimates the error on the elements it owns, the
+    elements are marked by a parallel selection and the refined
+    problem is distributed again. The marking and the refined bases
+    are compared with the serial ones.
+
+    Execute (eg. with 4 processes):
+
+    mpirun -np 4 ./bin/mpiAdaptiveRefinement
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+#include <gsAssembler/gsAdaptiveRefUtils.h>
+
+using namespace gismo;
+
+int main(int argc, char **argv)
+{
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+
+    int numRefine = 3;
+    int numLoops  = 2;
+    gsCmdLine cmd("Distributed adaptive refinement of a Poisson problem.");
+    cmd.addInt("r", "refine", "Number of uniform refinements of the initial bases", numRefine);
+    cmd.addInt("l", "loops" , "Number of adaptive refinement loops", numLoops);
+    const bool ok = cmd.getValues(argc,argv);
+    if (!ok) { gsWarn << "Error during parsing the command line!\n"; return 1;}
+
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)", 2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10", 2);
+    gsFunctionExpr<> h("-pi*2*sin(pi*x*1)", 2);
+    gsMultiPatch<>::uPtr square = safe( gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5) );
+    gsBoundaryConditions<> bcs;
+    bcs.addCondition(0, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(3, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(0, boundary::south, condition_type::neumann  , &h);
+    bcs.addCondition(2, boundary::south, condition_type::neumann  , &h);
+
+    gsMultiBasis<> coarse(*square);
+    coarse.uniformRefine(numRefine);
+    std::vector<gsBasis<> *> thbContainer;
+    for ( size_t k = 0; k != coarse.nBases(); ++k )
+        thbContainer.push_back( new gsTHBSplineBasis<2>( coarse.basis(k) ) );
+    gsMultiBasis<> thbBases(thbContainer, *square);
+    gsMultiBasis<> serialBases(thbBases);
+
+    gsPoissonAssembler<> pa(*square, thbBases, bcs, f);
+    pa.options().setInt("DirichletValues", dirichlet::l2Projection);
+    gsDistributedAssembler<> da(pa, comm);
+    bool adaptOk = true;
+    for ( int loop = 0; loop != numLoops; ++loop )
+    {
+        //! [Solve]
+        da.assemble();
+        gsConjugateGradient cg( gsDistributedOp<>::make(da.matrix(), comm) );
+        cg.setCommunicator(comm);
+        cg.setTolerance(1e-10);
+        gsDistributedVector<> sol(da.mapper());
+        cg.solve(da.rhs().local(), sol.local());
+        gsMultiPatch<> solPatches;
+        da.constructSolution(sol, solPatches);
+        gsField<> solField(*square, solPatches);
+        //! [Solve]
+
+        //! [Estimate]
+        // The errors of the own elements, and of all elements for
+        // the comparison with the serial marking
+        const std::vector<std::vector<bool> > & ownedEls = da.ownedElements();
+        gsNormL2<real_t> norm(solField, g);
+        norm.compute(true);
+        const std::vector<real_t> allErr = norm.elementNorms();
+        norm.setElementMask(ownedEls);
+        norm.compute(true);
+        const std::vector<real_t> myErr = norm.elementNorms();
+        //! [Estimate]
+
+        //! [Mark]
+        std::vector<bool> allMarked, myMarked;
+        for ( int crit = GARU; crit <= errorFraction; ++crit )
+        {
+            gsMarkElementsForRef(allErr, crit, 0.5, allMarked);
+            gsMarkElementsForRef(myErr , crit, 0.5, myMarked, comm);
+            for ( size_t k = 0, idx = 0, l = 0; k != ownedEls.size(); ++k )
+                for ( size_t e = 0; e != ownedEls[k].size(); ++e, ++idx )
+                    if ( ownedEls[k][e] && myMarked[l++] != allMarked[idx] )
+                        adaptOk = false;
+        }
+        //! [Mark]
+
+        //! [Refine]
+        // Refine the elements marked by errorFraction and distribute
+        // the refined problem again
+        gsRefineMarkedElements(pa.multiBasis(), ownedEls, myMarked, comm, 1);
+        pa.multiBasis().repairInterfaces( square->interfaces() );
+        da.rebalance();
+        //! [Refine]
+
+        gsRefineMarkedElements(serialBases, allMarked, 1);
+        serialBases.repairInterfaces( square->interfaces() );
+        for ( size_t k = 0; k != serialBases.nBases(); ++k )
+            adaptOk = adaptOk && serialBases[k].size() == pa.multiBasis()[k].size();
+    }
+
+    int failed = adaptOk ? 0 : 1;
+    failed = comm.max(failed);
+    if ( 0 == comm.rank() )
+        gsInfo << "Distributed adaptive refinement to "
+               << da.mapper().globalMapper().freeSize() << " dofs "
+               << (failed ? "differs from" : "agrees with") << " the serial one\n";
+    return failed;
+}
@@ -0,0 +1,148 @@
+/** @file mpiEnsemble.cpp
+
+    @brief Solves an ensemble of Poisson problems with different
+    coefficients and sources, distributed over the processes
+
+    The geometry evaluations, the sparsity pattern and the boundary
+    data are shared by all cases. Then the cases are solved once more
+    by every process, assembling the next case by the task scheduler
+    while the current one is solved.
+
+    Execute (eg. with 4 processes):
+
+    mpirun -np 4 ./bin/mpiEnsemble
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Assembles one case of the ensemble
+struct AssembleCase : public gsTaskScheduler::Task
+{
+    AssembleCase(const gsPoissonEnsemble<real_t> & e, const gsFunction<> & a,
+                 const gsFunction<> & f)
+    : ensemble(&e), coeff(&a), source(&f) { }
+
+    void run() { ensemble->assemble(*coeff, *source, matrix, rhs); }
+
+    const gsPoissonEnsemble<real_t> * ensemble;
+    const gsFunction<> * coeff, * source;
+    gsSparseMatrix<> matrix;
+    gsMatrix<> rhs;
+};
+
+// Prints the largest deviation over the processes of comm and
+// returns true if it does not exceed tol
+bool checkDeviation(const gsMpiComm & comm, const std::string & what,
+                    real_t dev, const real_t tol)
+{
+    dev = comm.max(dev);
+    if ( 0 == comm.rank() )
+        gsInfo << what << ", deviation " << dev << (dev > tol ? " (too large)\n" : "\n");
+    return dev <= tol;
+}
+
+int main(int argc, char **argv)
+{
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+    const int _size = comm.size();
+    const int _rank = comm.rank();
+
+    int numRefine = 3;
+    int casesPerProcess = 3;
+    gsCmdLine cmd("Distributed solution of an ensemble of Poisson problems.");
+    cmd.addInt("r", "refine", "Number of uniform refinements of the bases", numRefine);
+    cmd.addInt("c", "cases" , "Number of cases per process", casesPerProcess);
+    const bool ok = cmd.getValues(argc,argv);
+    if (!ok) { gsWarn << "Error during parsing the command line!\n"; return 1;}
+
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)", 2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10", 2);
+    gsFunctionExpr<> h("-pi*2*sin(pi*x*1)", 2);
+    gsMultiPatch<>::uPtr square = safe( gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5) );
+    gsMultiBasis<> bases(*square);
+    bases.uniformRefine(numRefine);
+    gsBoundaryConditions<> bcs;
+    bcs.addCondition(0, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(3, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(0, boundary::south, condition_type::neumann  , &h);
+    bcs.addCondition(2, boundary::south, condition_type::neumann  , &h);
+
+    //! [Ensemble]
+    gsPoissonEnsemble<real_t> ensemble(*square, bases, bcs);
+
+    const int nCases = casesPerProcess * _size;
+    std::vector<gsFunctionExpr<> > caseCoeffs, caseSources;
+    for ( int c = 0; c != nCases; ++c )
+    {
+        const std::string s = internal::toString<int>(c + 1);
+        caseCoeffs .push_back( gsFunctionExpr<>("1+x*y/" + s, 2) );
+        caseSources.push_back( gsFunctionExpr<>("sin(pi*x)*" + s, 2) );
+    }
+    std::vector<const gsFunction<>*> coeffs, sources;
+    for ( int c = 0; c != nCases; ++c )
+    {
+        coeffs .push_back(&caseCoeffs [c]);
+        sources.push_back(&caseSources[c]);
+    }
+    gsMatrix<> ensSol;
+    ensemble.solve(coeffs, sources, ensSol, comm); // collective
+    //! [Ensemble]
+
+    // A unit coefficient gives the Poisson system
+    gsPoissonAssembler<> pa(*square, bases, bcs, f);
+    pa.assemble();
+    gsFunctionExpr<> one("1", 2);
+    gsSparseMatrix<> ensMat;
+    gsMatrix<> ensRhs;
+    ensemble.assemble(one, f, ensMat, ensRhs);
+    real_t ensErr = math::max( (ensMat - pa.matrix()).norm(), (ensRhs - pa.rhs()).norm() );
+
+    // Every process checks the residual of one case
+    const int myCase = (_rank + 1) % nCases;
+    ensemble.assemble(*coeffs[myCase], *sources[myCase], ensMat, ensRhs);
+    ensErr = math::max(ensErr, (ensMat.selfadjointView<Eigen::Lower>() * ensSol.col(myCase)
+                                - ensRhs).norm() / ensRhs.norm());
+    bool passed = checkDeviation(comm, "Ensemble of " + internal::toString<int>(nCases)
+                                 + " cases", ensErr, 1e-8);
+
+    //! [Overlap]
+    // The task scheduler shares the cores of a node among the
+    // processes running on it; the assembly of the next case overlaps
+    // with the solution of the current one
+    gsTaskScheduler & scheduler = gsTaskScheduler::instance();
+    scheduler.reset(gsTaskScheduler::defaultOptions(), comm);
+    if ( 0 == _rank )
+        gsInfo << "Task scheduler with " << scheduler.numThreads() << " threads per process, "
+               << scheduler.localSize() << " processes on the node\n";
+    std::vector<AssembleCase> cases;
+    for ( int c = 0; c != nCases; ++c )
+        cases.push_back( AssembleCase(ensemble, *coeffs[c], *sources[c]) );
+    cases[0].run();
+    real_t taskErr = 0;
+    gsSparseSolver<>::SimplicialLDLT ldlt;
+    for ( int c = 0; c != nCases; ++c )
+    {
+        gsTaskScheduler::Group next;
+        if ( c + 1 != nCases )
+            scheduler.spawn(cases[c+1], next);
+        ldlt.compute(cases[c].matrix);
+        taskErr = math::max(taskErr, (ldlt.solve(cases[c].rhs) - ensSol.col(c)).norm()
+                                     / ensSol.col(c).norm());
+        scheduler.wait(next);
+    }
+    //! [Overlap]
+    passed = checkDeviation(comm, "Overlapped assembly and solution", taskErr, 1e-8) && passed;
+
+    return passed ? 0 : 1;
+}
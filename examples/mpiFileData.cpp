@@ -0,0 +1,71 @@
+/** @file mpiFileData.cpp
+
+    @brief Writes objects owned by different processes to one file
+    and reads them back
+
+    Execute (eg. with 4 processes):
+
+    mpirun -np 4 ./bin/mpiFileData
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char **argv)
+{
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+    const int _size = comm.size();
+    const int _rank = comm.rank();
+
+    std::string fn = "mpiFileData.gsb";
+    gsCmdLine cmd("Collective file I/O of distributed objects.");
+    cmd.addString("o", "output", "Name of the file written and read back", fn);
+    const bool ok = cmd.getValues(argc,argv);
+    if (!ok) { gsWarn << "Error during parsing the command line!\n"; return 1;}
+
+    gsMultiPatch<>::uPtr square = safe( gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5) );
+    const index_t nPatches = square->nPatches();
+
+    // A matrix of a different size on every process
+    gsMatrix<> local(3 + _rank, 2);
+    local.setConstant(_rank);
+
+    //! [Write]
+    // The patches are distributed over the processes; every object
+    // is added by the process owning it, with a unique id
+    gsMpiFileData out(comm);
+    for ( index_t i = 0; i != nPatches; ++i )
+        if ( i % _size == _rank )
+            out.add(square->patch(i), i);
+    out.add(local, nPatches + _rank);
+    out.save(fn); // collective
+    //! [Write]
+
+    //! [Read]
+    // Every process reads back the objects it wrote
+    gsMpiFileData in(comm);
+    bool ioOk = in.read(fn); // collective
+    for ( index_t i = 0; ioOk && i != nPatches; ++i )
+        if ( i % _size == _rank )
+        {
+            gsGeometry<>::uPtr patch = safe( in.getId< gsGeometry<> >(i) );
+            ioOk = patch.get() && patch->coefs() == square->patch(i).coefs();
+        }
+    gsMatrix<>::uPtr localIn = safe( in.getId< gsMatrix<> >(nPatches + _rank) );
+    ioOk = ioOk && localIn.get() && *localIn == local;
+    //! [Read]
+
+    int failed = ioOk ? 0 : 1;
+    failed = comm.max(failed);
+    if ( 0 == _rank )
+        gsInfo << "Collective file I/O " << (failed ? "failed" : "succeeded") << "\n";
+    return failed;
+}
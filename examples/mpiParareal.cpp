@@ -0,0 +1,77 @@
+/** @file mpiParareal.cpp
+
+    @brief Parallel-in-time integration of the heat equation, the
+    time slices being distributed over the processes
+
+    Execute (eg. with 4 processes):
+
+    mpirun -np 4 ./bin/mpiParareal
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char **argv)
+{
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+    const int _size = comm.size();
+
+    int    numRefine = 3;
+    real_t endTime   = 0.1;
+    gsCmdLine cmd("Parareal integration of the heat equation.");
+    cmd.addInt ("r", "refine", "Number of uniform refinements of the bases", numRefine);
+    cmd.addReal("t", "time"  , "End time of the integration", endTime);
+    const bool ok = cmd.getValues(argc,argv);
+    if (!ok) { gsWarn << "Error during parsing the command line!\n"; return 1;}
+
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)", 2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10", 2);
+    gsFunctionExpr<> h("-pi*2*sin(pi*x*1)", 2);
+    gsMultiPatch<>::uPtr square = safe( gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5) );
+    gsMultiBasis<> bases(*square);
+    bases.uniformRefine(numRefine);
+    gsBoundaryConditions<> bcs;
+    bcs.addCondition(0, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(3, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(0, boundary::south, condition_type::neumann  , &h);
+    bcs.addCondition(2, boundary::south, condition_type::neumann  , &h);
+
+    gsPoissonAssembler<> pa(*square, bases, bcs, f);
+    gsHeatEquation<real_t> heat(pa);
+    heat.assemble();
+
+    //! [Parareal]
+    // Two time slices per process, five fine steps per slice
+    gsHeatParareal<real_t> parareal(heat);
+    parareal.options().setInt("Slices", 2 * _size);
+    parareal.options().setInt("FineSteps", 5);
+    parareal.setCommunicator(comm);
+    gsMatrix<> prSol;
+    prSol.setZero(heat.numDofs(), 1);
+    parareal.integrate(prSol, 0, endTime);
+    //! [Parareal]
+
+    // The same fine steps, sequentially
+    gsHeatTimeIntegrator<real_t> sequential(heat);
+    gsMatrix<> seqSol;
+    seqSol.setZero(heat.numDofs(), 1);
+    for ( int i = 0; i != 10 * _size; ++i )
+        sequential.step(seqSol, endTime / (10 * _size));
+
+    real_t dev = (prSol - seqSol).norm() / seqSol.norm();
+    dev = comm.max(dev);
+    if ( 0 == comm.rank() )
+        gsInfo << "Parareal over " << 2 * _size << " slices: " << parareal.iterations()
+               << " iterations, relative distance to the sequential solution " << dev << "\n";
+    return dev <= 1e-6 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/** @file mpiPartitioning.cpp
+
+    @brief Partitions a graph and a multipatch basis for the
+    distribution over processes
+
+    Execute (eg. with 3 processes):
+
+    mpirun -np 3 ./bin/mpiPartitioning
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char **argv)
+{
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+
+    int numParts  = 3;
+    int numRefine = 15;
+    gsCmdLine cmd("Partitioning a multipatch basis into load-balanced blocks.");
+    cmd.addInt("p", "parts" , "Number of parts of the patch partition", numParts);
+    cmd.addInt("r", "refine", "Number of uniform refinements of the bases", numRefine);
+    const bool ok = cmd.getValues(argc,argv);
+    if (!ok) { gsWarn << "Error during parsing the command line!\n"; return 1;}
+
+    //! [Graph]
+    // Partition a small weighted graph into two parts: the heavy
+    // edge 2-3 must not be cut
+    gsGraphPartitioner graph(4);
+    graph.addEdge(0, 1); graph.addEdge(1, 2); graph.addEdge(2, 3, 10);
+    std::vector<index_t> part;
+    graph.partition(2, part);
+    if ( part[0] != 0 || part[1] != 0 || part[2] != 1 || part[3] != 1 )
+    {
+        gsWarn << "Unexpected graph partition\n";
+        return 1;
+    }
+    //! [Graph]
+
+    //! [Patches]
+    // Distribute two patches to numParts parts, splitting the patches
+    gsMultiPatch<>::uPtr patches = safe( gsNurbsCreator<>::BSplineSquareGrid(1, 2) );
+    gsMultiBasis<> bases(*patches);
+    bases.uniformRefine(numRefine);
+    gsPatchPartitioner<> partitioner(bases);
+    partitioner.compute(numParts);
+    //! [Patches]
+
+    const bool balanced = partitioner.imbalance() <= partitioner.options().getReal("Imbalance");
+    if ( 0 == comm.rank() )
+        gsInfo << "Patch partition into " << numParts << " parts: "
+               << partitioner.blocks().size() << " blocks, imbalance "
+               << partitioner.imbalance() << ", edge cut " << partitioner.edgeCut()
+               << (balanced ? "\n" : " (not balanced)\n");
+    return balanced ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+/** @file mpiPoisson.cpp
+
+    @brief Assembles and solves a Poisson problem distributed over
+    the processes, and compares with the serial assembly and solution
+
+    Execute (eg. with 4 processes):
+
+    mpirun -np 4 ./bin/mpiPoisson
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Prints the largest deviation over the processes of comm and
+// returns true if it does not exceed tol
+bool checkDeviation(const gsMpiComm & comm, const std::string & what,
+                    real_t dev, const real_t tol)
+{
+    dev = comm.max(dev);
+    if ( 0 == comm.rank() )
+        gsInfo << what << ", deviation " << dev << (dev > tol ? " (too large)\n" : "\n");
+    return dev <= tol;
+}
+
+int main(int argc, char **argv)
+{
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+
+    int numRefine = 7;
+    gsCmdLine cmd("Distributed assembly and solution of a Poisson problem.");
+    cmd.addInt("r", "refine", "Number of uniform refinements of the bases", numRefine);
+    const bool ok = cmd.getValues(argc,argv);
+    if (!ok) { gsWarn << "Error during parsing the command line!\n"; return 1;}
+
+    //! [Problem]
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)", 2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10", 2);
+    gsFunctionExpr<> h("-pi*2*sin(pi*x*1)", 2);
+    gsMultiPatch<>::uPtr square = safe( gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5) );
+    gsMultiBasis<> bases(*square);
+    bases.uniformRefine(numRefine);
+    gsBoundaryConditions<> bcs;
+    bcs.addCondition(0, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::west , condition_type::dirichlet, &g);
+    bcs.addCondition(1, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(3, boundary::north, condition_type::dirichlet, &g);
+    bcs.addCondition(0, boundary::south, condition_type::neumann  , &h);
+    bcs.addCondition(2, boundary::south, condition_type::neumann  , &h);
+    //! [Problem]
+
+    //! [Assemble]
+    // Every process assembles the rows of the dofs it owns
+    gsPoissonAssembler<> pa(*square, bases, bcs, f);
+    gsDistributedAssembler<> da(pa, comm);
+    da.assemble();
+    const gsDistributedMapper & dm = da.mapper();
+    //! [Assemble]
+
+    gsPoissonAssembler<> serial(*square, bases, bcs, f);
+    serial.assemble();
+
+    // The serial index of every distributed index
+    const gsDofMapper & sMap = serial.system().colMapper(0);
+    const gsDofMapper & dMap = dm.globalMapper();
+    std::vector<index_t> toSerial(dMap.freeSize());
+    for ( size_t k = 0; k != bases.nBases(); ++k )
+        for ( index_t i = 0; i != bases[k].size(); ++i )
+            if ( dMap.is_free(i, k) )
+                toSerial[dMap.index(i, k)] = sMap.index(i, k);
+
+    // Compare the owned rows with the serial assembly
+    gsDistributedMatrix<>::LocalMatrix rows;
+    da.matrix().globalRows(rows);
+    real_t asmErr = 0;
+    for ( index_t i = 0; i != rows.rows(); ++i )
+    {
+        const index_t r = toSerial[dm.firstOwned() + i];
+        real_t rowSum = 0;
+        for ( gsDistributedMatrix<>::LocalMatrix::InnerIterator it(rows, i); it; ++it )
+        {
+            asmErr = math::max(asmErr, math::abs(
+                         it.value() - serial.matrix().coeff(r, toSerial[it.col()])));
+            rowSum += it.value();
+        }
+        asmErr = math::max(asmErr, math::abs(rowSum - serial.matrix().row(r).sum()));
+        asmErr = math::max(asmErr, math::abs(da.rhs().local()(i, 0) - serial.rhs()(r, 0)));
+    }
+    bool passed = checkDeviation(comm, "Distributed assembly of "
+                                 + internal::toString<index_t>(dMap.freeSize()) + " dofs",
+                                 asmErr, 1e-10);
+
+    //! [Solve]
+    // CG on the distributed system, preconditioned with the diagonal
+    // of the owned rows
+    typedef gsDistributedMatrix<>::LocalMatrix LocalMatrix;
+    const LocalMatrix ownedBlock = da.matrix().local().leftCols(dm.numOwned());
+    gsConjugateGradient dcg( gsDistributedOp<>::make(da.matrix(), comm),
+                             memory::make_shared(new gsJacobiOp<LocalMatrix>(ownedBlock)) );
+    dcg.setCommunicator(comm);
+    dcg.setTolerance(1e-10);
+    gsDistributedVector<> dSol(dm);
+    dcg.solve(da.rhs().local(), dSol.local());
+    const real_t dNorm = dSol.norm(comm); // collective
+    //! [Solve]
+
+    gsSparseMatrix<> sMat = serial.matrix();
+    gsConjugateGradient scg( sMat, memory::make_shared(new gsJacobiOp<gsSparseMatrix<> >(sMat)) );
+    scg.setTolerance(1e-10);
+    gsMatrix<> sSol;
+    scg.solve(serial.rhs(), sSol);
+
+    real_t solErr = 0;
+    for ( index_t i = 0; i != dSol.local().rows(); ++i )
+        solErr = math::max(solErr, math::abs(
+                     dSol.local()(i,0) - sSol(toSerial[dm.firstOwned() + i], 0)));
+    if ( 0 == comm.rank() )
+        gsInfo << "Distributed CG: " << dcg.iterations() << " iterations (serial: "
+               << scg.iterations() << "), solution norm " << dNorm
+               << " (serial: " << sSol.norm() << ")\n";
+    passed = checkDeviation(comm, "Relative distance to the serial solution",
+                            solErr / sSol.lpNorm<Eigen::Infinity>(), 1e-6) && passed;
+
+    //! [Halo]
+    // Update the ghosts of a locally numbered vector: every owned
+    // value is its global index
+    gsMatrix<> x(dm.localSize(), 2);
+    x.setZero();
+    for ( index_t l = 0; l != dm.numOwned(); ++l )
+        x.row(l).setConstant( static_cast<real_t>(dm.globalIndex(l)) );
+    gsHaloExchange<> halo(dm, comm, 2);
+    halo.start(x);
+    halo.finish(x);
+    //! [Halo]
+
+    real_t haloErr = 0;
+    for ( index_t l = 0; l != dm.localSize(); ++l )
+        haloErr = math::max(haloErr, ( x.row(l).array() - dm.globalIndex(l) ).abs().maxCoeff());
+    passed = checkDeviation(comm, "Halo exchange", haloErr, 0) && passed;
+
+    return passed ? 0 : 1;
+}
@@ -100,18 +100,16 @@ int main(int argc, char *argv[])
     
     real_t Dt = endTime / numSteps ;
 
-    const std::string baseName("heat_eq_solution");
-	gsParaviewCollection collection(baseName);
-    
-    std::string fileName;
+    // The snapshots are written to Paraview files in the background,
+    // the time loop does not wait for the output
+    memory::unique<gsParaviewSink<real_t> >::ptr sink;
 
     if ( plot)
     {
+        sink.reset( new gsParaviewSink<real_t>("heat_eq_solution", patches) );
         //sol = assembler.constructSolution(Sol); // same as next line
         gsField<> sol = stationary.constructSolution(Sol);
-        fileName = baseName + "0";
-        gsWriteParaview<>(sol, fileName, 1000, true);
-        collection.addTimestep(fileName,0,"0.vts");
+        sink->push(sol, 0);
     }
     
     for ( int i = 1; i<=numSteps; ++i) // for all timesteps
@@ -120,8 +118,13 @@ int main(int argc, char *argv[])
         assembler.nextTimeStep(Sol, Rhs, Dt);
         gsInfo<<"Solving timestep "<< i*Dt<<".\n";
         
+        // The system matrix changes only with the step size, so the
+        // solver is set up once
+        if ( 1 == i )
+            solver.compute( assembler.matrix() );
+
         // Solve for current timestep, overwrite previous solution
-        Sol = solver.compute( assembler.matrix() ).solve(Rhs);
+        Sol = solver.solve(Rhs);
         
         // Obtain current solution as an isogeometric field
         //sol = assembler.constructSolution(Sol); // same as next line
@@ -130,17 +133,52 @@ int main(int argc, char *argv[])
         if ( plot)
         {
             // Plot the snapshot to paraview
-            fileName = baseName + internal::toString<index_t>(i);
-            gsWriteParaview<>(sol, fileName, 1000, true);
-            collection.addTimestep(fileName,i,"0.vts");
+            sink->push(sol, i*Dt);
         }
     }
 
     //gsInfo<< " time = "<<endTime<<"\n";
 
+    // Alternatively, integrate with adaptive step size control; the
+    // factorization is reused as long as the step size is unchanged
+    gsHeatTimeIntegrator<real_t> integrator(assembler);
+    integrator.options().setReal("RelTol", 1e-5);
+    gsMatrix<> adSol;
+    adSol.setZero(ndof, 1);
+    real_t t = 0;
+    const index_t nSteps = integrator.integrate(adSol, t, endTime);
+    gsInfo << "Adaptive integration: "<< nSteps <<" steps, "
+           << integrator.numRejected() <<" rejected, "
+           << integrator.numFactorizations() <<" factorizations, "
+           << "difference to the fixed step solution: "<< (adSol-Sol).norm() <<"\n";
+
+    // Parallel-in-time integration with 8 slices of numSteps/8
+    // steps; the slices are propagated concurrently by the threads
+    // (or by the processes, see gsHeatParareal::setCommunicator())
+    gsHeatParareal<real_t> parareal(assembler);
+    parareal.options().setInt("Slices", 8);
+    parareal.options().setInt("FineSteps", numSteps / 8);
+    gsMatrix<> prSol;
+    prSol.setZero(ndof, 1);
+    parareal.integrate(prSol, 0, endTime);
+
+    // The same theta-scheme steps sequentially
+    gsMatrix<> seqSol;
+    seqSol.setZero(ndof, 1);
+    for ( int i = 1; i<=numSteps; ++i)
+        integrator.step(seqSol, Dt);
+    const real_t prErr = (prSol - seqSol).norm();
+    gsInfo << "Parareal: "<< parareal.iterations() <<" iterations, "
+           << "difference to the sequential solution: "<< prErr <<"\n";
+    if ( prErr > 1e-6 * seqSol.norm() )
+    {
+        gsWarn << "The parareal solution differs from the sequential one\n";
+        return 1;
+    }
+
     if ( plot)
     {
-        collection.save();
+        sink->finish();
         return system("paraview heat_eq_solution.pvd &");
     }
 
@@ -27,10 +27,16 @@ int main(int argc, char* argv[])
     //! [Parse command line]   
     std::string input(GISMO_DATA_DIR "/curves3d/bspline3d_curve_01.xml");
     std::string output("out");
+    std::string vtkFormat("ascii");
+    bool compress = false, float64 = false, binary = false;
     
     gsCmdLine cmd("Tutorial Input Output");
     cmd.addPlainString("filename", "G+Smo input geometry file.", input);
     cmd.addString("o", "output", "Name of the output file", output);
+    cmd.addString("f", "vtk-format", "Encoding of the Paraview data (ascii, base64 or appended)", vtkFormat);
+    cmd.addSwitch("compress", "Compress binary Paraview data with zlib", compress);
+    cmd.addSwitch("float64", "Write Paraview data in double precision", float64);
+    cmd.addSwitch("binary", "Store the coefficients in the G+Smo file in binary form", binary);
     bool ok = cmd.getValues(argc,argv);
 
     if (!ok)
@@ -60,17 +66,27 @@ int main(int argc, char* argv[])
     //! [Print geometry]
     
     // writing a paraview file
+    gsOptionList vtkOpt = gsVtkDataWriter::defaultOptions();
+    vtkOpt.setString("Format" , vtkFormat);
+    vtkOpt.setSwitch("Compress", compress);
+    vtkOpt.setSwitch("Float64" , float64);
     const std::string out = output + "Paraview";
-    gsWriteParaview(*pGeom, out);
+    gsWriteParaview(*pGeom, out, 1000, false, false, vtkOpt);
     gsInfo << "Wrote a paraview file: " << out << "\n";
 
     //! [Write geometry]    
     // writing a G+Smo .xml file            
     gsFileData<> fd;
+    fd.setBinaryOutput(binary);
     fd << *pGeom;
     // output is a string. The extention .xml is added automatically
     fd.save(output); 
     gsInfo << "Wrote G+Smo file: " << output << ".xml \n";
+
+    // reading it back gives the same coefficients
+    gsGeometry<>* pBack = gsFileData<>(output + ".xml").getFirst< gsGeometry<> >();
+    GISMO_ENSURE( pBack->coefs() == pGeom->coefs(), "Coefficients changed on write." );
+    delete pBack;
     //! [Write geometry]    
     
     delete pGeom;
@@ -59,5 +59,33 @@ int main(int argc, char **argv)
     gsInfo << "Hello G+Smo, from process " << _rank <<" on "
            << cpuname <<", elapsed time is "<< mpi.wallTime()-wtime<< "\n";
 
+#ifdef GISMO_WITH_MPI
+    // Pass a matrix around the ring of processes, blocking and non-blocking
+    gsMatrix<> token(2, 2), recvd(2, 2);
+    token.setConstant(_rank);
+    const int next = (_rank + 1) % _size, prev = (_rank + _size - 1) % _size;
+    MPI_Request req[2];
+    comm.isend(token, next, &req[0]);
+    comm.irecv(recvd, prev, &req[1]);
+    MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+    bool ringOk = ( recvd.array() == prev ).all();
+    if ( 0 == _rank % 2 )
+    {
+        comm.send(token, next, 2);
+        comm.recv(recvd, prev, 2);
+    }
+    else
+    {
+        comm.recv(recvd, prev, 2);
+        comm.send(token, next, 2);
+    }
+    ringOk = ringOk && ( recvd.array() == prev ).all();
+    if ( !ringOk )
+    {
+        gsWarn << "Point-to-point communication failed on process " << _rank << "\n";
+        return 1;
+    }
+#endif
+
     return 0;
 }
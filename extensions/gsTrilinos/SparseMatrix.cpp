@@ -13,6 +13,7 @@
 
 #include <gsTrilinos/SparseMatrix.h>
 #include <gsMpi/gsMpi.h>
+#include <gsMpi/gsDistributedMatrix.h>
 #include <gsTrilinos/gsTrilinosHeaders.h>
 
 
@@ -119,6 +120,59 @@ SparseMatrix::SparseMatrix(const gsSparseMatrix<real_t,RowMajor> & sp, const int
     //*/
 }
 
+SparseMatrix::SparseMatrix(const gsDistributedMatrix<real_t> & A)
+: my(new SparseMatrixPrivate)
+{
+#ifdef HAVE_MPI
+    Epetra_MpiComm comm (gsMpi::init().worldComm());
+#else
+    Epetra_SerialComm comm;
+#endif
+    GISMO_ENSURE( comm.NumProc() == A.mapper().nRanks() &&
+                  comm.MyPID()   == A.mapper().rank(),
+                  "The distributed matrix does not match the communicator");
+
+#ifdef EPETRA_NO_32BIT_GLOBAL_INDICES
+    typedef long long global_ordinal_type;
+#else
+    typedef int global_ordinal_type;
+#endif
+
+    // The owned rows, with global column indices
+    gsDistributedMatrix<real_t>::LocalMatrix sp;
+    A.globalRows(sp);
+    const global_ordinal_type locRows = sp.rows();
+    const global_ordinal_type first   = A.firstRow();
+
+    // Every process holds the contiguous block of its owned dofs
+    Epetra_Map map(static_cast<global_ordinal_type>(A.rows()), locRows, 0, comm);
+    GISMO_ASSERT( map.MinMyGID() == first || 0 == locRows,
+                  "The row map does not match the ownership of the dofs");
+
+    gsVector<int> nnzPerRow(locRows);
+    for(global_ordinal_type i=0; i!=locRows; ++i)
+        nnzPerRow[i] = sp.innerVector(i).nonZeros();
+
+    my->matrix.reset( new Epetra_CrsMatrix(Copy, map, nnzPerRow.data(), true) );
+
+    int err_code = 0;
+    std::vector<global_ordinal_type> cols;
+    for (global_ordinal_type r = 0; r != locRows; ++r)
+    {
+        const index_t oind = *(sp.outerIndexPtr()+r);
+        cols.assign(sp.innerIndexPtr()+oind, sp.innerIndexPtr()+oind+nnzPerRow[r]);
+        err_code = my->matrix->InsertGlobalValues (first + r, nnzPerRow[r],
+                                                   sp.valuePtr()+oind,
+                                                   cols.empty() ? NULL : &cols[0]);
+        GISMO_ASSERT(0 == err_code,
+                     "InsertGlobalValues failed with err_code="<<err_code);
+    }
+
+    err_code = my->matrix->FillComplete();
+    GISMO_ASSERT(0 == err_code, "FillComplete failed with err_code="<<err_code);
+    err_code = my->matrix->OptimizeStorage();
+    GISMO_UNUSED(err_code);
+}
     
 SparseMatrix::~SparseMatrix() { delete my; }
 
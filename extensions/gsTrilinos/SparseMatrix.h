@@ -36,6 +36,12 @@ public:
     
     explicit SparseMatrix(const gsSparseMatrix<real_t,RowMajor> & sp, const int rank = 0);
 
+    /// \brief Constructs the matrix from the owned rows of \a A on
+    /// every process (see gsDistributedAssembler). The row map is
+    /// the ownership of the dofs, the rows are inserted in place and
+    /// nothing is gathered or exported.
+    explicit SparseMatrix(const gsDistributedMatrix<real_t> & A);
+
     ~SparseMatrix();
 
     //Epetra_BlockMap map() const;
@@ -14,6 +14,7 @@
 #include <gsTrilinos/Vector.h>
 
 #include <gsMpi/gsMpi.h>
+#include <gsMpi/gsDistributedMatrix.h>
 #include <gsTrilinos/gsTrilinosHeaders.h>
 
 //#include <gsCore/gsForwardDeclarations.h>
@@ -77,6 +78,16 @@ Vector::Vector(const gsVector<> & gsVec, const SparseMatrix & _map, const int ra
     GISMO_ENSURE(0==err_code, "Something went terribly wrong");
 }
 
+Vector::Vector(const gsDistributedVector<real_t> & v, const SparseMatrix & _map)
+: my(new VectorPrivate)
+{
+    GISMO_ASSERT( 1 == v.cols(), "Expecting a single column");
+    const Epetra_Map & map = _map.get()->OperatorRangeMap();
+    GISMO_ENSURE( map.NumMyElements() == v.local().rows(),
+                  "The vector does not match the row map of the matrix");
+    my->vec.reset( new Epetra_Vector(Copy, map, const_cast<real_t *>(v.local().data())) );
+}
+
 Vector::Vector(Epetra_Vector * v_ptr) : my(new VectorPrivate)
 {
     my->vec.reset(v_ptr, memory::null_deleter<Epetra_Vector> );
@@ -138,6 +149,13 @@ void Vector::copyTo(gsVector<real_t> & gsVec, const int rank) const
     }
 }
 
+void Vector::copyTo(gsDistributedVector<real_t> & v) const
+{
+    GISMO_ENSURE( my->vec->MyLength() == v.local().rows() && 1 == v.cols(),
+                  "The vector does not match the distributed vector");
+    my->vec->ExtractCopy(v.local().data());
+}
+
 Epetra_Vector * Vector::get() const
 {
     return my->vec.get();
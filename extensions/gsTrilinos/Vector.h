@@ -42,6 +42,11 @@ public:
     
     Vector(const gsVector<> & gsVec, const SparseMatrix & _map, const int rank = 0);
     
+    /// \brief Constructs the vector from the owned rows of the
+    /// single column \a v on every process, with the row map of
+    /// \a _map (see SparseMatrix(const gsDistributedMatrix<real_t>&))
+    Vector(const gsDistributedVector<real_t> & v, const SparseMatrix & _map);
+
     explicit Vector(Epetra_Vector * v_ptr);
         
     ~Vector();
@@ -56,6 +61,9 @@ public:
     
     void copyTo(gsVector<real_t> & gsVec, const int rank = 0) const;
 
+    /// Copies the local entries of every process to the owned rows of \a v
+    void copyTo(gsDistributedVector<real_t> & v) const;
+
     Epetra_Vector * get() const;
 
     void print() const;
@@ -3,6 +3,10 @@
 
 
 #include <stdio.h> // G+Smo: for sprintf
+#include <cstdlib> // G+Smo: for atoi
+#include <map>     // G+Smo: for the index of the document
+#include <string>
+#include <vector>
 
 
 // Copyright (C) 2006, 2009 Marcin Kalicinski
@@ -1079,6 +1083,7 @@ namespace rapidxml
         //! \param child Node to prepend.
         void prepend_node(xml_node<Ch> *child)
         {
+            invalidate_document_index(); // G+Smo
             assert(child && !child->parent() && child->type() != node_document);
             if (first_node())
             {
@@ -1100,6 +1105,7 @@ namespace rapidxml
         //! \param child Node to append.
         void append_node(xml_node<Ch> *child)
         {
+            invalidate_document_index(); // G+Smo
             assert(child && !child->parent() && child->type() != node_document);
             if (first_node())
             {
@@ -1135,6 +1141,7 @@ namespace rapidxml
                 where->m_prev_sibling->m_next_sibling = child;
                 where->m_prev_sibling = child;
                 child->m_parent = this;
+                invalidate_document_index(); // G+Smo
             }
         }
 
@@ -1143,6 +1150,7 @@ namespace rapidxml
         //! Use first_node() to test if node has children.
         void remove_first_node()
         {
+            invalidate_document_index(); // G+Smo
             assert(first_node());
             xml_node<Ch> *child = m_first_node;
             m_first_node = child->m_next_sibling;
@@ -1158,6 +1166,7 @@ namespace rapidxml
         //! Use first_node() to test if node has children.
         void remove_last_node()
         {
+            invalidate_document_index(); // G+Smo
             assert(first_node());
             xml_node<Ch> *child = m_last_node;
             if (child->m_prev_sibling)
@@ -1182,6 +1191,7 @@ namespace rapidxml
                 remove_last_node();
             else
             {
+                invalidate_document_index(); // G+Smo
                 where->m_prev_sibling->m_next_sibling = where->m_next_sibling;
                 where->m_next_sibling->m_prev_sibling = where->m_prev_sibling;
                 where->m_parent = 0;
@@ -1191,6 +1201,7 @@ namespace rapidxml
         //! Removes all child nodes (but not attributes).
         void remove_all_nodes()
         {
+            invalidate_document_index(); // G+Smo
             for (xml_node<Ch> *node = first_node(); node; node = node->m_next_sibling)
                 node->m_parent = 0;
             m_first_node = 0;
@@ -1200,6 +1211,7 @@ namespace rapidxml
         //! \param attribute Attribute to prepend.
         void prepend_attribute(xml_attribute<Ch> *attribute)
         {
+            invalidate_document_index(); // G+Smo
             assert(attribute && !attribute->parent());
             if (first_attribute())
             {
@@ -1220,6 +1232,7 @@ namespace rapidxml
         //! \param attribute Attribute to append.
         void append_attribute(xml_attribute<Ch> *attribute)
         {
+            invalidate_document_index(); // G+Smo
             assert(attribute && !attribute->parent());
             if (first_attribute())
             {
@@ -1255,6 +1268,7 @@ namespace rapidxml
                 where->m_prev_attribute->m_next_attribute = attribute;
                 where->m_prev_attribute = attribute;
                 attribute->m_parent = this;
+                invalidate_document_index(); // G+Smo
             }
         }
 
@@ -1263,6 +1277,7 @@ namespace rapidxml
         //! Use first_attribute() to test if node has attributes.
         void remove_first_attribute()
         {
+            invalidate_document_index(); // G+Smo
             assert(first_attribute());
             xml_attribute<Ch> *attribute = m_first_attribute;
             if (attribute->m_next_attribute)
@@ -1280,6 +1295,7 @@ namespace rapidxml
         //! Use first_attribute() to test if node has attributes.
         void remove_last_attribute()
         {
+            invalidate_document_index(); // G+Smo
             assert(first_attribute());
             xml_attribute<Ch> *attribute = m_last_attribute;
             if (attribute->m_prev_attribute)
@@ -1303,6 +1319,7 @@ namespace rapidxml
                 remove_last_attribute();
             else
             {
+                invalidate_document_index(); // G+Smo
                 where->m_prev_attribute->m_next_attribute = where->m_next_attribute;
                 where->m_next_attribute->m_prev_attribute = where->m_prev_attribute;
                 where->m_parent = 0;
@@ -1312,6 +1329,7 @@ namespace rapidxml
         //! Removes all attributes of node.
         void remove_all_attributes()
         {
+            invalidate_document_index(); // G+Smo
             for (xml_attribute<Ch> *attribute = first_attribute(); attribute; attribute = attribute->m_next_attribute)
                 attribute->m_parent = 0;
             m_first_attribute = 0;
@@ -1319,6 +1337,14 @@ namespace rapidxml
         
     private:
 
+        // G+Smo: marks the index of the document containing this node
+        // as out of date
+        void invalidate_document_index()
+        {
+            if (xml_document<Ch> *doc = document())
+                doc->invalidateIndex();
+        }
+
         ///////////////////////////////////////////////////////////////////////////
         // Restrictions
 
@@ -1364,6 +1390,7 @@ namespace rapidxml
         //G+Smo
     protected:
         int max_Id;
+        bool m_binaryMatrices;
 
     public:
         xml_node<Ch> * makeRoot() 
@@ -1380,14 +1407,136 @@ namespace rapidxml
         
         inline int numNodes() const {return max_Id+1;} 
 
+        //! If set, floating point matrices added to this document are
+        //! stored in binary form (base64 encoded) instead of as text
+        void setBinaryMatrices(const bool binary) { m_binaryMatrices = binary; }
+
+        bool binaryMatrices() const { return m_binaryMatrices; }
+
         void appendToRoot(xml_node<Ch> * node)
         { 
-            char tmp[4];
+            char tmp[16];
             sprintf(tmp,"%d", ++max_Id);
             node->append_attribute(this->allocate_attribute(
             this->allocate_string("id"), this->allocate_string(tmp) ) );
             getRoot()->append_node(node);
         }
+
+        typedef std::vector<xml_node<Ch>*> node_list;
+
+        //! Indexes the children of \a parent by id and by name, and
+        //! their descendants up to the third level below \a parent
+        //! by name. The lookups below use the index if they are
+        //! called for \a parent, until the tree is modified. Not
+        //! thread-safe; the lookups are, as long as no thread
+        //! modifies the tree.
+        void indexChildren(const xml_node<Ch> * parent)
+        {
+            m_ids.clear();
+            m_names.clear();
+            m_any.clear();
+            for (xml_node<Ch> * child = parent->first_node(); child; 
+                 child = child->next_sibling())
+            {
+                if ( child->type() != node_element )
+                    continue;
+                const xml_attribute<Ch> * id_at = child->first_attribute("id");
+                if ( id_at )
+                    m_ids[atoi(id_at->value())].push_back(child);
+                m_names[std::basic_string<Ch>(child->name(), child->name_size())].push_back(child);
+                addDescendants(m_any, child, 1);
+            }
+            m_indexed = parent;
+        }
+
+        //! Returns the first child of \a parent with attribute id
+        //! equal to \a id and name \a name (any name if 0), or 0 if
+        //! there is none
+        xml_node<Ch> * childById(const xml_node<Ch> * parent, const int id, 
+                                 const Ch * name = 0) const
+        {
+            if ( parent == m_indexed )
+            {
+                typename std::map<int, node_list>::const_iterator it = m_ids.find(id);
+                if ( it != m_ids.end() )
+                    for ( typename node_list::const_iterator n = it->second.begin();
+                          n != it->second.end(); ++n )
+                        if ( !name || internal::compare((*n)->name(), (*n)->name_size(),
+                                                        name, internal::measure(name), true) )
+                            return *n;
+                return 0;
+            }
+
+            for (xml_node<Ch> * child = parent->first_node(name); child; 
+                 child = child->next_sibling(name))
+            {
+                const xml_attribute<Ch> * id_at = child->first_attribute("id");
+                if ( id_at && atoi(id_at->value()) == id )
+                    return child;
+            }
+            return 0;
+        }
+
+        //! Returns the element children of \a parent with name \a
+        //! name, in document order
+        node_list childrenByName(const xml_node<Ch> * parent, const Ch * name) const
+        {
+            if ( parent == m_indexed )
+                return lookup(m_names, name);
+
+            node_list result;
+            for (xml_node<Ch> * child = parent->first_node(name); child; 
+                 child = child->next_sibling(name))
+                if ( child->type() == node_element )
+                    result.push_back(child);
+            return result;
+        }
+
+        //! Returns the elements with name \a name up to the third
+        //! level below \a parent, in document order (depth first)
+        node_list descendantsByName(const xml_node<Ch> * parent, const Ch * name) const
+        {
+            if ( parent == m_indexed )
+                return lookup(m_any, name);
+
+            std::map<std::basic_string<Ch>, node_list> any;
+            for (xml_node<Ch> * child = parent->first_node(); child; 
+                 child = child->next_sibling())
+                if ( child->type() == node_element )
+                    addDescendants(any, child, 1);
+            return lookup(any, name);
+        }
+
+        //! Marks the index as out of date; called by the functions
+        //! modifying the tree
+        void invalidateIndex() { m_indexed = 0; }
+
+    private:
+
+        static node_list lookup(const std::map<std::basic_string<Ch>, node_list> & index,
+                                const Ch * name)
+        {
+            typename std::map<std::basic_string<Ch>, node_list>::const_iterator
+                it = index.find(name);
+            return it != index.end() ? it->second : node_list();
+        }
+
+        static void addDescendants(std::map<std::basic_string<Ch>, node_list> & index,
+                                   xml_node<Ch> * node, const int level)
+        {
+            index[std::basic_string<Ch>(node->name(), node->name_size())].push_back(node);
+            if ( level < 3 )
+                for (xml_node<Ch> * child = node->first_node(); child; 
+                     child = child->next_sibling())
+                    if ( child->type() == node_element )
+                        addDescendants(index, child, level + 1);
+        }
+
+        // The node whose children are indexed, 0 if the index is out of date
+        const xml_node<Ch> * m_indexed;
+        std::map<int, node_list> m_ids;
+        std::map<std::basic_string<Ch>, node_list> m_names, m_any;
+
         //end G+Smo
     public:
 
@@ -1397,6 +1546,8 @@ namespace rapidxml
         {
             //G+Smo
             max_Id = -1;
+            m_binaryMatrices = false;
+            m_indexed = 0;
             //end G+Smo
         }
 
@@ -1419,6 +1570,7 @@ namespace rapidxml
             // Remove current contents
             this->remove_all_nodes();
             this->remove_all_attributes();
+            invalidateIndex(); // G+Smo
             
             // Parse BOM, if any
             parse_bom<Flags>(text);
@@ -1451,6 +1603,7 @@ namespace rapidxml
             this->remove_all_nodes();
             this->remove_all_attributes();
             memory_pool<Ch>::clear();
+            invalidateIndex(); // G+Smo
         }
         
     private:
@@ -133,14 +133,21 @@ namespace internal
 #include <gsAssembler/gsAssembler.h>
 #include <gsAssembler/gsGenericAssembler.h>
 #include <gsAssembler/gsPoissonAssembler.h>
+#include <gsAssembler/gsPoissonEnsemble.h>
 #include <gsAssembler/gsCDRAssembler.h>
 #include <gsAssembler/gsHeatEquation.h>
+#include <gsAssembler/gsHeatTimeIntegrator.h>
+#include <gsAssembler/gsHeatParareal.h>
 
 /* ----------- Solver ----------- */
 #include <gsSolver/gsLinearOperator.h>
 #include <gsSolver/gsMinimalResidual.h>
 #include <gsSolver/gsGMRes.h>
+#include <gsSolver/gsBlockGMRes.h>
 #include <gsSolver/gsConjugateGradient.h>
+#include <gsSolver/gsPipelinedConjugateGradient.h>
+#include <gsSolver/gsSStepConjugateGradient.h>
+#include <gsSolver/gsBlockConjugateGradient.h>
 #include <gsSolver/gsSimpleOps.h>
 
 /* ----------- IO ----------- */
@@ -148,9 +155,16 @@ namespace internal
 #include <gsIO/gsCmdLine.h>
 #include <gsIO/gsCmdLineArgs.h>
 #include <gsIO/gsFileData.h>
+#include <gsIO/gsMappedFile.h>
+#include <gsIO/gsGzip.h>
 #include <gsIO/gsWriteParaview.h>
 #include <gsIO/gsParaviewCollection.h>
+#include <gsIO/gsParaviewSink.h>
+#include <gsIO/gsAdaptiveSampler.h>
+#include <gsIO/gsVtkDataWriter.h>
 #include <gsIO/gsReadFile.h>
+#include <gsIO/gsReadMesh.h>
+#include <gsIO/gsSparseIO.h>
 #include <gsUtils/gsPointGrid.h>
 #include <gsIO/gsXmlUtils.h>
 
@@ -158,9 +172,18 @@ namespace internal
 #include <gsUtils/gsNorms.h>
 #include <gsUtils/gsStopwatch.h>
 #include <gsUtils/gsFunctionWithDerivatives.h>
+#include <gsUtils/gsGraphPartitioner.h>
+#include <gsUtils/gsPatchPartitioner.h>
+#include <gsUtils/gsTaskScheduler.h>
 
 /* ----------- MPI ----------- */
 #include <gsMpi/gsMpi.h>
+#include <gsMpi/gsDistributedMapper.h>
+#include <gsMpi/gsDistributedMatrix.h>
+#include <gsMpi/gsHaloExchange.h>
+#include <gsMpi/gsDistributedOp.h>
+#include <gsMpi/gsMpiFileData.h>
+#include <gsAssembler/gsDistributedAssembler.h>
 
 /* ----------- Extension ----------- */
 #ifdef GISMO_WITH_ADIFF
@@ -15,8 +15,10 @@
 
 
 #include <iostream>
+#include <limits>
 
 #include <gsIO/gsIOUtils.h>
+#include <gsMpi/gsMpi.h>
 
 namespace gismo
 {
@@ -206,6 +208,220 @@ void gsMarkElementsForRef( const std::vector<T> & elError, int refCriterion, T r
 
 }
 
+namespace internal
+{
+
+/// \brief The weighted median of the medians of the windows
+/// [lo,hi) of the sorted local vectors of the processes, which is
+/// the pivot of the parallel selection. At least one window must be
+/// non-empty.
+template <class T>
+T gsWindowPivot(const std::vector<T> & sorted, size_t lo, size_t hi,
+                const gsMpiComm & comm)
+{
+    const int np = comm.size();
+    T myMedian  = ( hi > lo ? sorted[lo + (hi - lo) / 2] : T(0) );
+    long myCount = static_cast<long>(hi - lo);
+    std::vector<T>    medians(np);
+    std::vector<long> counts (np);
+    comm.allgather(&myMedian, 1, &medians[0]);
+    comm.allgather(&myCount , 1, &counts [0]);
+
+    std::vector<std::pair<T,long> > cand;
+    long total = 0;
+    for ( int r = 0; r != np; ++r )
+        if ( counts[r] > 0 )
+        {
+            cand.push_back( std::make_pair(medians[r], counts[r]) );
+            total += counts[r];
+        }
+    std::sort(cand.begin(), cand.end());
+    long acc = 0;
+    for ( size_t i = 0; i != cand.size(); ++i )
+        if ( 2 * (acc += cand[i].second) >= total )
+            return cand[i].first;
+    return cand.back().first;
+}
+
+/// \brief Returns the \a k-th smallest (starting from zero) of the
+/// values of all processes, given the sorted local values. Every
+/// round discards at least a quarter of the remaining values, hence
+/// O(log n) reductions are needed instead of gathering the values.
+template <class T>
+T gsParallelSelect(const std::vector<T> & sorted, long k, const gsMpiComm & comm)
+{
+    typedef typename std::vector<T>::const_iterator citer;
+    size_t lo = 0, hi = sorted.size();
+    for (;;)
+    {
+        const T pivot = gsWindowPivot(sorted, lo, hi, comm);
+        const citer first = sorted.begin();
+        const size_t less = std::lower_bound(first + lo  , first + hi, pivot) - first;
+        const size_t leq  = std::upper_bound(first + less, first + hi, pivot) - first;
+        long cnt[2] = { static_cast<long>(less - lo), static_cast<long>(leq - lo) };
+        comm.sum(cnt, 2);
+        if ( k < cnt[0] )
+            hi = less;
+        else if ( k < cnt[1] )
+            return pivot;
+        else
+        {
+            k -= cnt[1];
+            lo = leq;
+        }
+    }
+}
+
+/// \brief Returns the smallest value such that the values of all
+/// processes which are not smaller add up to \a target, given the
+/// sorted local values and their prefix sums. The selection is done
+/// as in gsParallelSelect().
+template <class T>
+T gsParallelSumSelect(const std::vector<T> & sorted, const std::vector<T> & prefix,
+                      const T target, const gsMpiComm & comm)
+{
+    typedef typename std::vector<T>::const_iterator citer;
+    // The largest value is marked in any case
+    T result = ( sorted.empty() ? -std::numeric_limits<T>::max() : sorted.back() );
+    result = comm.max(result);
+
+    // The sum of the values above the window, which are all marked
+    T above = 0;
+    size_t lo = 0, hi = sorted.size();
+    for (;;)
+    {
+        long n = static_cast<long>(hi - lo);
+        if ( 0 == comm.sum(n) )
+            return result;
+        const T pivot = gsWindowPivot(sorted, lo, hi, comm);
+        const citer first = sorted.begin();
+        const size_t less = std::lower_bound(first + lo  , first + hi, pivot) - first;
+        const size_t leq  = std::upper_bound(first + less, first + hi, pivot) - first;
+        // The sums of the values in the window above and not below the pivot
+        T s[2] = { prefix[hi] - prefix[leq], prefix[hi] - prefix[less] };
+        comm.sum(s, 2);
+        if ( above + s[0] >= target )
+            lo = leq;
+        else if ( above + s[1] >= target )
+            return pivot;
+        else
+        {
+            above += s[1];
+            hi = less;
+            result = pivot;
+        }
+    }
+}
+
+} // namespace internal
+
+/// \brief Marks the elements with an error of at least \a
+/// refParameter times the largest error of all processes. \a elError
+/// holds the errors of the elements of this process only.
+template <class T>
+void gsMarkThreshold( const std::vector<T> & elError, T refParameter, std::vector<bool> & elMarked,
+                      const gsMpiComm & comm)
+{
+    T maxErr = ( elError.empty() ? T(0) : *std::max_element(elError.begin(), elError.end()) );
+    maxErr = comm.max(maxErr);
+
+    const T Thr = refParameter * maxErr;
+    elMarked.resize( elError.size() );
+    for( size_t i=0; i < elError.size(); i++)
+        elMarked[i] = ( elError[i] >= Thr );
+}
+
+/// \brief Marks the elements as gsMarkPercentage(), the errors of
+/// the elements being distributed over the processes. The threshold
+/// is found by a parallel selection, without a global sort.
+template <class T>
+void gsMarkPercentage( const std::vector<T> & elError, T refParameter, std::vector<bool> & elMarked,
+                       const gsMpiComm & comm)
+{
+    long NE = static_cast<long>(elError.size());
+    NE = comm.sum(NE);
+    elMarked.resize( elError.size() );
+    if ( 0 == NE )
+        return;
+
+    // The index from which the refinement starts in the sorted list
+    // of the errors of all processes
+    long idxRefineStart = cast<T,long>( math::floor( refParameter * T(NE) ) );
+    if( idxRefineStart >= NE )
+        idxRefineStart = NE - 1;
+
+    std::vector<T> elErrCopy = elError;
+    std::sort(elErrCopy.begin(), elErrCopy.end());
+    const T Thr = internal::gsParallelSelect(elErrCopy, idxRefineStart, comm);
+
+    for( size_t i=0; i < elError.size(); i++)
+        elMarked[i] = ( elError[i] >= Thr );
+}
+
+/// \brief Marks the elements as gsMarkFraction(), the errors of the
+/// elements being distributed over the processes. The threshold is
+/// found by a parallel selection, without a global sort.
+template <class T>
+void gsMarkFraction( const std::vector<T> & elError, T refParameter, std::vector<bool> & elMarked,
+                     const gsMpiComm & comm)
+{
+    std::vector<T> elErrCopy = elError;
+    std::sort(elErrCopy.begin(), elErrCopy.end());
+    std::vector<T> prefix(elErrCopy.size() + 1, T(0));
+    for( size_t i = 0; i < elErrCopy.size(); ++i)
+        prefix[i+1] = prefix[i] + elErrCopy[i];
+
+    T totalError = prefix.back();
+    totalError = comm.sum(totalError);
+    const T errorMarkSum = (1-refParameter) * totalError;
+    T Thr = internal::gsParallelSumSelect(elErrCopy, prefix, errorMarkSum, comm);
+
+    // As in gsMarkFraction(), the smallest error is not marked,
+    // unless it is equal to the second smallest
+    long NE = static_cast<long>(elError.size());
+    if ( comm.sum(NE) > 1 )
+        Thr = math::max(Thr, internal::gsParallelSelect(elErrCopy, 1, comm));
+
+    elMarked.resize( elError.size() );
+    for( size_t i=0; i < elError.size(); i++)
+        elMarked[i] = ( elError[i] >= Thr );
+}
+
+/** \brief Marks the elements for refinement as
+ * gsMarkElementsForRef(), the elements being distributed over the
+ * processes of \a comm. Collective.
+ *
+ * \param elError the errors of the elements of this process,
+ * e.g. computed by gsNorm restricted to the elements of
+ * gsDistributedAssembler::ownedElements()
+ * \param refCriterion the marking strategy
+ * \param refParameter the parameter of the strategy
+ * \param elMarked the marking of the elements of this process
+ * \param comm the communicator
+ *
+ * Every element must belong to exactly one process. The result is
+ * the same as marking the errors of all elements on one process.
+ */
+template <class T>
+void gsMarkElementsForRef( const std::vector<T> & elError, int refCriterion, T refParameter,
+                           std::vector<bool> & elMarked, const gsMpiComm & comm)
+{
+    switch (refCriterion)
+    {
+    case GARU:
+        gsMarkThreshold(elError,refParameter,elMarked,comm);
+        break;
+    case PUCA:
+        gsMarkPercentage(elError,refParameter,elMarked,comm);
+        break;
+    case errorFraction:
+        gsMarkFraction(elError,refParameter,elMarked,comm);
+        break;
+    default:
+        GISMO_ERROR("unknown marking strategy");
+    }
+}
+
 
 
 
@@ -283,6 +499,81 @@ void gsRefineMarkedElements(gsMultiBasis<T> & basis,
     }
 }
 
+/** \brief Refines a gsMultiBasis which is replicated on the processes
+ * of \a comm, the elements and their markings being distributed
+ * over the processes. Collective.
+ *
+ * Every process sends the centers of its marked elements to all
+ * processes (instead of the markings or the errors of all elements),
+ * and all processes refine the same boxes, hence the copies of the
+ * basis stay identical. The load can then be rebalanced with
+ * gsDistributedAssembler::rebalance().
+ *
+ * \param basis gsMultiBasis to be refined adaptively.
+ * \param elOwned the elements of this process, for every patch in the
+ * order of the domain iterator (see gsDistributedAssembler::ownedElements())
+ * \param elMarked for each element of this process (in the order of
+ * \a elOwned), whether it should be refined or not.
+ * \param comm the communicator
+ * \param refExtension Specifies how large the refinement extension
+ * should be. Given as number of cells at the level \em before refinement.
+ *
+ * \ingroup Assembler
+ */
+template <class T>
+void gsRefineMarkedElements(gsMultiBasis<T> & basis,
+                            const std::vector<std::vector<bool> > & elOwned,
+                            const std::vector<bool> & elMarked,
+                            const gsMpiComm & comm,
+                            int refExtension = 0)
+{
+    const int dim = basis.dim();
+    GISMO_ASSERT( elOwned.size() == basis.nBases(), "Expected one mask per patch");
+
+    // The patch and the center of every marked element of this process
+    std::vector<T> myCenters;
+    size_t count = 0;
+    for (unsigned pn=0; pn < basis.nBases(); ++pn )
+    {
+        const std::vector<bool> & owned = elOwned[pn];
+        typename gsBasis<T>::domainIter domIt = basis.basis(pn).makeDomainIterator();
+        for (size_t e = 0; domIt->good(); domIt->next(), ++e)
+            if ( owned[e] && elMarked[count++] )
+            {
+                myCenters.push_back( static_cast<T>(pn) );
+                const gsVector<T> c = domIt->centerPoint();
+                myCenters.insert(myCenters.end(), c.data(), c.data() + dim);
+            }
+    }
+    GISMO_ASSERT( count == elMarked.size(), "Expected one marking per owned element");
+
+    const int np = comm.size();
+    int myLen = static_cast<int>(myCenters.size());
+    std::vector<int> len(np), displ(np, 0);
+    comm.allgather(&myLen, 1, &len[0]);
+    for ( int r = 1; r != np; ++r )
+        displ[r] = displ[r-1] + len[r-1];
+    std::vector<T> centers(displ[np-1] + len[np-1] + 1);
+    myCenters.push_back(T(0)); // non-empty send buffer
+    comm.allgatherv(&myCenters[0], myLen, &centers[0], &len[0], &displ[0]);
+    centers.pop_back();
+
+    // Refine the boxes of every patch
+    const size_t numMarked = centers.size() / (dim + 1);
+    std::vector<std::vector<index_t> > marked(basis.nBases());
+    for ( size_t i = 0; i != numMarked; ++i )
+        marked[ cast<T,index_t>(centers[i * (dim + 1)]) ].push_back(i);
+    gsMatrix<T> refBoxes;
+    for (unsigned pn=0; pn < basis.nBases(); ++pn )
+    {
+        refBoxes.resize(dim, 2 * marked[pn].size());
+        for ( size_t j = 0; j != marked[pn].size(); ++j )
+            refBoxes.col(2*j) = refBoxes.col(2*j+1) =
+                gsAsConstVector<T>(&centers[marked[pn][j] * (dim + 1) + 1], dim);
+        basis.refine( pn, refBoxes, refExtension );
+    }
+}
+
 
 
 } // namespace gismo
@@ -73,6 +73,14 @@ protected: // *** Output data members ***
     /// must fit m_system.colBlocks().
     std::vector<gsMatrix<T> > m_ddof;
 
+    /// Elements of every patch taking part in the volume integrals,
+    /// see setElementMask()
+    std::vector<std::vector<bool> > m_elementMask;
+
+    /// Elements of every side of every patch taking part in the
+    /// boundary integrals, see setElementMask()
+    std::vector<std::vector<std::vector<bool> > > m_sideMask;
+
 public:
 
     gsAssembler() : m_options(defaultOptions())
@@ -198,6 +206,7 @@ public:  /* Virtual assembly routines*/
     virtual void assemble(const gsMultiPatch<T> & curSolution);
 
     gsOptionList & options() {return m_options;}
+    const gsOptionList & options() const {return m_options;}
 
 public: /* Element visitors */
 
@@ -399,6 +408,26 @@ public: // *** Accessors ***
         m_system.swap(sys);
     }
 
+    /// @brief Restricts the volume integrals to a subset of the
+    /// elements: element \a e of patch \a k (in the order of the
+    /// domain iterator) is visited if \a mask[k][e] is true. An empty
+    /// \a mask visits all elements. Interface integrals are not
+    /// affected.
+    ///
+    /// The boundary integrals on side \a s of patch \a k visit
+    /// element \a e of the side if \a sideMask[k][s-1][e] is true;
+    /// an empty \a sideMask visits all boundary elements.
+    void setElementMask(std::vector<std::vector<bool> > & mask,
+                        std::vector<std::vector<std::vector<bool> > > & sideMask)
+    {
+        GISMO_ASSERT(mask.empty() || mask.size() == m_pde_ptr->domain().nPatches(),
+                     "Expected one mask per patch");
+        GISMO_ASSERT(sideMask.empty() || sideMask.size() == m_pde_ptr->domain().nPatches(),
+                     "Expected one mask per patch");
+        m_elementMask.swap(mask);
+        m_sideMask.swap(sideMask);
+    }
+
     /// @brief Returns the number of (free) degrees of freedom
     int numDofs() const
     {
@@ -456,12 +485,27 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
     typename gsGeometry<T>::Evaluator geoEval(
         m_pde_ptr->patches()[patchIndex].evaluator(evFlags));
     
+    // Elements excluded from the volume or boundary integrals, if any
+    const std::vector<bool> * mask = NULL;
+    if ( side == boundary::none )
+    {
+        if ( !m_elementMask.empty() )
+            mask = &m_elementMask[patchIndex];
+    }
+    else if ( !m_sideMask.empty() )
+        mask = &m_sideMask[patchIndex][static_cast<int>(side) - 1];
+    if ( mask && std::find(mask->begin(), mask->end(), true) == mask->end() )
+        return;
+
     // Initialize domain element iterator -- using unknown 0
     typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
     
     // Start iteration over elements
-    for (; domIt->good(); domIt->next() )
+    for (size_t e = 0; domIt->good(); domIt->next(), ++e )
     {
+        if ( mask && !(*mask)[e] )
+            continue;
+
         // Map the Quadrature rule to the element
         QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
         
@@ -0,0 +1,311 @@
+/** @file gsDistributedAssembler.h
+
+    @brief Provides the assembly of a multipatch problem distributed
+    over several processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsAssembler/gsAssembler.h>
+#include <gsMpi/gsMpi.h>
+#include <gsMpi/gsDistributedMatrix.h>
+#include <gsUtils/gsPatchPartitioner.h>
+
+namespace gismo
+{
+
+/** \brief Assembles a multipatch problem distributed over the
+    processes of a communicator.
+
+    The elements are assigned to the processes, by default with
+    gsPatchPartitioner, and every dof is owned by one process (see
+    gsDistributedMapper). Every process assembles only the rows of
+    its owned dofs: the underlying assembler visits the elements and
+    boundary elements which contain owned dofs, with a system which
+    is numbered locally (owned dofs and ghosts). The elements at the
+    interfaces between processes are assembled by all processes which
+    own dofs on them, but every process keeps only its own rows, hence
+    no contribution is added twice and no communication is needed
+    during the assembly.
+
+    \verbatim
+    gsMpiComm comm = gsMpi::init(argc, argv).worldComm();
+    gsPoissonAssembler<> pa(patches, bases, bcs, f);
+    gsDistributedAssembler<> da(pa, comm);
+    da.assemble();
+    // da.matrix().local() are the owned rows, da.rhs().local() the owned rhs
+    \endverbatim
+
+    The underlying assembler must have a single unknown, conforming
+    interfaces and no penalization of the Dirichlet dofs. It is
+    modified: its sparse system is replaced by the local one, and it
+    must not be refreshed afterwards, except by rebalance().
+
+    \ingroup Assembler
+*/
+template <class T>
+class gsDistributedAssembler
+{
+public:
+
+    /**
+       \brief Distributes the problem of \a assembler over the
+       processes of \a comm, balancing the load with gsPatchPartitioner.
+
+       \param assembler a refreshed assembler
+       \param comm the communicator
+    */
+    gsDistributedAssembler(gsAssembler<T> & assembler, const gsMpiComm & comm)
+    : m_assembler(assembler), m_comm(comm)
+    {
+        gsPatchPartitioner<T> partition(assembler.multiBasis(0));
+        partition.compute(comm.size());
+        distribute(partition);
+    }
+
+    /// \brief Distributes the problem of \a assembler over the
+    /// processes of \a comm as given by \a partition
+    gsDistributedAssembler(gsAssembler<T> & assembler, const gsMpiComm & comm,
+                           const gsPatchPartitioner<T> & partition)
+    : m_assembler(assembler), m_comm(comm)
+    {
+        distribute(partition);
+    }
+
+    /// \brief Distributes the problem of \a assembler over the
+    /// processes of \a comm, patch \a k being assigned to process
+    /// \a patchRank[k]
+    gsDistributedAssembler(gsAssembler<T> & assembler, const gsMpiComm & comm,
+                           const std::vector<index_t> & patchRank)
+    : m_assembler(assembler), m_comm(comm)
+    {
+        checkAssembler();
+        m_mapper = gsDistributedMapper(assembler.system().colMapper(0), patchRank,
+                                       comm.rank(), comm.size());
+        const gsMultiBasis<T> & mb = assembler.multiBasis(0);
+        m_ownedElements.resize(mb.nBases());
+        for ( size_t k = 0; k != mb.nBases(); ++k )
+            m_ownedElements[k].assign(mb[k].numElements(), patchRank[k] == comm.rank());
+        initLocal();
+    }
+
+    /// Assembles the owned rows of the matrix and of the right-hand side
+    void assemble()
+    {
+        m_assembler.assemble();
+
+        // Keep the owned rows; the ghost rows are incomplete
+        const gsSparseMatrix<T> & A = m_assembler.matrix();
+        const index_t nOwned = m_mapper.numOwned();
+        m_matrix = gsDistributedMatrix<T>(m_mapper);
+        typename gsDistributedMatrix<T>::LocalMatrix & loc = m_matrix.local();
+        gsVector<index_t> nz;
+        nz.setZero(nOwned);
+        for ( index_t j = 0; j != A.outerSize(); ++j )
+            for ( typename gsSparseMatrix<T>::InnerIterator it(A, j); it; ++it )
+                if ( it.row() < nOwned )
+                    ++nz[it.row()];
+        loc.reserve(nz);
+        for ( index_t j = 0; j != A.outerSize(); ++j )
+            for ( typename gsSparseMatrix<T>::InnerIterator it(A, j); it; ++it )
+                if ( it.row() < nOwned )
+                    loc.insert(it.row(), j) = it.value();
+        loc.makeCompressed();
+
+        const gsMatrix<T> & b = m_assembler.rhs();
+        m_rhs = gsDistributedVector<T>(m_mapper, b.cols());
+        m_rhs.local() = b.topRows(nOwned);
+    }
+
+    /**
+       \brief Distributes the problem again after the multi-basis of
+       the underlying assembler has been refined (see
+       gsRefineMarkedElements()), balancing the load of the refined
+       discretization with gsPatchPartitioner. Collective.
+
+       The assembler is refreshed; the system has to be assembled
+       again.
+    */
+    void rebalance()
+    {
+        m_assembler.refresh();
+        gsPatchPartitioner<T> partition(m_assembler.multiBasis(0));
+        partition.compute(m_comm.size());
+        distribute(partition);
+    }
+
+    /// The distribution of the dofs
+    const gsDistributedMapper & mapper() const { return m_mapper; }
+
+    /// \brief The elements assigned to this process, for every patch
+    /// in the order of the domain iterator. Every element is assigned
+    /// to exactly one process, e.g. for the estimation of the error
+    /// (see gsNorm::setElementMask()).
+    const std::vector<std::vector<bool> > & ownedElements() const
+    { return m_ownedElements; }
+
+    /// The owned rows of the matrix (available after assemble())
+    const gsDistributedMatrix<T> & matrix() const { return m_matrix; }
+
+    /// The owned rows of the right-hand side (available after assemble())
+    const gsDistributedVector<T> & rhs() const { return m_rhs; }
+
+    /// The underlying assembler
+    const gsAssembler<T> & assembler() const { return m_assembler; }
+
+    /// \brief Constructs the solution with the free dofs \a solution
+    /// on every process (see gsAssembler::constructSolution())
+    void constructSolution(const gsDistributedVector<T> & solution,
+                           gsMultiPatch<T> & result) const
+    {
+        gsMatrix<T> sol;
+        solution.gather(m_comm, sol);
+
+        const gsDofMapper & mapper = m_mapper.globalMapper();
+        const gsMatrix<T> & ddof   = m_assembler.fixedDofs(0);
+        const gsMultiBasis<T> & mb = m_assembler.multiBasis(0);
+        result.clear();
+        for ( size_t p = 0; p != mb.nBases(); ++p )
+        {
+            const index_t sz = mb[p].size();
+            gsMatrix<T> coeffs(sz, sol.cols());
+            for ( index_t i = 0; i != sz; ++i )
+            {
+                if ( mapper.is_free(i, p) )
+                    coeffs.row(i) = sol.row( mapper.index(i, p) );
+                else
+                    coeffs.row(i) = ddof.row( mapper.bindex(i, p) );
+            }
+            result.addPatch( mb[p].makeGeometry( give(coeffs) ) );
+        }
+    }
+
+private:
+
+    void checkAssembler() const
+    {
+        const gsOptionList & opt = m_assembler.options();
+        GISMO_ENSURE( 1 == m_assembler.system().numColBlocks(),
+                      "Only problems with a single unknown are supported");
+        GISMO_ENSURE( opt.getInt("InterfaceStrategy") == iFace::conforming,
+                      "Only conforming interfaces are supported");
+        GISMO_ENSURE( opt.getInt("DirichletStrategy") != dirichlet::penalize,
+                      "Penalization of the Dirichlet dofs is not supported");
+    }
+
+    /// Assigns every dof to the lowest part of the elements containing it
+    void distribute(const gsPatchPartitioner<T> & partition)
+    {
+        checkAssembler();
+        GISMO_ENSURE( partition.numParts() == m_comm.size(),
+                      "The partition does not match the communicator");
+        const gsDofMapper & mapper = m_assembler.system().colMapper(0);
+        const gsMultiBasis<T> & mb = m_assembler.multiBasis(0);
+        std::vector<index_t> own(mapper.freeSize(), m_comm.size());
+        gsMatrix<unsigned> act;
+        gsMatrix<T> center;
+        m_ownedElements.resize(mb.nBases());
+        for ( size_t k = 0; k != mb.nBases(); ++k )
+        {
+            const std::vector<index_t> & part = partition.elementParts(k);
+            m_ownedElements[k].resize(part.size());
+            for ( size_t e = 0; e != part.size(); ++e )
+                m_ownedElements[k][e] = ( part[e] == m_comm.rank() );
+            typename gsBasis<T>::domainIter domIt = mb[k].makeDomainIterator();
+            for ( size_t e = 0; domIt->good(); domIt->next(), ++e )
+            {
+                center = ( domIt->lowerCorner() + domIt->upperCorner() ) / 2;
+                mb[k].active_into(center, act);
+                mapper.localToGlobal(act, k, act);
+                for ( index_t i = 0; i != act.rows(); ++i )
+                    if ( mapper.is_free_index(act(i,0)) && part[e] < own[act(i,0)] )
+                        own[act(i,0)] = part[e];
+            }
+        }
+        m_mapper = gsDistributedMapper(mapper, m_comm.rank(), m_comm.size(), own);
+        initLocal();
+    }
+
+    /// Marks the elements with owned dofs, collects the ghosts and
+    /// replaces the system of the assembler by the local one
+    void initLocal()
+    {
+        const gsDofMapper & mapper = m_mapper.globalMapper();
+        const gsMultiBasis<T> & mb = m_assembler.multiBasis(0);
+        const int nSides = 2 * mb.dim();
+        std::vector<std::vector<bool> > mask(mb.nBases());
+        std::vector<std::vector<std::vector<bool> > > sideMask(mb.nBases(),
+            std::vector<std::vector<bool> >(nSides));
+        gsMatrix<unsigned> act;
+        gsMatrix<T> center;
+        for ( size_t k = 0; k != mb.nBases(); ++k )
+        {
+            // The patches without owned dofs are skipped; their
+            // elements are counted by iteration, since not every basis
+            // implements numElements(side)
+            gsMatrix<unsigned> all = gsVector<unsigned>::LinSpaced(mb[k].size(), 0, mb[k].size() - 1);
+            mapper.localToGlobal(all, k, all);
+            bool owned = false;
+            for ( index_t i = 0; i != all.rows() && !owned; ++i )
+                owned = m_mapper.isOwned(all(i,0));
+
+            typename gsBasis<T>::domainIter domIt = mb[k].makeDomainIterator();
+            for (; domIt->good(); domIt->next() )
+                mask[k].push_back( owned && ownsDofOn(k, *domIt, act, center) );
+
+            // The boundary elements with owned dofs
+            for ( int s = 1; s <= nSides; ++s )
+            {
+                domIt = mb[k].makeDomainIterator(boxSide(s));
+                for (; domIt->good(); domIt->next() )
+                    sideMask[k][s-1].push_back( owned && ownsDofOn(k, *domIt, act, center) );
+            }
+        }
+        m_mapper.setGhosts(mb);
+
+        gsDofMapper local = m_mapper.localMapper();
+        gsSparseSystem<T> sys(local);
+        m_assembler.setSparseSystem(sys);
+        m_assembler.setElementMask(mask, sideMask);
+    }
+
+    /// Whether an owned dof is active on the element of patch \a k
+    bool ownsDofOn(const size_t k, const gsDomainIterator<T> & domIt,
+                   gsMatrix<unsigned> & act, gsMatrix<T> & center) const
+    {
+        center = ( domIt.lowerCorner() + domIt.upperCorner() ) / 2;
+        m_assembler.multiBasis(0)[k].active_into(center, act);
+        m_mapper.globalMapper().localToGlobal(act, k, act);
+        for ( index_t i = 0; i != act.rows(); ++i )
+            if ( m_mapper.isOwned(act(i,0)) )
+                return true;
+        return false;
+    }
+
+private:
+
+    gsAssembler<T> & m_assembler;
+
+    gsMpiComm m_comm;
+
+    gsDistributedMapper m_mapper;
+
+    std::vector<std::vector<bool> > m_ownedElements;
+
+    gsDistributedMatrix<T> m_matrix;
+
+    gsDistributedVector<T> m_rhs;
+
+private:
+    // The matrix and the vector reference the mapper
+    gsDistributedAssembler(const gsDistributedAssembler &);
+    gsDistributedAssembler & operator=(const gsDistributedAssembler &);
+};
+
+} // namespace gismo
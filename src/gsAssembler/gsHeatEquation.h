@@ -41,7 +41,7 @@ public:
     gsHeatEquation(gsAssembler<T> & stationary,
                    const gsOptionList & opt = Base::defaultOptions() )
     :  Base(stationary),  // note: unnecessary sliced copy here
-       m_stationary(&stationary)
+       m_stationary(&stationary), m_dt(-1)
     {
         m_options.addReal("theta",
         "Theta parameter determining the time integration scheme[0..1]", 0.5);
@@ -54,6 +54,7 @@ public:
     {
         // Grab theta once and for all
         m_theta = m_options.getReal("theta");
+        m_dt    = -1;
         
         // Assemble the stationary problem
         m_stationary->assemble();
@@ -78,6 +79,11 @@ public:
        of the current timestep
 
        \param Dt Length of time interval of the current time step
+
+       The system matrix is only rebuilt if \a Dt differs from the
+       one of the previous call, so solvers may keep their
+       factorization as long as the step size is constant. See also
+       gsHeatTimeIntegrator.
     */
     void nextTimeStep(const gsMatrix<T> & curSolution, gsMatrix<T> & curRhs, T Dt);
 
@@ -89,13 +95,19 @@ public:
 
     const gsSparseMatrix<T> & mass() const { return m_mass; }
     const gsSparseMatrix<T> & stationaryMatrix() const { return m_stationary->matrix(); }
-    const gsSparseMatrix<T> & stationaryRhs() const { return m_stationary->rhs(); }
+    const gsMatrix<T> & stationaryRhs() const { return m_stationary->rhs(); }
     
 protected:
 
     /// Mass assembly routine
     void assembleMass();
 
+    /// Computes the right-hand side of the theta scheme
+    void nextRhs(const gsSparseMatrix<T> & sysMatrix,
+                 const gsMatrix<T> & sysRhs,
+                 const gsSparseMatrix<T> & massMatrix,
+                 const gsMatrix<T> & curSolution, gsMatrix<T> & curRhs, T Dt) const;
+
 
 protected:
 
@@ -111,6 +123,9 @@ protected:
     
     /// Theta parameter determining the scheme
     T m_theta;
+
+    /// Step size of the current system matrix (negative if invalid)
+    T m_dt;
     
     using Base::m_pde_ptr;
     using Base::m_bases;
@@ -128,21 +143,18 @@ template<class T>
 void gsHeatEquation<T>::nextTimeStep(const gsMatrix<T> & curSolution, 
                                      gsMatrix<T> & curRhs, const T Dt)
 {
-    nextTimeStep(m_stationary->matrix(),
-                 m_stationary->rhs(),
-                 m_mass, curSolution, curRhs, Dt);
-    /*
-      GISMO_ASSERT( curSolution.rows() == m_mass.cols(),
-      "Wrong size in current solution vector.");
+    GISMO_ASSERT( curSolution.rows() == m_mass.cols(),
+                  "Wrong size in current solution vector.");
 
-    const T c1 = Dt * m_theta;
-    m_system.matrix() = m_mass + c1 * m_stationary->matrix();
+    // The system matrix depends only on the step size
+    if ( Dt != m_dt )
+    {
+        m_system.matrix() = m_mass + (Dt * m_theta) * m_stationary->matrix();
+        m_dt = Dt;
+    }
 
-    const T c2 = Dt * (1.0 - m_theta);
-    // note: noalias() still works since curRhs is multiplied by scalar only
-    curRhs.noalias() = c1 * m_stationary->rhs() + c2 * curRhs + 
-        m_mass * curSolution - c2 * m_stationary->matrix() * curSolution;
-    */
+    nextRhs(m_stationary->matrix(), m_stationary->rhs(),
+            m_mass, curSolution, curRhs, Dt);
 }
 
 template<class T>
@@ -156,9 +168,21 @@ void gsHeatEquation<T>::nextTimeStep(const gsSparseMatrix<T> & sysMatrix,
     GISMO_ASSERT( curSolution.rows() == m_mass.cols(),
                   "Wrong size in current solution vector.");
 
-    const T c1 = Dt * m_theta;
-    m_system.matrix() = m_mass + c1 * sysMatrix;
+    m_system.matrix() = m_mass + (Dt * m_theta) * sysMatrix;
+    m_dt = -1; // not the stationary matrix
+
+    nextRhs(sysMatrix, sysRhs, massMatrix, curSolution, curRhs, Dt);
+}
 
+template<class T>
+void gsHeatEquation<T>::nextRhs(const gsSparseMatrix<T> & sysMatrix,
+                                const gsMatrix<T> & sysRhs,
+                                const gsSparseMatrix<T> & massMatrix,
+                                const gsMatrix<T> & curSolution,
+                                gsMatrix<T> & curRhs,
+                                const T Dt) const
+{
+    const T c1 = Dt * m_theta;
     const T c2 = Dt * (1.0 - m_theta);
     // note: noalias() still works since curRhs is multiplied by scalar only
     curRhs.noalias() = c1 * sysRhs + c2 * curRhs + 
@@ -0,0 +1,270 @@
+/** @file gsHeatParareal.h
+
+    @brief Parallel-in-time (parareal) integration of the heat
+    equation.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsAssembler/gsHeatEquation.h>
+#include <gsIO/gsOptionList.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/** \brief Integrates the semi-discrete heat equation
+    \f$ M \dot u + K u = f \f$ in time with the parareal method.
+
+    The time interval is split into slices. The fine propagator
+    performs \em FineSteps theta-scheme steps per slice, the coarse
+    propagator \em CoarseSteps steps (by default a single large
+    step). Every iteration propagates all slices with the fine
+    propagator in parallel, and corrects the values at the slice
+    boundaries by a sequential sweep of the cheap coarse propagator:
+    \f[ U_{n+1}^{k+1} = G(U_n^{k+1}) + F(U_n^k) - G(U_n^k). \f]
+    The iteration stops if the correction of the slice values is
+    below the tolerance (relative to the solution); after \em Slices
+    iterations the result equals the sequential fine integration.
+
+    The slices are distributed cyclically over the processes of the
+    communicator (see setCommunicator()) and over the threads of each
+    process. Every process performs the coarse sweep, and the fine
+    values are summed over the processes once per iteration.
+
+    The theta scheme is the one of gsHeatEquation::nextTimeStep()
+    (see also gsHeatTimeIntegrator::step()); the coarse and the fine
+    step matrices are factorized once and shared by the threads.
+
+    \verbatim
+    gsHeatParareal<real_t> parareal(heat);
+    parareal.options().setInt("Slices", 4 * comm.size());
+    parareal.setCommunicator(comm);
+    parareal.integrate(u, 0, tEnd);
+    \endverbatim
+
+    \ingroup Assembler
+*/
+template <class T>
+class gsHeatParareal
+{
+public:
+
+    typedef typename gsSparseSolver<T>::LU Solver;
+
+public:
+
+    /// Constructor taking the assembled (see gsHeatEquation::assemble())
+    /// heat equation; theta is taken from the options of \a heat
+    explicit gsHeatParareal(const gsHeatEquation<T> & heat,
+                            const gsOptionList & opt = defaultOptions())
+    : m_mass(heat.mass()), m_stiff(heat.stationaryMatrix()),
+      m_load(heat.stationaryRhs()), m_options(opt),
+      m_distributed(false), m_iterations(0)
+    {
+        m_options.setReal("theta", heat.options().getReal("theta"));
+    }
+
+    /// Constructor taking mass matrix, stiffness matrix and load
+    /// vector (references are kept)
+    gsHeatParareal(const gsSparseMatrix<T> & mass,
+                   const gsSparseMatrix<T> & stiffness,
+                   const gsMatrix<T> & load,
+                   const gsOptionList & opt = defaultOptions())
+    : m_mass(mass), m_stiff(stiffness), m_load(load), m_options(opt),
+      m_distributed(false), m_iterations(0)
+    { }
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addReal("theta", "Theta parameter of the theta scheme [0..1]", 0.5);
+        opt.addInt ("Slices", "Number of time slices (0: one per process)", 0);
+        opt.addInt ("CoarseSteps", "Steps of the coarse propagator per slice", 1);
+        opt.addInt ("FineSteps", "Steps of the fine propagator per slice", 10);
+        opt.addInt ("MaxIterations", "Maximal number of parareal iterations (0: number of slices)", 0);
+        opt.addReal("Tolerance", "Relative tolerance of the correction of the slice values", 1e-8);
+        return opt;
+    }
+
+    /// Returns the options (changes take effect at the next call of integrate())
+    gsOptionList & options() { return m_options; }
+
+    /// \brief Distributes the time slices over the processes of \a
+    /// comm. integrate() is then collective and returns the same
+    /// result on every process.
+    void setCommunicator(const gsMpiComm & comm)
+    { m_comm = comm; m_distributed = true; }
+
+    /// \brief Integrates from time \a t up to \a tEnd
+    ///
+    /// \param[in,out] u  solution at time \a t; overwritten by the solution at time \a tEnd
+    /// \param t          start time
+    /// \param tEnd       end time
+    /// \returns the number of parareal iterations
+    index_t integrate(gsMatrix<T> & u, T t, T tEnd);
+
+    /// \brief The solutions at the boundaries of the slices (one
+    /// column per slice boundary, starting with the initial value) of
+    /// the last call of integrate()
+    const gsMatrix<T> & sliceValues() const { return m_U; }
+
+    /// Number of iterations of the last call of integrate()
+    index_t iterations() const { return m_iterations; }
+
+    /// Correction of the slice values in the last iteration
+    T correction() const { return m_correction; }
+
+protected:
+
+    /// Factorizes \f$ M + \theta \Delta t K \f$
+    void factorize(Solver & solver, T Dt) const;
+
+    /// Performs \a nSteps theta-scheme steps of length \a Dt,
+    /// overwriting \a u; may be called concurrently
+    void propagate(const Solver & solver, T Dt, index_t nSteps, gsMatrix<T> & u) const;
+
+protected:
+
+    const gsSparseMatrix<T> & m_mass;
+    const gsSparseMatrix<T> & m_stiff;
+    const gsMatrix<T>       & m_load;
+
+    gsOptionList m_options;
+
+    gsMpiComm m_comm;
+    bool      m_distributed; ///< True if a communicator is set
+
+    /// The factorizations of the coarse and of the fine propagator
+    Solver m_coarse, m_fine;
+
+    /// The solutions at the slice boundaries
+    gsMatrix<T> m_U;
+
+    index_t m_iterations;
+
+    T m_correction;
+};
+
+} // namespace gismo
+
+
+namespace gismo
+{
+
+template<class T>
+void gsHeatParareal<T>::factorize(Solver & solver, const T Dt) const
+{
+    gsSparseMatrix<T> sys = m_mass + (m_options.getReal("theta") * Dt) * m_stiff;
+    sys.makeCompressed();
+    solver.compute(sys);
+    GISMO_ENSURE( solver.succeed(), "Factorization of the time step matrix failed.");
+}
+
+template<class T>
+void gsHeatParareal<T>::propagate(const Solver & solver, const T Dt,
+                                  const index_t nSteps, gsMatrix<T> & u) const
+{
+    const T theta = m_options.getReal("theta");
+    gsMatrix<T> rhs;
+    for ( index_t i = 0; i != nSteps; ++i )
+    {
+        // (M + theta Dt K) u_new = (M - (1-theta) Dt K) u + Dt f
+        rhs.noalias() = m_mass * u;
+        if ( theta != 1 )
+            rhs.noalias() -= ((1 - theta) * Dt) * (m_stiff * u);
+        rhs.noalias() += Dt * m_load;
+        u = solver.solve(rhs);
+    }
+}
+
+template<class T>
+index_t gsHeatParareal<T>::integrate(gsMatrix<T> & u, const T t, const T tEnd)
+{
+    GISMO_ASSERT( u.rows() == m_mass.cols() && 1 == u.cols(),
+                  "Wrong size in current solution vector.");
+
+    // Without a communicator the process integrates all slices
+    const int rank = m_distributed ? m_comm.rank() : 0;
+    const int np   = m_distributed ? m_comm.size() : 1;
+    index_t N = m_options.getInt("Slices");
+    if ( N <= 0 )
+        N = np;
+    const index_t nCoarse = m_options.getInt("CoarseSteps");
+    const index_t nFine   = m_options.getInt("FineSteps");
+    index_t maxIt = m_options.getInt("MaxIterations");
+    if ( maxIt <= 0 )
+        maxIt = N;
+    const T tol = m_options.getReal("Tolerance");
+    GISMO_ENSURE( nCoarse > 0 && nFine > 0, "Invalid number of steps per slice");
+
+    const T dT = (tEnd - t) / N;
+    factorize(m_coarse, dT / nCoarse);
+    factorize(m_fine  , dT / nFine  );
+
+    // Initial values of the slices by the coarse propagator
+    const index_t n = u.rows();
+    m_U.resize(n, N + 1);
+    m_U.col(0) = u;
+    gsMatrix<T> G(n, N), F(n, N), v;
+    for ( index_t s = 0; s != N; ++s )
+    {
+        v = m_U.col(s);
+        propagate(m_coarse, dT / nCoarse, nCoarse, v);
+        G.col(s) = m_U.col(s+1) = v;
+    }
+
+    // The slices before "first" are exact
+    index_t first = 0;
+    m_correction = 0;
+    for ( m_iterations = 0; m_iterations != maxIt && first != N; )
+    {
+        ++m_iterations;
+
+        // Fine propagation of the slices of this process
+        std::vector<index_t> own;
+        for ( index_t s = first; s != N; ++s )
+            if ( static_cast<int>(s % np) == rank )
+                own.push_back(s);
+        F.setZero();
+        const index_t nOwn = static_cast<index_t>(own.size());
+#       pragma omp parallel for schedule(dynamic)
+        for ( index_t i = 0; i < nOwn; ++i )
+        {
+            gsMatrix<T> w = m_U.col(own[i]);
+            propagate(m_fine, dT / nFine, nFine, w);
+            F.col(own[i]) = w;
+        }
+        if ( np > 1 )
+            m_comm.sum(F.data(), static_cast<int>(F.size()));
+
+        // Sequential correction with the coarse propagator
+        m_correction = 0;
+        for ( index_t s = first; s != N; ++s )
+        {
+            v = m_U.col(s);
+            propagate(m_coarse, dT / nCoarse, nCoarse, v);
+            const gsMatrix<T> next = v + F.col(s) - G.col(s);
+            m_correction = math::max(m_correction, (next - m_U.col(s+1)).norm());
+            m_U.col(s+1) = next;
+            G.col(s) = v;
+        }
+        ++first;
+
+        const T scale = math::max(m_U.colwise().norm().maxCoeff(), (T)(1));
+        if ( m_correction <= tol * scale )
+            break;
+    }
+
+    u = m_U.col(N);
+    return m_iterations;
+}
+
+} // namespace gismo
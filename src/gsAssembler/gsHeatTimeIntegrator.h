@@ -0,0 +1,278 @@
+/** @file gsHeatTimeIntegrator.h
+
+    @brief Time integration driver for the heat equation, reusing the
+    factorization of the system matrix and with adaptive step size
+    control.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsAssembler/gsHeatEquation.h>
+#include <gsIO/gsOptionList.h>
+
+#include <limits>
+
+namespace gismo
+{
+
+/** \brief Integrates the semi-discrete heat equation
+    \f$ M \dot u + K u = f \f$ in time.
+
+    The mass matrix \f$ M \f$, the stiffness matrix \f$ K \f$ and the
+    (time-independent) load vector \f$ f \f$ are assembled once, e.g.
+    by gsHeatEquation::assemble(), and only referenced here. All
+    implemented schemes solve systems with the matrix
+    \f$ M + c\,\Delta t\, K \f$ only, whose sparse LU factorization is
+    kept as long as the step size does not change; the symbolic
+    analysis is done only once.
+
+    Two modes are available:
+    - step() performs a theta-scheme step with given step size
+      (theta is taken from the options),
+    - integrate() advances adaptively with the two-stage, L-stable
+      SDIRK2 method (Alexander) and an embedded first order error
+      estimate. The step size is only changed if the controller
+      proposes a decrease or a considerable increase, so that the
+      factorization is reused over many steps.
+
+    \ingroup Assembler
+*/
+template <class T>
+class gsHeatTimeIntegrator
+{
+public:
+
+    /// Constructor taking the assembled (see gsHeatEquation::assemble())
+    /// heat equation; theta is taken from the options of \a heat
+    explicit gsHeatTimeIntegrator(const gsHeatEquation<T> & heat,
+                                  const gsOptionList & opt = defaultOptions())
+    : m_mass(heat.mass()), m_stiff(heat.stationaryMatrix()),
+      m_load(heat.stationaryRhs()), m_options(opt)
+    {
+        m_options.setReal("theta", heat.options().getReal("theta"));
+        init();
+    }
+
+    /// Constructor taking mass matrix, stiffness matrix and load
+    /// vector (references are kept)
+    gsHeatTimeIntegrator(const gsSparseMatrix<T> & mass,
+                         const gsSparseMatrix<T> & stiffness,
+                         const gsMatrix<T> & load,
+                         const gsOptionList & opt = defaultOptions())
+    : m_mass(mass), m_stiff(stiffness), m_load(load), m_options(opt)
+    { init(); }
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addReal("theta", "Theta parameter of the fixed step scheme [0..1]", 0.5);
+        opt.addReal("AbsTol", "Absolute tolerance of the adaptive integration", 1e-6);
+        opt.addReal("RelTol", "Relative tolerance of the adaptive integration", 1e-4);
+        opt.addReal("InitialStep", "Initial step size of the adaptive integration", 1e-3);
+        opt.addReal("MinStep", "Minimal step size of the adaptive integration", 1e-12);
+        opt.addReal("MaxStep", "Maximal step size of the adaptive integration", 1e+10);
+        opt.addReal("MaxIncrease", "Step size is only increased if the controller proposes at least this factor", 1.25);
+        return opt;
+    }
+
+    /// Returns the options (changes take effect at the next call of step() or integrate())
+    gsOptionList & options() { return m_options; }
+
+    /// \brief Performs one theta-scheme step of length \a Dt,
+    /// overwriting the solution \a u
+    void step(gsMatrix<T> & u, T Dt);
+
+    /// \brief Integrates adaptively from time \a t up to \a tEnd
+    ///
+    /// \param[in,out] u  solution at time \a t; overwritten by the solution at time \a tEnd
+    /// \param[in,out] t  start time; set to \a tEnd on return
+    /// \param tEnd       end time
+    /// \returns the number of accepted steps
+    index_t integrate(gsMatrix<T> & u, T & t, T tEnd);
+
+    /// Step size proposed for the next adaptive step
+    T stepSize() const { return m_dt; }
+
+    /// Number of numerical factorizations performed so far
+    index_t numFactorizations() const { return m_numFact; }
+
+    /// Number of rejected adaptive steps so far
+    index_t numRejected() const { return m_numRejected; }
+
+protected:
+
+    void init()
+    {
+        GISMO_ASSERT( m_mass.rows() == m_stiff.rows() && m_mass.cols() == m_stiff.cols(),
+                      "Mass and stiffness matrices do not match.");
+        m_coef        = -1;
+        m_analyzed    = false;
+        m_numFact     = 0;
+        m_numRejected = 0;
+        m_dt          = m_options.getReal("InitialStep");
+    }
+
+    /// Makes the factorization of \f$ M + c K \f$ available
+    void factorize(T c);
+
+    /// Scaled RMS norm of the error estimate
+    T errorNorm(const gsMatrix<T> & err, const gsMatrix<T> & u0, const gsMatrix<T> & u1) const;
+
+protected:
+
+    const gsSparseMatrix<T> & m_mass;
+    const gsSparseMatrix<T> & m_stiff;
+    const gsMatrix<T>       & m_load;
+
+    gsOptionList m_options;
+
+    /// The system matrix M + c K and its factorization
+    gsSparseMatrix<T> m_sys;
+    typename gsSparseSolver<T>::LU m_solver;
+
+    /// The coefficient c of the factorized matrix
+    T m_coef;
+    bool m_analyzed;
+
+    /// Current step size of the adaptive integration
+    T m_dt;
+
+    index_t m_numFact, m_numRejected;
+
+    /// Work vectors
+    gsMatrix<T> m_k1, m_k2, m_tmp;
+};
+
+} // namespace gismo
+
+
+namespace gismo
+{
+
+template<class T>
+void gsHeatTimeIntegrator<T>::factorize(const T c)
+{
+    if ( c == m_coef )
+        return;
+
+    m_sys = m_mass + c * m_stiff;
+    m_sys.makeCompressed();
+
+    // The pattern of M + c K does not depend on c
+    if ( !m_analyzed )
+    {
+        m_solver.analyzePattern(m_sys);
+        m_analyzed = true;
+    }
+    m_solver.factorize(m_sys);
+    GISMO_ENSURE( m_solver.succeed(), "Factorization of the time step matrix failed.");
+
+    m_coef = c;
+    ++m_numFact;
+}
+
+template<class T>
+void gsHeatTimeIntegrator<T>::step(gsMatrix<T> & u, const T Dt)
+{
+    GISMO_ASSERT( u.rows() == m_mass.cols(), "Wrong size in current solution vector.");
+
+    const T theta = m_options.getReal("theta");
+    factorize(theta * Dt);
+
+    // (M + theta Dt K) u_new = (M - (1-theta) Dt K) u + Dt f
+    m_tmp.noalias() = m_mass * u;
+    if ( theta != 1 )
+        m_tmp.noalias() -= ((1 - theta) * Dt) * (m_stiff * u);
+    m_tmp.noalias() += Dt * m_load;
+    u = m_solver.solve(m_tmp);
+}
+
+template<class T>
+T gsHeatTimeIntegrator<T>::errorNorm(const gsMatrix<T> & err,
+                                     const gsMatrix<T> & u0,
+                                     const gsMatrix<T> & u1) const
+{
+    const T atol = m_options.getReal("AbsTol");
+    const T rtol = m_options.getReal("RelTol");
+    const gsMatrix<T> scale =
+        ( atol + rtol * u0.array().abs().max(u1.array().abs()) ).matrix();
+    return math::sqrt( (err.array() / scale.array()).square().sum() / err.size() );
+}
+
+template<class T>
+index_t gsHeatTimeIntegrator<T>::integrate(gsMatrix<T> & u, T & t, const T tEnd)
+{
+    GISMO_ASSERT( u.rows() == m_mass.cols(), "Wrong size in current solution vector.");
+
+    // Alexander's L-stable SDIRK2 with embedded Euler-type estimate
+    const T gamma  = 1 - math::sqrt((T)(2)) / 2;
+    const T minDt  = m_options.getReal("MinStep");
+    const T maxDt  = m_options.getReal("MaxStep");
+    const T incMin = m_options.getReal("MaxIncrease");
+
+    // Remainders below this are rounding errors of the accumulated time
+    const T eps = 100 * std::numeric_limits<T>::epsilon() * math::max(math::abs(tEnd), (T)(1));
+
+    index_t accepted = 0;
+    gsMatrix<T> uNew, err;
+    while ( tEnd - t > eps )
+    {
+        // Do not overshoot the end point (a shortened last step keeps
+        // the proposed step size for a later call)
+        const T Dt = math::min(m_dt, tEnd - t);
+
+        factorize(gamma * Dt);
+
+        // Stage 1: (M + gamma Dt K) k1 = f - K u
+        m_tmp = m_load - m_stiff * u;
+        m_k1  = m_solver.solve(m_tmp);
+
+        // Stage 2: (M + gamma Dt K) k2 = f - K (u + (1-gamma) Dt k1)
+        uNew  = u + ((1 - gamma) * Dt) * m_k1;
+        m_tmp = m_load - m_stiff * uNew;
+        m_k2  = m_solver.solve(m_tmp);
+
+        uNew.noalias() += (gamma * Dt) * m_k2;
+
+        // Error estimate, filtered by (M + gamma Dt K)^{-1} M to
+        // avoid overestimation of stiff components
+        m_tmp = (gamma * Dt) * (m_mass * (m_k2 - m_k1));
+        err   = m_solver.solve(m_tmp);
+
+        const T errNorm = errorNorm(err, u, uNew);
+
+        // Proposed step size (the estimate is of first order)
+        T fac = (errNorm > 0 ? (T)(0.9) / math::sqrt(errNorm) : (T)(5));
+        fac = math::max((T)(0.2), math::min((T)(5), fac));
+
+        if ( errNorm <= 1 || Dt <= minDt )
+        {
+            if ( errNorm > 1 )
+                gsWarn << "gsHeatTimeIntegrator: minimal step size reached at t="<< t <<".\n";
+            u.swap(uNew);
+            t += Dt;
+            ++accepted;
+
+            // Keep the step size (and the factorization) unless a
+            // considerable increase is possible
+            if ( Dt == m_dt && fac >= incMin )
+                m_dt = math::min(maxDt, fac * m_dt);
+        }
+        else
+        {
+            ++m_numRejected;
+            m_dt = math::max(minDt, fac * Dt);
+        }
+    }
+    t = tEnd;
+    return accepted;
+}
+
+} // namespace gismo
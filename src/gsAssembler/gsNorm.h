@@ -49,6 +49,18 @@ public:
         field1 = &_field1;
     }
 
+    /// @brief Restricts the computation to a subset of the elements:
+    /// element \a e of patch \a k (in the order of the domain
+    /// iterator) is visited if \a mask[k][e] is true. An empty \a
+    /// mask visits all elements. The element-wise norms are stored for
+    /// the visited elements only.
+    void setElementMask(const std::vector<std::vector<bool> > & mask)
+    {
+        GISMO_ASSERT(mask.empty() || mask.size() == patchesPtr->nPatches(),
+                     "Expected one mask per patch");
+        m_elementMask = mask;
+    }
+
     /** \brief Main function for norm-computation.
      *
      * The computed value can be accessed by value().
@@ -85,9 +97,15 @@ public:
             typename gsGeometry<T>::Evaluator geoEval(
                 patchesPtr->patch(pn).evaluator(evFlags));
             
+            const std::vector<bool> * mask = ( side == boundary::none && !m_elementMask.empty() ?
+                                               &m_elementMask[pn] : NULL );
+
             typename gsBasis<T>::domainIter domIt = func1.basis().makeDomainIterator(side);
-            for (; domIt->good(); domIt->next())
+            for (size_t e = 0; domIt->good(); domIt->next(), ++e)
             {
+                if ( mask && !(*mask)[e] )
+                    continue;
+
                 // Map the Quadrature rule to the element
                 QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
 
@@ -124,9 +142,15 @@ public:
         typename gsGeometry<T>::Evaluator geoEval(
             patchesPtr->patch(patchIndex).evaluator(evFlags));
         
+        const std::vector<bool> * mask = ( side == boundary::none && !m_elementMask.empty() ?
+                                           &m_elementMask[patchIndex] : NULL );
+
         typename gsBasis<T>::domainIter domIt = func1.basis().makeDomainIterator(side);
-        for (; domIt->good(); domIt->next())
+        for (size_t e = 0; domIt->good(); domIt->next(), ++e)
         {
+            if ( mask && !(*mask)[e] )
+                continue;
+
             // Map the Quadrature rule to the element
             QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
             
@@ -184,6 +208,9 @@ protected:
 
     std::vector<T> m_elWise;
     T              m_value;
+
+    /// Elements of every patch to be visited, see setElementMask()
+    std::vector<std::vector<bool> > m_elementMask;
 };
 
 } // namespace gismo
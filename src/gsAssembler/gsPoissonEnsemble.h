@@ -0,0 +1,423 @@
+/** @file gsPoissonEnsemble.h
+
+    @brief Assembles and solves many cases of a Poisson problem with
+    different coefficients and sources on the same discretization.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsAssembler/gsPoissonAssembler.h>
+#include <gsAssembler/gsGaussRule.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/** \brief Assembles and solves an ensemble of problems
+    \f$ -\nabla\cdot(a \nabla u) = f \f$ with the same geometry,
+    discretization and boundary conditions, but with a different
+    coefficient \f$ a \f$ and source \f$ f \f$ for every case.
+
+    Everything which does not depend on the case is computed once by
+    the constructor and shared by all cases: the dof mapper, the
+    sparsity pattern of the matrix, the values of the boundary
+    conditions, the Neumann terms and, for every element, the mapped
+    indices of its active functions, the physical quadrature nodes,
+    the weights times the measure, the basis values and the physical
+    gradients. The assembly of a case only evaluates \f$ a \f$ and
+    \f$ f \f$ at the stored nodes and adds the element matrices to the
+    values of the pattern at precomputed positions.
+
+    solve() distributes the cases over the processes of a
+    communicator and over the threads of each process; every thread
+    keeps its matrix, right-hand side and solver (whose symbolic
+    analysis is done once) for all its cases.
+
+    \verbatim
+    gsPoissonEnsemble<real_t> ensemble(patches, bases, bcs);
+    std::vector<const gsFunction<real_t>*> coeffs, sources;
+    // ... one coefficient and one source per case
+    gsMatrix<real_t> solutions; // one column per case
+    ensemble.solve(coeffs, sources, solutions, comm);
+    \endverbatim
+
+    The coefficients and the sources are evaluated at the physical
+    points. The Dirichlet dofs must be eliminated, and the interfaces
+    must be conforming.
+
+    \ingroup Assembler
+*/
+template <class T>
+class gsPoissonEnsemble
+{
+public:
+
+    /**
+       \brief Precomputes the data shared by all cases.
+
+       \param patches the geometry
+       \param bases the discretization
+       \param bcs the boundary conditions of all cases
+       \param opt the options of the assembly (see gsAssembler::defaultOptions())
+    */
+    gsPoissonEnsemble(const gsMultiPatch<T> & patches,
+                      const gsMultiBasis<T> & bases,
+                      const gsBoundaryConditions<T> & bcs,
+                      const gsOptionList & opt = gsAssembler<T>::defaultOptions());
+
+    /**
+       \brief Assembles the system of the case with coefficient \a
+       coeff and source \a source.
+
+       Concurrent calls must not share a function object, since
+       evaluation is not thread-safe for every function (e.g.
+       gsFunctionExpr keeps its variables in mutable members).
+
+       The storage of \a matrix is reused if it has the pattern of the
+       system, e.g. if it was assembled by a previous call; otherwise
+       \a matrix is set to the pattern first.
+    */
+    void assemble(const gsFunction<T> & coeff, const gsFunction<T> & source,
+                  gsSparseMatrix<T> & matrix, gsMatrix<T> & rhs) const;
+
+    /**
+       \brief Solves all cases, case \a i having the coefficient
+       \a coeffs[i] and the source \a sources[i].
+
+       The cases are solved concurrently if OpenMP is enabled; every
+       case is assembled with its own clones of the functions, hence
+       the cases may share function objects.
+
+       \param coeffs the coefficients of the cases
+       \param sources the sources of the cases
+       \param[out] solutions the free dofs of the solution of every
+       case (one column per case)
+    */
+    void solve(const std::vector<const gsFunction<T>*> & coeffs,
+               const std::vector<const gsFunction<T>*> & sources,
+               gsMatrix<T> & solutions) const
+    { solveCases(coeffs, sources, solutions, 0, 1); }
+
+    /**
+       \brief Solves all cases as solve(), distributing them over
+       the processes of \a comm. Collective over \a comm.
+
+       \param coeffs the coefficients of the cases
+       \param sources the sources of the cases
+       \param[out] solutions the free dofs of the solution of every
+       case (one column per case), on every process
+       \param comm the processes sharing the cases
+    */
+    void solve(const std::vector<const gsFunction<T>*> & coeffs,
+               const std::vector<const gsFunction<T>*> & sources,
+               gsMatrix<T> & solutions, const gsMpiComm & comm) const;
+
+    /// The number of free dofs
+    index_t numDofs() const { return m_pattern.rows(); }
+
+    /// The sparsity pattern of the system matrix
+    const gsSparseMatrix<T> & pattern() const { return m_pattern; }
+
+    /// The dof mapper of all cases
+    const gsDofMapper & mapper() const { return m_base.system().colMapper(0); }
+
+    /// The discretization
+    const gsMultiBasis<T> & multiBasis() const { return m_base.multiBasis(0); }
+
+    /// \brief Constructs the solution of a case with the free dofs \a
+    /// solVector (see gsAssembler::constructSolution())
+    void constructSolution(const gsMatrix<T> & solVector, gsMultiPatch<T> & result) const
+    { m_base.constructSolution(solVector, result); }
+
+private:
+
+    /// The data of an element which does not depend on the case
+    struct element
+    {
+        /// The mapped indices of the active functions
+        gsMatrix<unsigned> dofs;
+        /// The physical quadrature nodes
+        gsMatrix<T> points;
+        /// The quadrature weights times the measure
+        gsVector<T> weights;
+        /// The basis values, one column per node
+        gsMatrix<T> values;
+        /// The physical gradients (dimension x active functions) at every node
+        gsMatrix<T> grads;
+        /// The position of every entry of the element matrix in the
+        /// values of the pattern (column-wise, -1 if not stored)
+        std::vector<index_t> pos;
+    };
+
+    /// The element matrix for the coefficient values \a coeffs at the nodes
+    void localMatrix(const element & el, const gsMatrix<T> & coeffs,
+                     gsMatrix<T> & localMat) const;
+
+    /// The position of the entry (\a r, \a c) in the values of the pattern
+    index_t position(index_t r, index_t c) const;
+
+    /// Solves the cases \a c with \a c mod \a np == \a rank; the
+    /// other columns of \a solutions are zero
+    void solveCases(const std::vector<const gsFunction<T>*> & coeffs,
+                    const std::vector<const gsFunction<T>*> & sources,
+                    gsMatrix<T> & solutions, int rank, int np) const;
+
+private:
+
+    /// Source of the base problem
+    gsConstantFunction<T> m_zero;
+
+    /// The assembler of the base problem (unit coefficient, no
+    /// source), providing the mapper and the boundary data
+    gsPoissonAssembler<T> m_base;
+
+    std::vector<element> m_elements;
+
+    gsSparseMatrix<T> m_pattern;
+
+    /// Only the lower triangular part is stored
+    bool m_symmetric;
+
+    /// The values of the Dirichlet dofs
+    gsMatrix<T> m_ddof;
+
+    /// The Neumann terms of the right-hand side
+    gsMatrix<T> m_neumann;
+
+private:
+    // The base assembler references m_zero
+    gsPoissonEnsemble(const gsPoissonEnsemble &);
+    gsPoissonEnsemble & operator=(const gsPoissonEnsemble &);
+};
+
+} // namespace gismo
+
+
+namespace gismo
+{
+
+template<class T>
+gsPoissonEnsemble<T>::gsPoissonEnsemble(const gsMultiPatch<T> & patches,
+                                        const gsMultiBasis<T> & bases,
+                                        const gsBoundaryConditions<T> & bcs,
+                                        const gsOptionList & opt)
+: m_zero(T(0), patches.geoDim()), m_base(patches, bases, bcs, m_zero)
+{
+    GISMO_ENSURE( opt.getInt("DirichletStrategy") == dirichlet::elimination,
+                  "The Dirichlet dofs must be eliminated");
+    GISMO_ENSURE( opt.getInt("InterfaceStrategy") == iFace::conforming,
+                  "Only conforming interfaces are supported");
+    m_base.options() = opt;
+    m_base.refresh();
+
+    // The base problem provides the pattern and the boundary data
+    m_base.assemble();
+    m_pattern   = m_base.matrix();
+    m_pattern.makeCompressed();
+    m_symmetric = m_base.system().symmetry();
+    m_ddof      = m_base.fixedDofs(0);
+    m_neumann   = m_base.rhs();
+
+    const gsDofMapper & mapper = this->mapper();
+    const gsMultiBasis<T> & mb = multiBasis();
+    const index_t d = patches.geoDim();
+    gsQuadRule<T> QuRule;
+    gsMatrix<T> quNodes, physGrad, unit, localMat;
+    gsVector<T> quWeights;
+    std::vector<gsMatrix<T> > basisData;
+    size_t numEl = 0;
+    for ( size_t k = 0; k != mb.nBases(); ++k )
+        numEl += mb[k].numElements();
+    m_elements.reserve(numEl);
+
+    for ( size_t k = 0; k != mb.nBases(); ++k )
+    {
+        QuRule = gsGaussRule<T>(mb[k], m_base.options());
+        typename gsGeometry<T>::Evaluator geoEval(
+            patches.patch(k).evaluator(NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM));
+
+        typename gsBasis<T>::domainIter domIt = mb[k].makeDomainIterator();
+        for (; domIt->good(); domIt->next() )
+        {
+            m_elements.push_back(element());
+            element & el = m_elements.back();
+
+            QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
+            mb[k].active_into(quNodes.col(0), el.dofs);
+            mb[k].evalAllDers_into(quNodes, 1, basisData);
+            geoEval->evaluateAt(quNodes);
+
+            const index_t n = el.dofs.rows(), nq = quWeights.rows();
+            el.points = geoEval->values();
+            el.values = basisData[0];
+            el.weights.resize(nq);
+            el.grads.resize(d, n * nq);
+            for ( index_t q = 0; q != nq; ++q )
+            {
+                el.weights[q] = quWeights[q] * geoEval->measure(q);
+                geoEval->transformGradients(q, basisData[1], physGrad);
+                el.grads.middleCols(q * n, n) = physGrad;
+            }
+            mapper.localToGlobal(el.dofs, k, el.dofs);
+
+            // The entries stored by the sparse system (see gsSparseSystem::push())
+            el.pos.assign(n * n, -1);
+            for ( index_t j = 0; j != n; ++j )
+            {
+                const index_t jj = el.dofs(j, 0);
+                if ( !mapper.is_free_index(jj) )
+                    continue;
+                for ( index_t i = 0; i != n; ++i )
+                {
+                    const index_t ii = el.dofs(i, 0);
+                    if ( mapper.is_free_index(ii) && ( !m_symmetric || jj <= ii ) )
+                        el.pos[j * n + i] = position(ii, jj);
+                }
+            }
+
+            // The elimination of the Dirichlet dofs with unit
+            // coefficient is removed from the Neumann terms
+            unit.setOnes(1, nq);
+            localMatrix(el, unit, localMat);
+            for ( index_t j = 0; j != n; ++j )
+            {
+                const index_t jj = el.dofs(j, 0);
+                if ( mapper.is_free_index(jj) )
+                    continue;
+                const index_t b = mapper.global_to_bindex(jj);
+                for ( index_t i = 0; i != n; ++i )
+                    if ( mapper.is_free_index(el.dofs(i, 0)) )
+                        m_neumann.row(el.dofs(i, 0)) += localMat(i, j) * m_ddof.row(b);
+            }
+        }
+    }
+}
+
+template<class T>
+index_t gsPoissonEnsemble<T>::position(const index_t r, const index_t c) const
+{
+    const index_t outer = ( gsSparseMatrix<T>::IsRowMajor ? r : c );
+    const index_t inner = ( gsSparseMatrix<T>::IsRowMajor ? c : r );
+    const index_t * first = m_pattern.innerIndexPtr() + m_pattern.outerIndexPtr()[outer];
+    const index_t * last  = m_pattern.innerIndexPtr() + m_pattern.outerIndexPtr()[outer + 1];
+    const index_t * it = std::lower_bound(first, last, inner);
+    GISMO_ASSERT( it != last && *it == inner, "The entry is not in the pattern");
+    return static_cast<index_t>(it - m_pattern.innerIndexPtr());
+}
+
+template<class T>
+void gsPoissonEnsemble<T>::localMatrix(const element & el, const gsMatrix<T> & coeffs,
+                                       gsMatrix<T> & localMat) const
+{
+    const index_t n = el.dofs.rows();
+    localMat.setZero(n, n);
+    for ( index_t q = 0; q != el.weights.rows(); ++q )
+    {
+        const typename gsMatrix<T>::constColumns grad = el.grads.middleCols(q * n, n);
+        localMat.noalias() += (el.weights[q] * coeffs(0, q)) * (grad.transpose() * grad);
+    }
+}
+
+template<class T>
+void gsPoissonEnsemble<T>::assemble(const gsFunction<T> & coeff, const gsFunction<T> & source,
+                                    gsSparseMatrix<T> & matrix, gsMatrix<T> & rhs) const
+{
+    if ( matrix.rows() != m_pattern.rows() || matrix.cols() != m_pattern.cols() ||
+         matrix.nonZeros() != m_pattern.nonZeros() || !matrix.isCompressed() )
+        matrix = m_pattern;
+    T * values = matrix.valuePtr();
+    std::fill(values, values + matrix.nonZeros(), T(0));
+    rhs = m_neumann;
+
+    const gsDofMapper & mapper = this->mapper();
+    gsMatrix<T> aVals, fVals, localMat;
+    for ( size_t e = 0; e != m_elements.size(); ++e )
+    {
+        const element & el = m_elements[e];
+        const index_t n = el.dofs.rows();
+        coeff .eval_into(el.points, aVals);
+        source.eval_into(el.points, fVals);
+        localMatrix(el, aVals, localMat);
+
+        for ( index_t j = 0; j != n; ++j )
+            for ( index_t i = 0; i != n; ++i )
+                if ( el.pos[j * n + i] >= 0 )
+                    values[ el.pos[j * n + i] ] += localMat(i, j);
+
+        for ( index_t i = 0; i != n; ++i )
+        {
+            const index_t ii = el.dofs(i, 0);
+            if ( !mapper.is_free_index(ii) )
+                continue;
+            for ( index_t q = 0; q != el.weights.rows(); ++q )
+                rhs.row(ii) += (el.weights[q] * el.values(i, q)) * fVals.col(q).transpose();
+            for ( index_t j = 0; j != n; ++j )
+                if ( !mapper.is_free_index(el.dofs(j, 0)) )
+                    rhs.row(ii) -= localMat(i, j) *
+                        m_ddof.row( mapper.global_to_bindex(el.dofs(j, 0)) );
+        }
+    }
+}
+
+template<class T>
+void gsPoissonEnsemble<T>::solve(const std::vector<const gsFunction<T>*> & coeffs,
+                                 const std::vector<const gsFunction<T>*> & sources,
+                                 gsMatrix<T> & solutions,
+                                 const gsMpiComm & comm) const
+{
+    const int np = comm.size();
+    solveCases(coeffs, sources, solutions, comm.rank(), np);
+    if ( np > 1 )
+        comm.sum(solutions.data(), static_cast<int>(solutions.size()));
+}
+
+template<class T>
+void gsPoissonEnsemble<T>::solveCases(const std::vector<const gsFunction<T>*> & coeffs,
+                                      const std::vector<const gsFunction<T>*> & sources,
+                                      gsMatrix<T> & solutions,
+                                      const int rank, const int np) const
+{
+    GISMO_ASSERT( coeffs.size() == sources.size(), "Expected one source per coefficient");
+    const index_t nCases = static_cast<index_t>(coeffs.size());
+    solutions.setZero(numDofs(), nCases);
+
+    // The cases of this process, with their own copies of the
+    // functions, since the cases may share function objects
+    std::vector<index_t> own;
+    std::vector<gsFunction<T>*> ownCoeffs, ownSources;
+    for ( index_t c = rank; c < nCases; c += np )
+    {
+        own.push_back(c);
+        ownCoeffs .push_back( coeffs [c]->clone() );
+        ownSources.push_back( sources[c]->clone() );
+    }
+    const index_t nOwn = static_cast<index_t>(own.size());
+
+#   pragma omp parallel
+    {
+        // The storage of every worker, reused for all its cases
+        gsSparseMatrix<T> A(m_pattern);
+        gsMatrix<T> b;
+        typename gsSparseSolver<T>::SimplicialLDLT solver;
+        solver.analyzePattern(A);
+
+#       pragma omp for schedule(dynamic)
+        for ( index_t i = 0; i < nOwn; ++i )
+        {
+            assemble(*ownCoeffs[i], *ownSources[i], A, b);
+            solver.factorize(A);
+            solutions.col(own[i]) = solver.solve(b);
+        }
+    }
+
+    freeAll(ownCoeffs);
+    freeAll(ownSources);
+}
+
+} // namespace gismo
@@ -96,6 +96,13 @@ public:
     // Documentation in gsFunction class
     virtual gsConstantFunction * clone() const { return new gsConstantFunction(*this); }
 
+    // A constant function is defined on any subdomain
+    const gsConstantFunction & piece(const index_t k) const
+    {
+        GISMO_UNUSED(k);
+        return *this;
+    }
+
     // Documentation in gsFunction class
     virtual int domainDim() const   { return m_domainDim ; }
 
@@ -18,7 +18,7 @@ namespace gismo
 {
 
 gsDofMapper::gsDofMapper() : 
-m_shift(0), m_numFreeDofs(0), m_numCpldDofs(1), m_curElimId(-1)
+m_shift(0), m_bshift(0), m_numFreeDofs(0), m_numCpldDofs(1), m_curElimId(-1)
 { 
     m_offset.resize(1,0);
 }
@@ -217,6 +217,31 @@ void gsDofMapper::setIdentity(index_t nPatches, size_t nDofs)
     finalize();
 }
 
+void gsDofMapper::setMapping(std::vector<index_t> const & dofs,
+                             std::vector<std::size_t> const & offsets,
+                             index_t numFree, index_t numCoupled, index_t numElim)
+{
+    GISMO_ASSERT( offsets.empty() || offsets.back() <= dofs.size(), 
+                  "Invalid patch offsets.");
+    m_dofs        = dofs;
+    m_offset      = offsets;
+    m_numFreeDofs = numFree;
+    m_numCpldDofs = numCoupled;
+    m_numElimDofs = numElim;
+    m_curElimId   = 0;
+}
+
+void gsDofMapper::permuteFreeDofs(const gsVector<index_t> & permutation)
+{
+    GISMO_ENSURE(m_curElimId==0, "finalize() was not called on gsDofMapper");
+    GISMO_ASSERT(permutation.size() == m_numFreeDofs,
+                 "The permutation must have one entry per free dof");
+
+    for (std::vector<index_t>::iterator it = m_dofs.begin(); it != m_dofs.end(); ++it)
+        if ( *it < m_numFreeDofs )
+            *it = permutation[*it];
+}
+
 void gsDofMapper::initPatchDofs(const gsVector<index_t> & patchDofSizes)
 {
     m_curElimId   = -1;
@@ -228,6 +228,35 @@ public:
     ///\brief Set the shift amount for the boundary numbering
     void setBoundaryShift(index_t shift);
 
+    /// Returns the shift amount of the global numbering
+    index_t shift() const { return m_shift; }
+
+    /// Returns the shift amount of the boundary numbering
+    index_t boundaryShift() const { return m_bshift; }
+
+    /** \brief Sets up a finalized mapper from its raw data, e.g. to
+     * restore a mapper which was written to a file
+     *
+     * \param dofs global index (without shift) of every offsetted
+     * patch-local dof, i.e. mapIndex(n) - shift() for n < mapSize()
+     * \param offsets the patch offsets, see offset()
+     * \param numFree number of free dofs, see freeSize()
+     * \param numCoupled number of coupled dofs, see coupledSize()
+     * \param numElim number of eliminated dofs, see boundarySize()
+     */
+    void setMapping(std::vector<index_t> const & dofs,
+                    std::vector<std::size_t> const & offsets,
+                    index_t numFree, index_t numCoupled, index_t numElim);
+
+    /** \brief Renumbers the free dofs of a finalized mapper: free dof
+     * \a i becomes free dof \a permutation[i]. Eliminated dofs keep
+     * their indices.
+     *
+     * Afterwards the coupled dofs are in general not numbered last
+     * any more.
+     */
+    void permuteFreeDofs(const gsVector<index_t> & permutation);
+
     /** \brief Computes the global indices of the input local indices
      *
      * \param[in] locals a column matrix with the local indices
@@ -172,6 +172,12 @@ template< class T = real_t>  class gsPoissonAssembler;
 template< class T = real_t>  class gsCDRAssembler;
 template< class T = real_t>  class gsSolverUtils;
 template< class T = real_t, bool symm = false>  class gsSparseSystem;
+template< class T = real_t>  class gsDistributedAssembler;
+template< class T = real_t>  class gsDistributedMatrix;
+template< class T = real_t>  class gsDistributedVector;
+template< class T = real_t>  class gsHaloExchange;
+template< class T = real_t>  class gsDistributedOp;
+template< class T = real_t>  class gsPatchPartitioner;
 
 // More
 template< class T = real_t>  class gsCurveLoop;
@@ -181,6 +187,8 @@ template< class T = real_t>  class gsMesh;
 template< class T = real_t>  class gsHeMesh;
 
 template< class T = real_t>  class gsFileData;
+template< class T = real_t>  class gsSparseSystemFile;
+template< class T = real_t>  class gsAdaptiveSampler;
 
 template< class T = real_t>  class gsSolid;
 template< class T = real_t>  class gsSolidVertex;
@@ -227,6 +235,13 @@ template<class T = real_t> struct gsFieldCreator;
 
 class gsOptionList;
 
+#ifdef GISMO_WITH_MPI
+class gsMpiComm;
+#else
+class gsSerialComm;
+typedef gsSerialComm gsMpiComm;
+#endif
+
 template<class T = real_t, int _Rows=-1, int _Cols=-1, 
          int _Options  = 0|((_Rows==1 && _Cols!=1)?0x1:0)> class gsMatrix;
 template<class T = real_t, int _Rows=-1, int _Options = 0> class gsVector;
@@ -0,0 +1,136 @@
+/** @file gsAdaptiveSampler.h
+
+    @brief Provides an error-adaptive choice of the sampling points
+    used for visualization.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsIO/gsOptionList.h>
+
+namespace gismo
+{
+
+/**
+    \brief Chooses the sampling points of a multipatch geometry, and
+    possibly of a field on it, adaptively for visualization.
+
+    Every patch is sampled on a tensor-product grid with non-uniform
+    spacing. The grid starts from the knot lines of the patch (with
+    \em SamplesPerSpan intervals per knot span), and the intervals of
+    every parametric direction are bisected where the piecewise linear
+    interpolation of the sampled geometry or field deviates from the
+    function by more than \em Tolerance, relative to the size of the
+    geometry and the range of the field. Hence the points concentrate
+    in curved patches, in large patches and where the solution
+    varies, while flat regions with smooth data get few points.
+
+    The total number of points over all patches does not exceed
+    \em MaxPoints: the intervals with the largest deviation are
+    refined first.
+
+    \verbatim
+    gsAdaptiveSampler<> sampler(solution);
+    sampler.options().setInt("MaxPoints", 200000);
+    sampler.compute();
+    gsWriteParaview(sampler, "solution"); // one .vts file per patch
+    \endverbatim
+
+    The geometry and the field are referenced and must outlive the
+    sampler.
+
+    \ingroup IO
+*/
+template<class T>
+class gsAdaptiveSampler
+{
+public:
+
+    /// Sampler for the multipatch geometry \a mp
+    explicit gsAdaptiveSampler(const gsMultiPatch<T> & mp,
+                               const gsOptionList & opt = defaultOptions());
+
+    /// Sampler for the field \a field and its geometry
+    explicit gsAdaptiveSampler(const gsField<T> & field,
+                               const gsOptionList & opt = defaultOptions());
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addInt ("MaxPoints", "Maximal number of points over all patches", 100000);
+        opt.addReal("Tolerance", "Tolerated deviation of the linear interpolation, relative to the size of the geometry and the range of the field", 1e-3);
+        opt.addInt ("SamplesPerSpan", "Initial number of intervals per knot span and direction", 2);
+        opt.addInt ("MaxIterations", "Maximal number of refinement sweeps", 16);
+        return opt;
+    }
+
+    /// Returns the options (used by the next call of compute())
+    gsOptionList & options() { return m_options; }
+
+    /// Computes the sampling grids
+    void compute();
+
+    /// Number of patches
+    size_t nPatches() const { return m_geo.size(); }
+
+    /// \brief The sampling grid of patch \a p: the parameter values
+    /// of every direction (available after compute())
+    const std::vector<gsVector<T> > & grid(size_t p) const { return m_grids[p]; }
+
+    /// Number of points per direction of the grid of patch \a p
+    gsVector<unsigned> gridSize(size_t p) const;
+
+    /// Total number of points of all grids
+    size_t numPoints() const;
+
+    /// True if the sampler has a field
+    bool hasField() const { return !m_fld.empty(); }
+
+    /// \brief Evaluates the geometry and the field (if present) at
+    /// the grid points of patch \a p
+    void evaluate(size_t p, gsMatrix<T> & geo, gsMatrix<T> & field) const;
+
+    /// \brief True if evaluate() may be called concurrently for
+    /// different patches: every geometry and every field function is
+    /// a separate isogeometric function
+    bool concurrentEvaluation() const;
+
+private:
+
+    void initGrid(size_t p, index_t spans);
+
+    /// Deviations of the linear interpolation in the intervals of
+    /// direction \a k of patch \a p
+    void indicators(size_t p, index_t k, const gsMatrix<T> & geo,
+                    const gsMatrix<T> & fld, std::vector<T> & result) const;
+
+    void evalPoints(size_t p, const gsMatrix<T> & pts,
+                    gsMatrix<T> & geo, gsMatrix<T> & field) const;
+
+private:
+
+    std::vector<const gsGeometry<T> *> m_geo;
+    std::vector<const gsFunction<T> *> m_fld;
+    bool m_isParam;
+
+    gsOptionList m_options;
+
+    std::vector< std::vector<gsVector<T> > > m_grids;
+
+    /// Size of the geometry and range of the field
+    T m_geoScale, m_fldScale;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsAdaptiveSampler.hpp)
+#endif
@@ -0,0 +1,311 @@
+/** @file gsAdaptiveSampler.hpp
+
+    @brief Provides implementation of the error-adaptive choice of
+    sampling points.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsIO/gsAdaptiveSampler.h>
+#include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsField.h>
+#include <gsCore/gsDomainIterator.h>
+#include <gsUtils/gsPointGrid.h>
+
+#include <algorithm>
+#include <set>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+/// An interval of a sampling grid which is a candidate for bisection
+template<class T>
+struct sampleInterval
+{
+    T       error;
+    size_t  patch;
+    index_t dir, index;
+
+    bool operator<(const sampleInterval & other) const
+    { return error > other.error; } // largest first
+};
+
+} // namespace internal
+
+template<class T>
+gsAdaptiveSampler<T>::gsAdaptiveSampler(const gsMultiPatch<T> & mp,
+                                        const gsOptionList & opt)
+: m_isParam(true), m_options(opt), m_geoScale(1), m_fldScale(1)
+{
+    for ( size_t i = 0; i != mp.nPatches(); ++i )
+        m_geo.push_back( &mp.patch(i) );
+}
+
+template<class T>
+gsAdaptiveSampler<T>::gsAdaptiveSampler(const gsField<T> & field,
+                                        const gsOptionList & opt)
+: m_isParam(field.isParametrized()), m_options(opt), m_geoScale(1), m_fldScale(1)
+{
+    for ( int i = 0; i != field.nPatches(); ++i )
+    {
+        m_geo.push_back( &field.patch(i) );
+        m_fld.push_back( &field.function(i) );
+    }
+}
+
+template<class T>
+gsVector<unsigned> gsAdaptiveSampler<T>::gridSize(size_t p) const
+{
+    const std::vector<gsVector<T> > & g = m_grids[p];
+    gsVector<unsigned> np(g.size());
+    for ( size_t k = 0; k != g.size(); ++k )
+        np[k] = static_cast<unsigned>( g[k].size() );
+    return np;
+}
+
+template<class T>
+size_t gsAdaptiveSampler<T>::numPoints() const
+{
+    size_t result = 0;
+    for ( size_t p = 0; p != m_grids.size(); ++p )
+        result += gridSize(p).template cast<size_t>().prod();
+    return result;
+}
+
+template<class T>
+void gsAdaptiveSampler<T>::evalPoints(size_t p, const gsMatrix<T> & pts,
+                                      gsMatrix<T> & geo, gsMatrix<T> & field) const
+{
+    m_geo[p]->eval_into(pts, geo);
+    if ( hasField() )
+        m_fld[p]->eval_into(m_isParam ? pts : geo, field);
+    else
+        field.resize(0, pts.cols());
+}
+
+template<class T>
+void gsAdaptiveSampler<T>::evaluate(size_t p, gsMatrix<T> & geo, gsMatrix<T> & field) const
+{
+    gsMatrix<T> pts;
+    gsPointGrid(m_grids[p], pts);
+    evalPoints(p, pts, geo, field);
+}
+
+template<class T>
+bool gsAdaptiveSampler<T>::concurrentEvaluation() const
+{
+    if ( !m_isParam )
+        return false;
+    std::set<const void *> seen(m_geo.begin(), m_geo.end());
+    for ( size_t p = 0; p != m_fld.size(); ++p )
+        if ( !dynamic_cast<const gsGeometry<T> *>(m_fld[p]) || !seen.insert(m_fld[p]).second )
+            return false;
+    return seen.size() == m_geo.size() + m_fld.size();
+}
+
+template<class T>
+void gsAdaptiveSampler<T>::initGrid(size_t p, index_t spans)
+{
+    // Knot lines in every direction, collected from the elements
+    const gsBasis<T> & basis = m_geo[p]->basis();
+    const index_t d = basis.dim();
+    std::vector< std::vector<T> > breaks(d);
+    typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator();
+    for (; domIt->good(); domIt->next() )
+        for ( index_t k = 0; k != d; ++k )
+        {
+            breaks[k].push_back( domIt->lowerCorner()[k] );
+            breaks[k].push_back( domIt->upperCorner()[k] );
+        }
+
+    std::vector<gsVector<T> > & g = m_grids[p];
+    g.resize(d);
+    for ( index_t k = 0; k != d; ++k )
+    {
+        std::vector<T> & b = breaks[k];
+        std::sort(b.begin(), b.end());
+        b.erase( std::unique(b.begin(), b.end()), b.end() );
+
+        const index_t n = static_cast<index_t>(b.size()) - 1;
+        g[k].resize(n * spans + 1);
+        for ( index_t i = 0; i != n; ++i )
+            for ( index_t j = 0; j != spans; ++j )
+                g[k][i * spans + j] = b[i] + (b[i+1] - b[i]) * j / spans;
+        g[k][n * spans] = b[n];
+    }
+}
+
+template<class T>
+void gsAdaptiveSampler<T>::indicators(size_t p, index_t k, const gsMatrix<T> & geo,
+                                      const gsMatrix<T> & fld, std::vector<T> & result) const
+{
+    const std::vector<gsVector<T> > & g = m_grids[p];
+    const index_t n = g[k].size();
+    result.assign(n - 1, 0);
+    if ( n < 2 )
+        return;
+
+    // Evaluate at the midpoints of the intervals of direction k
+    std::vector<gsVector<T> > mid(g);
+    mid[k] = ( g[k].head(n-1) + g[k].tail(n-1) ) / 2;
+    gsMatrix<T> pts, mGeo, mFld;
+    gsPointGrid(mid, pts);
+    evalPoints(p, pts, mGeo, mFld);
+
+    // Compare with the linear interpolation of the neighbours in the
+    // grid (the points are ordered with the first direction running fastest)
+    index_t stride = 1;
+    for ( index_t l = 0; l != k; ++l )
+        stride *= g[l].size();
+    for ( index_t m = 0; m != pts.cols(); ++m )
+    {
+        const index_t lower = m % stride;
+        const index_t j     = (m / stride) % (n - 1);
+        const index_t upper = (m / stride) / (n - 1);
+        const index_t i0 = lower + stride * (j + n * upper);
+        const index_t i1 = i0 + stride;
+
+        T err = ( mGeo.col(m) - (geo.col(i0) + geo.col(i1)) / 2 ).norm() / m_geoScale;
+        if ( fld.rows() )
+            err = math::max(err, ( mFld.col(m) - (fld.col(i0) + fld.col(i1)) / 2 )
+                            .template lpNorm<Eigen::Infinity>() / m_fldScale );
+        result[j] = math::max(result[j], err);
+    }
+}
+
+template<class T>
+void gsAdaptiveSampler<T>::compute()
+{
+    const size_t maxPoints = static_cast<size_t>( m_options.getInt("MaxPoints") );
+    const T      tol       = m_options.getReal("Tolerance");
+    const index_t maxIter  = m_options.getInt("MaxIterations");
+    const size_t np        = nPatches();
+
+    // Initial grids along the knot lines; fewer points per span, or
+    // a uniform grid, if the budget is exceeded
+    m_grids.resize(np);
+    for ( index_t spans = math::max(m_options.getInt("SamplesPerSpan"), 1); ; --spans )
+    {
+        for ( size_t p = 0; p != np; ++p )
+            initGrid(p, spans);
+        if ( numPoints() <= maxPoints || 1 == spans )
+            break;
+    }
+    if ( numPoints() > maxPoints )
+    {
+        const int share = static_cast<int>( maxPoints / np );
+        for ( size_t p = 0; p != np; ++p )
+        {
+            const gsMatrix<T> ab = m_geo[p]->support();
+            const gsVector<T> a = ab.col(0), b = ab.col(1);
+            const gsVector<unsigned> cnt = uniformSampleCount(a, b, math::max(share, 1));
+            for ( index_t k = 0; k != ab.rows(); ++k )
+                m_grids[p][k].setLinSpaced(math::max<unsigned>(cnt[k], 2), a[k], b[k]);
+        }
+    }
+
+    // Scales of the deviations: size of the geometry and range of the field
+    std::vector<gsMatrix<T> > geo(np), fld(np);
+    gsMatrix<T> gRange, fRange;
+    for ( size_t p = 0; p != np; ++p )
+    {
+        evaluate(p, geo[p], fld[p]);
+        gsMatrix<T> gr(geo[p].rows(), 2), fr(fld[p].rows(), 2);
+        gr << geo[p].rowwise().minCoeff(), geo[p].rowwise().maxCoeff();
+        fr << fld[p].rowwise().minCoeff(), fld[p].rowwise().maxCoeff();
+        if ( 0 == p )
+        {
+            gRange = gr;
+            fRange = fr;
+        }
+        else
+        {
+            gRange.col(0) = gRange.col(0).cwiseMin(gr.col(0));
+            gRange.col(1) = gRange.col(1).cwiseMax(gr.col(1));
+            fRange.col(0) = fRange.col(0).cwiseMin(fr.col(0));
+            fRange.col(1) = fRange.col(1).cwiseMax(fr.col(1));
+        }
+    }
+    m_geoScale = np ? (gRange.col(1) - gRange.col(0)).norm() : T(1);
+    m_fldScale = fRange.rows() ? (fRange.col(1) - fRange.col(0)).maxCoeff() : T(0);
+    if ( m_geoScale <= 0 ) m_geoScale = 1;
+    if ( m_fldScale <= 0 ) m_fldScale = 1;
+
+    std::vector<T> err;
+    std::vector<internal::sampleInterval<T> > cand;
+    for ( index_t it = 0; it != maxIter; ++it )
+    {
+        // Intervals with too large deviation
+        cand.clear();
+        for ( size_t p = 0; p != np; ++p )
+        {
+            if ( it > 0 )
+                evaluate(p, geo[p], fld[p]);
+            for ( index_t k = 0; k != static_cast<index_t>(m_grids[p].size()); ++k )
+            {
+                indicators(p, k, geo[p], fld[p], err);
+                for ( size_t j = 0; j != err.size(); ++j )
+                    if ( err[j] > tol )
+                    {
+                        internal::sampleInterval<T> c;
+                        c.error = err[j];
+                        c.patch = p;
+                        c.dir   = k;
+                        c.index = static_cast<index_t>(j);
+                        cand.push_back(c);
+                    }
+            }
+        }
+        std::sort(cand.begin(), cand.end());
+
+        // Bisect the worst intervals as long as the budget allows;
+        // a new line of direction k costs the points of the other directions
+        std::vector<std::vector<std::vector<index_t> > > split(np);
+        std::vector<gsVector<unsigned> > cnt(np);
+        for ( size_t p = 0; p != np; ++p )
+        {
+            cnt[p] = gridSize(p);
+            split[p].resize(m_grids[p].size());
+        }
+        size_t total = numPoints();
+        bool refined = false;
+        for ( size_t c = 0; c != cand.size(); ++c )
+        {
+            const internal::sampleInterval<T> & iv = cand[c];
+            const size_t cost = cnt[iv.patch].template cast<size_t>().prod() / cnt[iv.patch][iv.dir];
+            if ( total + cost > maxPoints )
+                continue;
+            total += cost;
+            ++cnt[iv.patch][iv.dir];
+            split[iv.patch][iv.dir].push_back(iv.index);
+            refined = true;
+        }
+        if ( !refined )
+            break;
+
+        for ( size_t p = 0; p != np; ++p )
+            for ( size_t k = 0; k != split[p].size(); ++k )
+            {
+                const std::vector<index_t> & s = split[p][k];
+                if ( s.empty() )
+                    continue;
+                gsVector<T> & g = m_grids[p][k];
+                std::vector<T> v(g.data(), g.data() + g.size());
+                for ( size_t i = 0; i != s.size(); ++i )
+                    v.push_back( (g[s[i]] + g[s[i] + 1]) / 2 );
+                std::sort(v.begin(), v.end());
+                g = gsAsConstVector<T>(v);
+            }
+    }
+}
+
+} // namespace gismo
@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsIO/gsAdaptiveSampler.h>
+#include <gsIO/gsAdaptiveSampler.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsAdaptiveSampler<real_t>;
+
+}
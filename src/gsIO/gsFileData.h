@@ -17,6 +17,7 @@
 #include <string>
 
 #include <gsIO/gsXml.h>
+#include <gsIO/gsMappedFile.h>
 
 namespace gismo 
 {
@@ -66,19 +67,51 @@ public:
     void save(std::string const & fname = "dump", bool compress = false) const;
 
     /// \brief Save file contents to compressed xml file
+    ///
+    /// The file is compressed in blocks by several threads (see
+    /// gsGzip) and can be read by gunzip.
     void saveCompressed(std::string const & fname = "dump") const;
+
+    /// \brief Save file contents to a G+Smo binary container file
+    /// (extension .gsb).
+    ///
+    /// Matrices stored in binary form (see setBinaryOutput()) are
+    /// written as raw data blocks, the rest of the data as XML
+    /// text. Reading such a file maps it into memory and parses the
+    /// XML text only, the matrices are copied from the mapping when
+    /// the objects are fetched.
+    ///
+    /// If \a compress is true, the container is compressed in
+    /// parallel (see gsGzip) to a file with extension .gsb.gz, which
+    /// is decompressed into memory when read.
+    void saveBinary(std::string const & fname = "dump", bool compress = false) const;
     
     /// \brief Dump file contents to an xml file
     void dump(std::string const & fname = "dump") const;
     
     void addComment(std::string const & message);
 
+    /// \brief If \a binary is true, the floating point matrices (e.g.
+    /// coefficients) of objects added subsequently to this gsFileData
+    /// are stored base64 encoded, as \c format="binary", instead of
+    /// as text. Reading detects the format automatically.
+    void setBinaryOutput(bool binary)
+    { data->setBinaryMatrices(binary); }
+
+    /// Returns true if matrices are stored in binary form, see setBinaryOutput()
+    bool binaryOutput() const
+    { return data->binaryMatrices(); }
+
 private:
     /// File data as an xml tree
     FileData * data;
     
     // Used to hold parsed data of native gismo XML files
     std::vector<char> m_buffer;
+
+    // Contents of a binary container file, referenced by the raw
+    // data nodes of the xml tree
+    gsMappedFile * m_file;
     
 protected:
     
@@ -92,6 +125,9 @@ protected:
     /// Reads a file with xml.gz extension
     bool readXmlGzFile( String const & fn );
 
+    /// Reads a G+Smo binary container file (gsb extension)
+    bool readBinaryFile( String const & fn );
+
     /// Reads Gismo's native XML file
     bool readGismoXmlStream(std::istream & is);
 
@@ -185,12 +221,19 @@ public:
     template<class Object> 
     inline int count() const
     {
+        const std::vector<gsXmlNode*> nodes = 
+            data->childrenByName(getXmlRoot(), internal::gsXml<Object>::tag().c_str());
+        const String type = internal::gsXml<Object>::type();
+        if ( type == "" )
+            return static_cast<int>(nodes.size());
         int i(0);
-        for (gsXmlNode * child = getFirstNode( internal::gsXml<Object>::tag(), 
-                                               internal::gsXml<Object>::type() ) ; 
-             child; child = getNextSibling(child, internal::gsXml<Object>::tag(), 
-                                           internal::gsXml<Object>::type() ))
-            ++i;
+        for ( typename std::vector<gsXmlNode*>::const_iterator it = nodes.begin();
+              it != nodes.end(); ++it )
+        {
+            const gsXmlAttribute * tp = (*it)->first_attribute("type");
+            if ( tp && type == tp->value() )
+                ++i;
+        }
         return i;
     }
 
@@ -392,6 +435,10 @@ private:
     gsXmlNode * getAnyFirstNode( const std::string & name = "",
                                  const std::string & type = "" ) const;
 
+    // First node of \a nodes with type \a type (any type if empty)
+    static gsXmlNode * firstOfType(const std::vector<gsXmlNode*> & nodes,
+                                   const std::string & type);
+
     // getNext
     static gsXmlNode * getNextSibling( gsXmlNode* const & node, 
                                        const std::string & name = "", 
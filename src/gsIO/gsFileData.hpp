@@ -26,6 +26,9 @@
 
 #include <gsNurbs/gsKnotVector.h>
 
+#include <gsUtils/gsMesh/gsMesh.h>
+#include <gsIO/gsReadMesh.h>
+
 #include <rapidxml/rapidxml.hpp>       // External file
 #include <rapidxml/rapidxml_print.hpp> // External file
 
@@ -38,13 +41,16 @@
 #endif
 
 
-#include <zlib/gzstream.h>
+#include <gsIO/gsGzip.h>
+
+#include <iterator>
 
 
 namespace gismo {
 
 template<class T>
 gsFileData<T>::gsFileData()
+: m_file(NULL)
 { 
     data = new FileData; 
     data->makeRoot();
@@ -52,6 +58,7 @@ gsFileData<T>::gsFileData()
 
 template<class T>
 gsFileData<T>::gsFileData(String const & fn)
+: m_file(NULL)
 { 
     data = new FileData; 
     data->makeRoot();
@@ -64,6 +71,7 @@ gsFileData<T>::~gsFileData()
 { 
     data->clear(); 
     delete data; 
+    delete m_file;
 }
     
 
@@ -71,12 +79,16 @@ template<class T> void
 gsFileData<T>::clear() 
 {
     data->clear(); 
+    delete m_file;
+    m_file = NULL;
 }
 
 
 template<class T>
 std::ostream & gsFileData<T>::print(std::ostream &os) const
 { 
+    if ( m_file ) // raw data can not be printed
+        internal::encodeRawNodes(data, *data);
     //rapidxml::print_no_indenting
     os<< *data; 
     return os;
@@ -114,6 +126,9 @@ gsFileData<T>::save(std::string const & fname, bool compress)  const
     else
         tmp = fname;
     
+    if ( m_file ) // raw data can not be printed
+        internal::encodeRawNodes(data, *data);
+
     std::ofstream fn( tmp.c_str() ); 
     fn << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
     //rapidxml::print_no_indenting
@@ -136,13 +151,45 @@ gsFileData<T>::saveCompressed(std::string const & fname)  const
     else
         tmp = fname;
 
-    ogzstream fn( tmp.c_str() ); 
-    fn << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    //rapidxml::print_no_indenting
-    fn<< *data; 
-    fn.close(); 
+    if ( m_file ) // raw data can not be printed
+        internal::encodeRawNodes(data, *data);
+
+    // The text is compressed in blocks by several threads
+    std::string text("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    rapidxml::print(std::back_inserter(text), *data);
+    if ( !gsGzip::writeFile(tmp, text.data(), text.size()) )
+        gsWarn<<"gsFileData: Could not write file "<< tmp <<"\n";
 }
     
+template<class T> void
+gsFileData<T>::saveBinary(std::string const & fname, bool compress)  const
+{ 
+    String tmp = getExtension(fname);
+    if ( compress )
+    {
+        if ( tmp != "gz" )
+            tmp = fname + ( tmp == "gsb" ? ".gz" : ".gsb.gz" );
+        else
+            tmp = fname;
+
+        std::ostringstream str( std::ios::out | std::ios::binary );
+        internal::writeXmlBinary(str, *data);
+        const std::string bytes = str.str();
+        if ( !gsGzip::writeFile(tmp, bytes.data(), bytes.size()) )
+            gsWarn<<"gsFileData: Could not write file "<< tmp <<"\n";
+        return;
+    }
+
+    if (tmp != "gsb" )
+        tmp = fname + ".gsb";
+    else
+        tmp = fname;
+
+    std::ofstream fn( tmp.c_str(), std::ios::out | std::ios::binary );
+    internal::writeXmlBinary(fn, *data);
+    fn.close();
+}
+
 template<class T> void
 gsFileData<T>::ioError(int lineNumber,const std::string& str)
 {
@@ -160,6 +207,8 @@ void gsFileData<T>::read(String const & fn)
         readXmlFile(fn);
     else if (ext== "gz" && ends_with(fn, ".xml.gz") )
         readXmlGzFile(fn);
+    else if (ext== "gsb" || (ext== "gz" && ends_with(fn, ".gsb.gz")) )
+        readBinaryFile(fn);
     else if (ext== "txt") 
         readGeompFile(fn);
     else if (ext== "g2") 
@@ -192,6 +241,10 @@ void gsFileData<T>::read(String const & fn)
         readX3dFile(fn);
     else
         gsWarn<< "gsFileData: Unknown extension \"."<<ext<<"\"\n";
+
+    // Index the objects for the lookups by id and by tag
+    if ( gsXmlNode * root = data->first_node("xml") )
+        data->indexChildren(root);
 }
 
 ///////////////////////////////////////////////    
@@ -212,15 +265,56 @@ bool gsFileData<T>::readXmlFile( String const & fn )
 template<class T>
 bool gsFileData<T>::readXmlGzFile( String const & fn )
 {
-    // Open file
-    igzstream file(fn.c_str(), std::ios::in);
-    if ( file.fail() ) 
+    // Decompress (in parallel, if written by saveCompressed) into the buffer
+    std::vector<char> buffer;
+    if ( !gsGzip::readFile(fn, buffer) )
     {gsWarn<<"gsFileData: Input file Problem: "<<fn<<"\n"; return false; } 
+    buffer.push_back('\0');
+    m_buffer.swap(buffer);
 
-    return readGismoXmlStream(file);
+    data->parse<0>(&m_buffer[0]);
+    return true;
 }
 
 
+template<class T>
+bool gsFileData<T>::readBinaryFile( String const & fn )
+{
+    gsMappedFile * file = new gsMappedFile;
+    if ( !file->open(fn) )
+    {
+        delete file;
+        gsWarn<<"gsFileData: Input file Problem: "<<fn<<"\n";
+        return false;
+    }
+
+    // A compressed container is decompressed into memory
+    if ( gsGzip::isGzip(file->data(), file->size()) )
+    {
+        std::vector<char> buffer;
+        if ( !gsGzip::decompressData(file->data(), file->size(), buffer) )
+        {
+            delete file;
+            gsWarn<<"gsFileData: Invalid compressed file: "<<fn<<"\n";
+            return false;
+        }
+        file->assign(buffer);
+    }
+
+    if ( !internal::readXmlBinary(file->data(), file->size(), m_buffer, *data) )
+    {
+        delete file;
+        data->clear();
+        data->makeRoot();
+        gsWarn<<"gsFileData: Invalid binary file: "<<fn<<"\n";
+        return false;
+    }
+
+    delete m_file;
+    m_file = file;
+    return true;
+}
+
 template<class T>
 bool gsFileData<T>::readGismoXmlStream(std::istream & is)
 {
@@ -1086,49 +1180,11 @@ bool gsFileData<T>::readBezierView( String const & fn )
 template<class T>
 bool gsFileData<T>::readOffFile( String const & fn )
 {    
-    //Input file
-    std::ifstream file(fn.c_str(),std::ios::in);
-    if ( !file.good() ) {std::cout<<"Input file Problem!\n";return false;} 
-
-    gsXmlNode* g = internal::makeNode("Mesh", *data);
-    g->append_attribute( internal::makeAttribute("type", "off", *data) );
-    data->appendToRoot(g);
-
-    String line;
-    std::istringstream lnstream;
-    lnstream.unsetf(std::ios_base::skipws); 
-    std::ostringstream tmp;
-
-    getline(file, line);
-    if ( line.compare(0,3,"OFF") != 0)
+    gsMesh<T> mesh;
+    if ( !gsReadOff(fn, mesh) )
         return false;
-  
-    getline(file, line);
-    int nverts, nfaces, nedges(0);
-    lnstream.str(line);
-    lnstream >> std::ws >>  nverts >>  
-        std::ws >> nfaces >> 
-        std::ws >> nedges ;
-
-    g->append_attribute( internal::makeAttribute("vertices", nverts, *data) );
-    g->append_attribute( internal::makeAttribute("faces"   , nfaces, *data) );
-    g->append_attribute( internal::makeAttribute("edges"   , nedges, *data) );
-   
-    for (int i = 0; i < nverts; i++)
-        if ( getline(file, line) )
-            tmp << line.substr(0,line.size()) << std::endl;
-        else
-            return false;
-
-    for (int i = 0; i < nfaces; i++)
-        if ( getline(file, line) )
-            tmp << line.substr(0,line.size()) << std::endl;
-        else
-            return false;
-
-    g->value( internal::makeValue( tmp.str(), *data) );
-    tmp.clear();
 
+    data->appendToRoot( internal::gsXml< gsMesh<T> >::put(mesh, *data) );
     return true;
 }
 
@@ -1139,81 +1195,12 @@ bool gsFileData<T>::readOffFile( String const & fn )
 template<class T>
 bool gsFileData<T>::readStlFile( String const & fn )
 {    
-    bool solid(false),facet(false),loop(false);
-    //Input file
-    std::ifstream file(fn.c_str(),std::ios::in);
-    if ( !file.good() ) {std::cout<<"Input file Problem!\n";return false;} 
-
-    gsXmlNode* g = internal::makeNode("Mesh", *data);
-    g->append_attribute( internal::makeAttribute("type", "off", *data) );
-    data->appendToRoot(g);
-
-    std::ostringstream triangles;
-    triangles.unsetf(std::ios_base::skipws); 
-    std::ostringstream vertices;
-    vertices.unsetf(std::ios_base::skipws); 
-    unsigned nvert(0), nfaces(0), tmp(0);
-
-    unsigned lineNumber(0);
-    std::string str;
-
-    while( !file.eof() && getline(file, str) )
-    {
-        std::transform(str.begin(),str.end(),str.begin(),::tolower);
-        if(str.find("solid")!=String::npos && str.find("endsolid")==String::npos)
-        {
-            if(solid) ioError(lineNumber,"startSolid");
-            solid=true;
-        }
-        else if(str.find("endsolid")!=String::npos)
-        {
-            if(!solid || facet || loop) ioError(lineNumber,"endSolid");
-            solid=false;
-        }
-        else if(str.find("facet")!=String::npos && str.find("endfacet")==String::npos)
-        {
-            if(!solid || facet || loop) ioError(lineNumber,"startFacet");
-            facet=true;
-        }
-        else if(str.find("endfacet")!=String::npos)
-        {
-            if(!solid || !facet || loop) ioError(lineNumber,"endFacet");
-            facet=false;
-        }
-        else if(str.find("outer")!=String::npos)
-        {
-            if(!solid || !facet || loop) ioError(lineNumber,"startLoop");
-            loop=true;
-        }
-        else if(str.find("endloop")!=String::npos)
-        {
-            if(!solid || !facet || !loop ) 
-                ioError(lineNumber,"endLoop");
-            triangles<< tmp;
-            for (unsigned i= nvert-tmp; i!=nvert; ++i)
-                triangles<<" "<< i;	
-            triangles<<"\n";	
-            nfaces++;
-            loop=false;		
-            tmp = 0;
-        }
-        else if(str.find("vertex")!=String::npos)
-        {
-            if(!solid || !facet || !loop ) 
-                ioError(lineNumber,"vertex");
-            tmp++;
-            nvert++;
-            size_t pos=str.rfind("vertex")+7;
-            assert(pos!=String::npos);
-            vertices << str.substr(pos, str.size()-pos) <<"\n";
-        }
-    }
-
-    g->append_attribute( internal::makeAttribute("vertices", nvert,  *data) );
-    g->append_attribute( internal::makeAttribute("faces"   , nfaces, *data) );
-    vertices << triangles.str() ;
-    g->value( internal::makeValue( vertices.str(), *data) );
+    // ASCII or binary; vertices shared by several triangles are merged
+    gsMesh<T> mesh;
+    if ( !gsReadStl(fn, mesh) )
+        return false;
 
+    data->appendToRoot( internal::gsXml< gsMesh<T> >::put(mesh, *data) );
     return true;
 }
   
@@ -1221,6 +1208,13 @@ bool gsFileData<T>::readStlFile( String const & fn )
 template<class T>
 bool gsFileData<T>::readObjFile( String const & fn )
 {    
+    // Polygonal mesh, if any
+    gsMesh<T> mesh;
+    if ( !gsReadObj(fn, mesh) )
+        return false;
+    if ( mesh.numFaces > 0 )
+        data->appendToRoot( internal::gsXml< gsMesh<T> >::put(mesh, *data) );
+
     //std::cout<<"Assuming Linux file, please convert dos2unix first.\n";
 
 #if FALSE
@@ -1762,16 +1756,20 @@ gsFileData<T>::getFirstNode(const std::string & name, const std::string & type)
         assert( root ) ;
     }
 
-    if ( type == "" )
-        return root->first_node( name.c_str() );
-    else
+    if ( name == "" )
     {
-        for (gsXmlNode * child = root->first_node( name.c_str() ) ; 
-             child; child = child->next_sibling( name.c_str() ) )
-            if ( !strcmp( child->first_attribute("type")->value(), type.c_str() ) )
+        for (gsXmlNode * child = root->first_node(); 
+             child; child = child->next_sibling() )
+        {
+            const gsXmlAttribute * tp = child->first_attribute("type");
+            if ( type == "" || ( tp && !strcmp( tp->value(), type.c_str() ) ) )
                 return child;
+        }
         return NULL;
     }
+
+    // Children with this name, from the index of the tree
+    return firstOfType(data->childrenByName(root, name.c_str()), type);
 } 
 
 template<class T> inline
@@ -1780,52 +1778,26 @@ gsFileData<T>::getAnyFirstNode(const std::string & name, const std::string & typ
 { 
     gsXmlNode * root = data->first_node("xml");
     assert( root ) ;
-    if ( type == "" )
-        // Searching upto third level of the XML tree
-        for (gsXmlNode * child = root->first_node() ; 
-             child; child = child->next_sibling() )
-        {
-            if (!strcmp( child->name(), name.c_str() ) ) 
-                return child;
-            // Level 2
-            for (gsXmlNode * child2 = child->first_node() ; 
-                 child2; child2 = child2->next_sibling() )
-            {
-                if ( !strcmp( child2->name(), name.c_str() ) )
-                    return child2;
-                // Level 3
-                for (gsXmlNode * child3 = child2->first_node() ; 
-                     child3; child3 = child3->next_sibling() )
-                    if ( !strcmp( child3->name(), name.c_str() ) )
-                        return child3;
-            }
-        }
-    else
-        // Searching upto third level of the XML tree
-        for (gsXmlNode * child = root->first_node() ; 
-             child; child = child->next_sibling() )
-        {
-            if (!strcmp( child->name(), name.c_str() ) &&
-                !strcmp( child->first_attribute("type")->value(), type.c_str() ) ) 
-                return child;
-            // Level 2
-            for (gsXmlNode * child2 = child->first_node() ; 
-                 child2; child2 = child2->next_sibling() )
-            {
-                if ( !strcmp( child2->name(), name.c_str() ) &&
-                     !strcmp( child2->first_attribute("type")->value(), type.c_str() ))
-                    return child2;
-                // Level 3
-                for (gsXmlNode * child3 = child2->first_node() ; 
-                     child3; child3 = child3->next_sibling() )
-                    if ( !strcmp( child3->name(), name.c_str() ) &&
-                         !strcmp( child3->first_attribute("type")->value(), type.c_str()))
-                        return child3;
-            }
-        }
-    return NULL;
+    // Searching upto third level of the XML tree, using the index
+    return firstOfType(data->descendantsByName(root, name.c_str()), type);
 }   
 
+template<class T>
+typename gsFileData<T>::gsXmlNode * 
+gsFileData<T>::firstOfType(const std::vector<gsXmlNode*> & nodes, const std::string & type)
+{
+    for ( typename std::vector<gsXmlNode*>::const_iterator it = nodes.begin();
+          it != nodes.end(); ++it )
+    {
+        if ( type == "" )
+            return *it;
+        const gsXmlAttribute * tp = (*it)->first_attribute("type");
+        if ( tp && !strcmp( tp->value(), type.c_str() ) )
+            return *it;
+    }
+    return NULL;
+}
+
 template<class T> inline
 typename gsFileData<T>::gsXmlNode * 
 gsFileData<T>::getNextSibling(gsXmlNode* const & node, const std::string & name, 
@@ -0,0 +1,371 @@
+/** @file gsGzip.cpp
+
+    @brief Provides block-parallel gzip compression and decompression.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsCore/gsConfig.h>
+
+#include <gsIO/gsGzip.h>
+#include <gsIO/gsMappedFile.h>
+#include <gsCore/gsDebug.h>
+
+#include <zlib/zlib.h>
+
+#include <fstream>
+#include <algorithm>
+#include <climits>
+
+#ifdef GISMO_BUILD_CPP11
+#include <thread>
+#include <atomic>
+#endif
+
+namespace gismo
+{
+
+namespace
+{
+
+unsigned s_threads   = 0;
+size_t   s_blockSize = 1 << 20;
+
+// Member layout: header with the extra field "GS" holding the size of
+// the member, raw deflate data, CRC32 and size of the input
+const size_t s_headerSize  = 20;
+const size_t s_trailerSize = 8;
+
+void putLE32(unsigned char * p, unsigned long v)
+{
+    p[0] = static_cast<unsigned char>(v      );
+    p[1] = static_cast<unsigned char>(v >>  8);
+    p[2] = static_cast<unsigned char>(v >> 16);
+    p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+unsigned long getLE32(const char * c)
+{
+    const unsigned char * p = reinterpret_cast<const unsigned char*>(c);
+    return  static_cast<unsigned long>(p[0])        | (static_cast<unsigned long>(p[1]) <<  8)
+        | (static_cast<unsigned long>(p[2]) << 16) | (static_cast<unsigned long>(p[3]) << 24);
+}
+
+unsigned getLE16(const char * c)
+{
+    const unsigned char * p = reinterpret_cast<const unsigned char*>(c);
+    return p[0] | (p[1] << 8);
+}
+
+/// Calls task(i) for i = 0..n-1, distributed over the threads
+template<class Task>
+void parallelFor(const size_t n, Task & task)
+{
+#ifdef GISMO_BUILD_CPP11
+    const size_t nt = std::min<size_t>(gsGzip::numThreads(), n);
+    if ( nt > 1 )
+    {
+        std::atomic<size_t> next(0);
+        auto work = [&]()
+        {
+            for ( size_t i = next++; i < n; i = next++ )
+                task(i);
+        };
+        std::vector<std::thread> threads;
+        for ( size_t t = 1; t < nt; ++t )
+            threads.push_back( std::thread(work) );
+        work();
+        for ( size_t t = 0; t != threads.size(); ++t )
+            threads[t].join();
+        return;
+    }
+#endif
+    for ( size_t i = 0; i != n; ++i )
+        task(i);
+}
+
+/// Compresses blocks into complete gzip members
+struct compressTask
+{
+    const char * data;
+    size_t n, blockSize;
+    int level;
+    std::vector< std::vector<char> > members;
+    std::vector<int> errors;
+
+    void operator()(size_t i)
+    {
+        const size_t first = i * blockSize;
+        const size_t len   = std::min(blockSize, n - first);
+        const Bytef * in   = reinterpret_cast<const Bytef*>(data + first);
+
+        z_stream strm;
+        strm.zalloc = Z_NULL;
+        strm.zfree  = Z_NULL;
+        strm.opaque = Z_NULL;
+        int err = deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        if ( Z_OK != err ) { errors[i] = err; return; }
+
+        std::vector<char> & m = members[i];
+        m.resize( s_headerSize + deflateBound(&strm, len) + s_trailerSize );
+        unsigned char * out = reinterpret_cast<unsigned char*>(&m[0]);
+
+        strm.next_in   = const_cast<Bytef*>(in);
+        strm.avail_in  = static_cast<uInt>(len);
+        strm.next_out  = out + s_headerSize;
+        strm.avail_out = static_cast<uInt>(m.size() - s_headerSize - s_trailerSize);
+        err = deflate(&strm, Z_FINISH);
+        const size_t clen = strm.total_out;
+        deflateEnd(&strm);
+        if ( Z_STREAM_END != err ) { errors[i] = err; return; }
+
+        const size_t total = s_headerSize + clen + s_trailerSize;
+        m.resize(total);
+        out = reinterpret_cast<unsigned char*>(&m[0]);
+
+        // Header: magic, deflate, FEXTRA, no time, unknown OS, extra
+        // field of 8 bytes with the subfield "GS" of 4 bytes
+        const unsigned char header[12] =
+            { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 255, 8, 0 };
+        std::copy(header, header + 12, out);
+        out[12] = 'G'; out[13] = 'S'; out[14] = 4; out[15] = 0;
+        putLE32(out + 16, static_cast<unsigned long>(total));
+
+        putLE32(out + total - 8, crc32(crc32(0L, Z_NULL, 0), in, static_cast<uInt>(len)));
+        putLE32(out + total - 4, static_cast<unsigned long>(len));
+    }
+};
+
+/// A member of an indexed gzip file
+struct memberInfo
+{
+    const char * data;  // raw deflate data
+    size_t size;        // size of the deflate data
+    size_t outOffset;   // position of the output
+    size_t outSize;
+    unsigned long crc;
+};
+
+/// Decompresses indexed members into their part of the output
+struct inflateTask
+{
+    const std::vector<memberInfo> * members;
+    char * out;
+    std::vector<int> ok;
+
+    void operator()(size_t i)
+    {
+        const memberInfo & m = (*members)[i];
+        Bytef * dst = reinterpret_cast<Bytef*>(out + m.outOffset);
+
+        z_stream strm;
+        strm.zalloc = Z_NULL;
+        strm.zfree  = Z_NULL;
+        strm.opaque = Z_NULL;
+        strm.next_in  = Z_NULL;
+        strm.avail_in = 0;
+        if ( Z_OK != inflateInit2(&strm, -MAX_WBITS) )
+            return;
+        strm.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(m.data));
+        strm.avail_in  = static_cast<uInt>(m.size);
+        strm.next_out  = dst;
+        strm.avail_out = static_cast<uInt>(m.outSize);
+        const int err = inflate(&strm, Z_FINISH);
+        const size_t produced = strm.total_out;
+        inflateEnd(&strm);
+
+        ok[i] = Z_STREAM_END == err && produced == m.outSize
+            && m.crc == crc32(crc32(0L, Z_NULL, 0), dst, static_cast<uInt>(m.outSize));
+    }
+};
+
+/// Splits the data into members written by gsGzip::compressData; returns
+/// false if the data were not written in this way
+bool indexMembers(const char * data, const size_t n, std::vector<memberInfo> & members)
+{
+    size_t pos = 0, out = 0;
+    while ( pos < n )
+    {
+        const char * p = data + pos;
+        if ( n - pos < s_headerSize + s_trailerSize || !gsGzip::isGzip(p, n - pos)
+             || 8 != p[2] || 4 != p[3] ) // deflate, only FEXTRA
+            return false;
+
+        // Look for the subfield "GS" in the extra field
+        const size_t xlen = getLE16(p + 10);
+        size_t total = 0;
+        for ( size_t k = 12; k + 4 <= 12 + xlen && 12 + xlen + s_trailerSize <= n - pos; )
+        {
+            const size_t slen = getLE16(p + k + 2);
+            if ( 'G' == p[k] && 'S' == p[k+1] && 4 == slen && k + 8 <= 12 + xlen )
+                total = getLE32(p + k + 4);
+            k += 4 + slen;
+        }
+        if ( total < 12 + xlen + s_trailerSize || total > n - pos )
+            return false;
+
+        memberInfo m;
+        m.data      = p + 12 + xlen;
+        m.size      = total - 12 - xlen - s_trailerSize;
+        m.crc       = getLE32(p + total - 8);
+        m.outSize   = getLE32(p + total - 4);
+        m.outOffset = out;
+        members.push_back(m);
+
+        out += m.outSize;
+        pos += total;
+    }
+    return !members.empty();
+}
+
+/// Lets zlib see the input from next_in up to \a end; zlib counts
+/// in uInt, hence at most UINT_MAX bytes at a time
+void refillInput(z_stream & strm, const char * end)
+{
+    const size_t left = static_cast<size_t>(end - reinterpret_cast<const char*>(strm.next_in));
+    strm.avail_in = static_cast<uInt>( std::min<size_t>(left, UINT_MAX) );
+}
+
+/// Decompresses any gzip data (possibly several members) serially
+bool inflateSerial(const char * data, const size_t n, std::vector<char> & result)
+{
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree  = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.next_in  = Z_NULL;
+    strm.avail_in = 0;
+    if ( Z_OK != inflateInit2(&strm, 16 + MAX_WBITS) ) // gzip only
+        return false;
+
+    const char * end = data + n;
+    strm.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+
+    const size_t chunk = 1 << 18;
+    int err = Z_OK;
+    for (;;)
+    {
+        refillInput(strm, end);
+        const size_t used = result.size();
+        result.resize(used + chunk);
+        strm.next_out  = reinterpret_cast<Bytef*>(&result[used]);
+        strm.avail_out = static_cast<uInt>(chunk);
+        err = inflate(&strm, Z_NO_FLUSH);
+        result.resize(used + chunk - strm.avail_out);
+
+        if ( Z_STREAM_END == err )
+        {
+            // Further members follow
+            refillInput(strm, end);
+            if ( strm.avail_in > 0 && gsGzip::isGzip(
+                     reinterpret_cast<const char*>(strm.next_in), strm.avail_in) )
+            {
+                inflateReset(&strm);
+                continue;
+            }
+            break;
+        }
+        if ( Z_OK != err && !(Z_BUF_ERROR == err
+                              && reinterpret_cast<const char*>(strm.next_in) != end) )
+            break;
+    }
+    inflateEnd(&strm);
+    return Z_STREAM_END == err;
+}
+
+} // namespace
+
+void gsGzip::setNumThreads(unsigned n)
+{
+    s_threads = n;
+}
+
+unsigned gsGzip::numThreads()
+{
+    if ( s_threads )
+        return s_threads;
+#ifdef GISMO_BUILD_CPP11
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+#else
+    return 1;
+#endif
+}
+
+void gsGzip::setBlockSize(size_t bytes)
+{
+    GISMO_ENSURE( bytes > 0 && bytes < (1UL << 31), "Invalid block size "<< bytes <<".");
+    s_blockSize = bytes;
+}
+
+void gsGzip::compressData(const char * data, size_t n, std::ostream & out, int level)
+{
+    const size_t nBlocks = n ? (n + s_blockSize - 1) / s_blockSize : 1;
+
+    // Compress batches of blocks, so that the memory use is bounded
+    const size_t batch = 4 * numThreads();
+    for ( size_t first = 0; first < nBlocks; first += batch )
+    {
+        const size_t nb = std::min(batch, nBlocks - first);
+
+        compressTask task;
+        task.data      = data + first * s_blockSize;
+        task.n         = n - std::min(n, first * s_blockSize);
+        task.blockSize = s_blockSize;
+        task.level     = level;
+        task.members.resize(nb);
+        task.errors.resize(nb, Z_OK);
+        parallelFor(nb, task);
+
+        for ( size_t i = 0; i != nb; ++i )
+        {
+            GISMO_ENSURE( Z_OK == task.errors[i], "gzip compression failed (zlib error "
+                          << task.errors[i] <<").");
+            out.write(&task.members[i][0], task.members[i].size());
+        }
+    }
+}
+
+bool gsGzip::decompressData(const char * data, size_t n, std::vector<char> & result)
+{
+    std::vector<memberInfo> members;
+    if ( !indexMembers(data, n, members) )
+        return inflateSerial(data, n, result);
+
+    const size_t base = result.size();
+    result.resize( base + members.back().outOffset + members.back().outSize );
+    if ( result.size() == base )
+        return true;
+
+    inflateTask task;
+    task.members = &members;
+    task.out     = &result[base];
+    task.ok.resize(members.size(), 0);
+    parallelFor(members.size(), task);
+
+    return std::find(task.ok.begin(), task.ok.end(), 0) == task.ok.end();
+}
+
+bool gsGzip::writeFile(const std::string & fn, const char * data, size_t n, int level)
+{
+    std::ofstream file(fn.c_str(), std::ios::out | std::ios::binary);
+    if ( !file )
+        return false;
+    compressData(data, n, file, level);
+    file.close();
+    return !file.fail();
+}
+
+bool gsGzip::readFile(const std::string & fn, std::vector<char> & result)
+{
+    gsMappedFile file;
+    if ( !file.open(fn) )
+        return false;
+    return decompressData(file.data(), file.size(), result);
+}
+
+} // namespace gismo
@@ -0,0 +1,81 @@
+/** @file gsGzip.h
+
+    @brief Provides block-parallel gzip compression and decompression.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsExport.h>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace gismo
+{
+
+/**
+    \brief Compresses and decompresses gzip data using several threads.
+
+    The data are split into blocks (1 MiB by default), which are
+    compressed independently and written as consecutive gzip members.
+    A concatenation of gzip members is a valid gzip file, hence the
+    output is read by gunzip and by any zlib-based reader. Every
+    member carries its compressed size in an extra field of its
+    header (as in the BGZF format), so that the blocks can also be
+    located and decompressed in parallel.
+
+    Files which were written by other programs (single member, or
+    members without the size field) are decompressed serially.
+
+    The number of threads is set by setNumThreads(); without C++11
+    support (GISMO_BUILD_CPP11) everything runs in the calling thread.
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsGzip
+{
+public:
+
+    /// \brief Sets the number of threads used for (de)compression. The
+    /// default, 0, uses as many threads as the hardware supports
+    static void setNumThreads(unsigned n);
+
+    /// Number of threads used for (de)compression
+    static unsigned numThreads();
+
+    /// \brief Sets the size of the uncompressed blocks (default 1 MiB).
+    /// Larger blocks compress slightly better, smaller blocks give more
+    /// parallelism for small files
+    static void setBlockSize(size_t bytes);
+
+    /// \brief Compresses \a n bytes at \a data and writes them in gzip
+    /// format to \a out
+    ///
+    /// \param level zlib compression level (0-9), -1 for the default level
+    static void compressData(const char * data, size_t n, std::ostream & out, int level = -1);
+
+    /// \brief Decompresses the gzip data \a data of \a n bytes and
+    /// appends them to \a result. Returns false if the data are not
+    /// valid gzip data (\a result is undefined then)
+    static bool decompressData(const char * data, size_t n, std::vector<char> & result);
+
+    /// Writes \a n bytes at \a data to the gzip file \a fn
+    static bool writeFile(const std::string & fn, const char * data, size_t n, int level = -1);
+
+    /// Reads and decompresses the gzip file \a fn into \a result
+    static bool readFile(const std::string & fn, std::vector<char> & result);
+
+    /// Returns true if the \a n bytes at \a data start with the gzip magic number
+    static bool isGzip(const char * data, size_t n)
+    {
+        return n >= 2 && '\x1f' == data[0] && '\x8b' == data[1];
+    }
+};
+
+} // namespace gismo
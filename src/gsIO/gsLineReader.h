@@ -0,0 +1,115 @@
+/** @file gsLineReader.h
+
+    @brief Provides a fast line-by-line reader for large text files.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <istream>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+
+namespace gismo {
+
+namespace internal {
+
+/// \brief Reads a text stream line by line into a large buffer, to
+/// avoid the allocation of one string per line. The lines are
+/// returned in place, terminated by zero and without line endings.
+class gsLineReader
+{
+public:
+
+    explicit gsLineReader(std::istream & in, size_t chunk = 1 << 20)
+    : m_in(in), m_buf(chunk + 1), m_begin(0), m_end(0), m_line(0), m_eof(false)
+    { }
+
+    /// Sets \a line to the next line; returns false at the end of the stream
+    bool next(char * & line)
+    {
+        for (;;)
+        {
+            char * const first = &m_buf[0] + m_begin;
+            char * nl = static_cast<char*>( std::memchr(first, '\n', m_end - m_begin) );
+            if ( nl || (m_eof && m_begin != m_end) )
+            {
+                if ( !nl ) // last line without line ending
+                    nl = &m_buf[0] + m_end;
+                m_begin = nl - &m_buf[0] + 1;
+                if ( nl != first && '\r' == nl[-1] )
+                    --nl;
+                *nl = '\0';
+                line = first;
+                ++m_line;
+                return true;
+            }
+            if ( m_eof )
+                return false;
+
+            // Keep the incomplete line and read the next chunk
+            const size_t rest = m_end - m_begin;
+            std::memmove(&m_buf[0], first, rest);
+            m_begin = 0;
+            m_end   = rest;
+            if ( m_end + 1 == m_buf.size() ) // very long line
+                m_buf.resize( 2 * m_buf.size() );
+            m_in.read(&m_buf[m_end], m_buf.size() - 1 - m_end);
+            m_end += static_cast<size_t>( m_in.gcount() );
+            m_eof = !m_in;
+        }
+    }
+
+    /// Number of the line returned last (starting from one)
+    size_t lineNumber() const { return m_line; }
+
+private:
+    std::istream & m_in;
+    std::vector<char> m_buf;
+    size_t m_begin, m_end, m_line;
+    bool m_eof;
+};
+
+/// Returns \a p advanced past blanks (not past the end of the line)
+inline const char * skipSpace(const char * p)
+{
+    while ( ' ' == *p || '\t' == *p || '\r' == *p || '\v' == *p || '\f' == *p )
+        ++p;
+    return p;
+}
+
+/// Reads an integer, advancing \a p; returns false if there is none
+inline bool readIndex(const char * & p, long & val)
+{
+    char * end;
+    val = std::strtol(p, &end, 10);
+    if ( end == p )
+        return false;
+    p = end;
+    return true;
+}
+
+/// Sets \a p to the next line which is neither empty nor a comment (starting
+/// with '#' or '%')
+inline bool nextDataLine(gsLineReader & lines, const char * & p)
+{
+    char * line;
+    do
+    {
+        if ( !lines.next(line) )
+            return false;
+        p = skipSpace(line);
+    }
+    while ( '\0' == *p || '#' == *p || '%' == *p );
+    return true;
+}
+
+} // namespace internal
+
+} // namespace gismo
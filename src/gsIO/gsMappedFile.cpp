@@ -0,0 +1,87 @@
+/** @file gsMappedFile.cpp
+
+    @brief Provides read-only access to the contents of a file through
+    a memory mapping.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsIO/gsMappedFile.h>
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GISMO_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace gismo
+{
+
+bool gsMappedFile::open(const std::string & fn)
+{
+    close();
+
+#if defined(GISMO_MMAP)
+    const int fd = ::open(fn.c_str(), O_RDONLY);
+    if ( fd < 0 )
+        return false;
+
+    struct stat st;
+    if ( 0 == fstat(fd, &st) && st.st_size > 0 )
+    {
+        void * addr = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if ( MAP_FAILED != addr )
+        {
+            m_data   = static_cast<const char*>(addr);
+            m_size   = static_cast<size_t>(st.st_size);
+            m_mapped = true;
+        }
+    }
+    ::close(fd); // the mapping stays valid
+    if ( m_mapped )
+        return true;
+#endif
+
+    // Read the whole file
+    std::ifstream file(fn.c_str(), std::ios::in | std::ios::binary);
+    if ( file.fail() )
+        return false;
+    m_buffer.assign( std::istreambuf_iterator<char>(file.rdbuf()),
+                     std::istreambuf_iterator<char>() );
+    m_buffer.push_back('\0'); // non-empty, also for empty files
+    m_data = &m_buffer[0];
+    m_size = m_buffer.size() - 1;
+    return true;
+}
+
+void gsMappedFile::assign(std::vector<char> & buffer)
+{
+    close();
+    m_buffer.swap(buffer);
+    m_buffer.push_back('\0'); // non-empty
+    m_data = &m_buffer[0];
+    m_size = m_buffer.size() - 1;
+}
+
+void gsMappedFile::close()
+{
+#if defined(GISMO_MMAP)
+    if ( m_mapped )
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_data   = NULL;
+    m_size   = 0;
+    m_mapped = false;
+    std::vector<char>().swap(m_buffer);
+}
+
+} // namespace gismo
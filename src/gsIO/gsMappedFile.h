@@ -0,0 +1,78 @@
+/** @file gsMappedFile.h
+
+    @brief Provides read-only access to the contents of a file through
+    a memory mapping.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsExport.h>
+#include <string>
+#include <vector>
+
+namespace gismo
+{
+
+/**
+    \brief Read-only view of the contents of a file.
+
+    On POSIX systems the file is memory-mapped, so that only the parts
+    which are accessed are read from disk. On other systems the file
+    is read into memory.
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsMappedFile
+{
+public:
+
+    gsMappedFile() : m_data(NULL), m_size(0), m_mapped(false) { }
+
+    /// Opens the file \a fn, see open()
+    explicit gsMappedFile(const std::string & fn)
+    : m_data(NULL), m_size(0), m_mapped(false)
+    { open(fn); }
+
+    ~gsMappedFile() { close(); }
+
+    /// Opens the file \a fn, returns false on failure
+    bool open(const std::string & fn);
+
+    /// \brief Takes over the contents of \a buffer (e.g. a decompressed
+    /// file) instead of a file; \a buffer is left empty
+    void assign(std::vector<char> & buffer);
+
+    /// Releases the contents of the file
+    void close();
+
+    /// True if a file is open
+    bool isOpen() const { return NULL != m_data; }
+
+    /// Pointer to the first byte of the file (page aligned if mapped)
+    const char * data() const { return m_data; }
+
+    /// Size of the file in bytes
+    size_t size() const { return m_size; }
+
+private:
+
+    const char * m_data;
+    size_t m_size;
+
+    /// True if m_data is a memory mapping, otherwise it points into m_buffer
+    bool m_mapped;
+    std::vector<char> m_buffer;
+
+private:
+    // Copying is not allowed
+    gsMappedFile(const gsMappedFile &);
+    gsMappedFile & operator=(const gsMappedFile &);
+};
+
+} // namespace gismo
@@ -15,6 +15,8 @@
 
 #include <gsCore/gsForwardDeclarations.h>
 
+#include <cstdio>
+
 namespace gismo {
 
 /** 
@@ -93,6 +95,37 @@ public:
               <<fn<<part<<ext<<"\"/>\n";//<<"_"
     }
 
+    /// Adds the file \a fn (complete filename) as part \a part of
+    /// the time step at time \a time
+    void addTimestep(String const & fn, real_t time, int part = 0)
+    {
+        GISMO_ASSERT(counter!=-1, "Error: collection has been already saved." );
+        mfile << "<DataSet part=\""<<part<<"\" timestep=\""
+              <<time<<"\" file=\""<<fn<<"\"/>\n";
+    }
+
+    /// \brief Writes the collection file with the parts added so
+    /// far, the collection stays open for further parts.
+    ///
+    /// The file is replaced as a whole (written to a temporary file
+    /// which is then renamed), hence a valid collection file exists
+    /// at any time, e.g. for following a running computation or
+    /// after an abort.
+    void flush()
+    {
+        GISMO_ASSERT(counter!=-1, "Error: gsParaviewCollection::save() already called." );
+        const String fn  = mfn + ".pvd";
+        const String tmp = fn + ".tmp";
+        std::ofstream f( tmp.c_str() );
+        GISMO_ENSURE(f.is_open(), "Error creating "<< tmp );
+        f << mfile.str() <<"</Collection>\n</VTKFile>\n";
+        f.close();
+#       if defined(_WIN32)
+        std::remove( fn.c_str() ); // rename does not replace files on Windows
+#       endif
+        GISMO_ENSURE( 0 == std::rename(tmp.c_str(), fn.c_str()), "Error renaming "<< tmp );
+    }
+
     /// Finalizes the collection by closing the XML tags, always call
     /// this function (once) when you finish adding files
     void save()
@@ -0,0 +1,250 @@
+/** @file gsParaviewSink.h
+
+    @brief Provides an asynchronous output sink for time series of
+    isogeometric fields in Paraview format.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsField.h>
+#include <gsIO/gsWriteParaview.h>
+#include <gsIO/gsParaviewCollection.h>
+
+#ifdef GISMO_BUILD_CPP11
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+#include <deque>
+
+namespace gismo
+{
+
+/**
+    \brief Writes a time series of isogeometric fields to Paraview
+    files without blocking the computation.
+
+    The solver hands over a snapshot of the solution at every output
+    time by push(). The snapshot is copied, and a background thread
+    samples it, writes one file per patch and adds the files to the
+    collection \a fn.pvd. The collection file is rewritten after every
+    time step, so that it is valid during the computation and after an
+    abort.
+
+    Typical usage is
+    \verbatim
+    gsParaviewSink<real_t> sink("solution", geometry);
+    for ( ... ) // time loop
+    {
+        ...
+        sink.push(solution, t); // returns immediately
+    }
+    sink.finish(); // waits for the pending snapshots
+    \endverbatim
+
+    At most \a maxPending snapshots are queued; push() waits when
+    the writer falls behind, bounding the memory use.
+
+    Without C++11 support (see the CMake option GISMO_BUILD_CPP11),
+    push() writes the snapshot synchronously.
+
+    \ingroup IO
+*/
+template<class T>
+class gsParaviewSink
+{
+public:
+
+    /// \brief Constructor
+    ///
+    /// \param fn         base filename; the collection is \a fn.pvd
+    /// \param geometry   the domain of the fields (referenced, must outlive the sink)
+    /// \param npts       number of sampling points per patch
+    /// \param maxPending maximal number of snapshots waiting to be written
+    gsParaviewSink(std::string const & fn, const gsMultiPatch<T> & geometry,
+                   unsigned npts = 1000, size_t maxPending = 2)
+    : m_fn(fn), m_geometry(geometry), m_npts(npts),
+      m_maxPending(maxPending > 0 ? maxPending : 1), m_collection(fn),
+      m_step(0), m_finished(false)
+    {
+#       ifdef GISMO_BUILD_CPP11
+        m_thread = std::thread(&gsParaviewSink::run, this);
+#       endif
+    }
+
+    /// Destructor, writes all pending snapshots
+    ~gsParaviewSink() { finish(); }
+
+    /// \brief Hands over the solution \a solution at time \a time.
+    /// The solution is copied, it can be modified as soon as the
+    /// function returns.
+    void push(const gsMultiPatch<T> & solution, T time)
+    {
+        GISMO_ASSERT( solution.nPatches() == m_geometry.nPatches(),
+                      "The solution does not match the geometry.");
+        enqueue( new Snapshot(solution, time) );
+    }
+
+    /// \brief Hands over the isogeometric field \a field at time
+    /// \a time (see push(const gsMultiPatch<T>&, T)). Throws if the
+    /// field is not isogeometric.
+    void push(const gsField<T> & field, T time)
+    {
+        GISMO_ENSURE( field.nPatches() == static_cast<int>(m_geometry.nPatches()),
+                      "The field does not match the geometry.");
+        GISMO_ENSURE( field.isParametrized(), "The field is not isogeometric.");
+        for ( int i = 0; i != field.nPatches(); ++i )
+            GISMO_ENSURE( dynamic_cast<const gsGeometry<T> *>(&field.function(i)),
+                          "The field is not isogeometric on patch "<< i <<".");
+        Snapshot * s = new Snapshot(time);
+        for ( int i = 0; i != field.nPatches(); ++i )
+            s->solution.addPatch( field.igaFunction(i) );
+        enqueue(s);
+    }
+
+    /// Blocks until all snapshots handed over so far are written
+    void flush()
+    {
+#       ifdef GISMO_BUILD_CPP11
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]{ return m_queue.empty() && !m_busy; });
+#       endif
+    }
+
+    /// \brief Writes all pending snapshots and stops the background
+    /// thread. Further snapshots cannot be pushed.
+    void finish()
+    {
+        if ( m_finished )
+            return;
+#       ifdef GISMO_BUILD_CPP11
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finished = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+#       else
+        m_finished = true;
+#       endif
+        if ( m_step > 0 )
+            m_collection.save();
+    }
+
+    /// Number of snapshots handed over so far
+    index_t numSteps() const { return m_step; }
+
+private:
+
+    struct Snapshot
+    {
+        explicit Snapshot(T t) : time(t) { }
+        Snapshot(const gsMultiPatch<T> & sol, T t) : solution(sol), time(t) { }
+
+        gsMultiPatch<T> solution;
+        T time;
+        index_t step;
+    };
+
+    void enqueue(Snapshot * s)
+    {
+        GISMO_ENSURE( !m_finished, "gsParaviewSink::finish() has already been called.");
+#       ifdef GISMO_BUILD_CPP11
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_space.wait(lock, [this]{ return m_queue.size() < m_maxPending; });
+            s->step = m_step++;
+            m_queue.push_back(s);
+        }
+        m_wake.notify_one();
+#       else
+        s->step = m_step++;
+        write(*s);
+        delete s;
+#       endif
+    }
+
+    /// Samples and writes one snapshot, and updates the collection
+    void write(const Snapshot & s)
+    {
+        const std::string base = m_fn + "_" + internal::toString<index_t>(s.step) + "_";
+        for ( size_t i = 0; i != m_geometry.nPatches(); ++i )
+        {
+            const std::string fileName = base + internal::toString<size_t>(i);
+            writeSinglePatchField(m_geometry.patch(i), s.solution.patch(i), true,
+                                  fileName, m_npts);
+            m_collection.addTimestep(fileName + ".vts", s.time, i);
+        }
+        m_collection.flush();
+    }
+
+#   ifdef GISMO_BUILD_CPP11
+    /// The background thread
+    void run()
+    {
+        for (;;)
+        {
+            Snapshot * s;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this]{ return !m_queue.empty() || m_finished; });
+                if ( m_queue.empty() ) // finished
+                    return;
+                s = m_queue.front();
+                m_queue.pop_front();
+                m_busy = true;
+            }
+            m_space.notify_one();
+
+            try { write(*s); }
+            catch ( std::exception & e )
+            { gsWarn << "gsParaviewSink: writing time step "<< s->step <<" failed: "<< e.what() <<"\n"; }
+            delete s;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_busy = false;
+            }
+            m_idle.notify_all();
+        }
+    }
+#   endif
+
+private:
+
+    std::string m_fn;
+    const gsMultiPatch<T> & m_geometry;
+    unsigned m_npts;
+    size_t   m_maxPending;
+
+    /// The collection, only accessed by the writing thread
+    gsParaviewCollection m_collection;
+
+    /// Snapshots waiting to be written
+    std::deque<Snapshot*> m_queue;
+
+    index_t m_step;
+    bool    m_finished;
+
+#   ifdef GISMO_BUILD_CPP11
+    bool m_busy = false;
+    std::mutex m_mutex;
+    std::condition_variable m_wake, m_space, m_idle;
+    std::thread m_thread;
+#   endif
+
+private:
+    // Copying is not allowed
+    gsParaviewSink(const gsParaviewSink &);
+    gsParaviewSink & operator=(const gsParaviewSink &);
+};
+
+} // namespace gismo
@@ -24,6 +24,7 @@
 #include <string>
 
 #include <gsCore/gsDebug.h>
+#include <gsIO/gsReadMesh.h>
 
 namespace gismo 
 {
@@ -50,13 +51,15 @@ public:
         @param fn filename string
     */
     gsReadFile(std::string const & fn)
-    : m_id(-1)
+    : m_fn(fn), m_id(-1)
     { 
-        m_data.read(fn);
+        // Meshes are read directly by operator gsMesh<T>*
+        if ( !isMeshFile(fn) )
+            m_data.read(fn);
     }
 
     gsReadFile(std::string const & fn, index_t id)
-    : m_id(id)
+    : m_fn(fn), m_id(id)
     { 
         m_data.read(fn);
     }
@@ -76,7 +79,7 @@ public:
     */
     template<class Obj>
     gsReadFile(std::string const & fn, Obj & result)
-    : m_id(-1)
+    : m_fn(fn), m_id(-1)
     { 
         m_data.read(fn);
         m_data.getAnyFirst(result);
@@ -90,6 +93,9 @@ private:
     /// File data as a Gismo xml tree
     gsFileData<T> m_data;
 
+    /// The filename
+    std::string m_fn;
+
     index_t m_id;
     
 public:
@@ -194,6 +200,16 @@ public:
     /// Allows to read a gsMesh
     operator gsMesh<T> * () 
     {
+        // STL, OBJ and OFF files are read without the XML tree
+        if ( isMeshFile(m_fn) )
+        {
+            gsMesh<T> * m = new gsMesh<T>;
+            if ( gsReadMesh(m_fn, *m) )
+                return m;
+            delete m;
+            return NULL;
+        }
+
         // Get the first Mesh, if one exists
         if ( this->m_data.template has< gsMesh<T>  >() )
             return  this->m_data.template getFirst< gsMesh<T>  >();
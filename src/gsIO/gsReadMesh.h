@@ -0,0 +1,75 @@
+/** @file gsReadMesh.h
+
+    @brief Provides functions reading triangle and polygon meshes
+    from STL, OBJ and OFF files directly into a gsMesh.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+
+#include <string>
+#include <cctype>
+
+namespace gismo {
+
+/// \brief Reads the mesh in file \a fn into \a mesh.
+///
+/// The format is identified by the extension: STL (".stl", ASCII or
+/// binary), Wavefront OBJ (".obj", vertices and faces only) or OFF
+/// (".off"). The file is read in a single streaming pass, without
+/// an intermediate text or XML representation.
+///
+/// The triangles of an STL file do not share vertices; if \a merge is
+/// true, vertices with equal coordinates are merged while reading
+/// (by hashing), so that cleanStlMesh() is not necessary. OBJ and OFF
+/// files are read with their vertex indexing.
+///
+/// The vertices and faces are appended to \a mesh.
+///
+/// \returns false if the file could not be read
+///
+/// \ingroup IO
+template<class T>
+bool gsReadMesh(std::string const & fn, gsMesh<T> & mesh, bool merge = true);
+
+/// \brief Reads an STL file (ASCII or binary) into \a mesh, see gsReadMesh()
+/// \ingroup IO
+template<class T>
+bool gsReadStl(std::string const & fn, gsMesh<T> & mesh, bool merge = true);
+
+/// \brief Reads the vertices and faces of an OBJ file into \a mesh, see gsReadMesh()
+/// \ingroup IO
+template<class T>
+bool gsReadObj(std::string const & fn, gsMesh<T> & mesh);
+
+/// \brief Reads an OFF file into \a mesh, see gsReadMesh()
+/// \ingroup IO
+template<class T>
+bool gsReadOff(std::string const & fn, gsMesh<T> & mesh);
+
+/// Returns true if the extension of \a fn is one of the mesh formats
+/// read by gsReadMesh()
+/// \ingroup IO
+inline bool isMeshFile(std::string const & fn)
+{
+    const size_t dot = fn.find_last_of('.');
+    if ( std::string::npos == dot )
+        return false;
+    std::string ext = fn.substr(dot + 1);
+    for ( std::string::iterator it = ext.begin(); it != ext.end(); ++it )
+        *it = static_cast<char>( std::tolower(*it) );
+    return ext == "stl" || ext == "obj" || ext == "off";
+}
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsReadMesh.hpp)
+#endif
@@ -0,0 +1,342 @@
+/** @file gsReadMesh.hpp
+
+    @brief Provides implementation of the functions reading STL, OBJ
+    and OFF meshes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsIO/gsReadMesh.h>
+#include <gsIO/gsXml.h>
+#include <gsIO/gsLineReader.h>
+#include <gsUtils/gsMesh/gsMesh.h>
+#include <gsUtils/gsMesh/gsVertexHashMap.h>
+
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+namespace gismo {
+
+namespace internal {
+
+/// Returns true if the (zero-terminated) text at \a p starts with
+/// the word \a word, case insensitively; \a p is advanced past the word
+inline bool readKeyword(const char * & p, const char * word)
+{
+    const char * q = p;
+    for ( ; *word; ++q, ++word )
+        if ( std::tolower(static_cast<unsigned char>(*q)) != *word )
+            return false;
+    if ( *q && ' ' != *q && '\t' != *q )
+        return false;
+    p = q;
+    return true;
+}
+
+template<class T>
+bool readPoint(const char * & p, T & x, T & y, T & z)
+{
+    return readValue(p, x) && readValue(p, y) && readValue(p, z);
+}
+
+/// Reads a little endian float of a binary STL file
+inline float stlFloat(const char * p)
+{
+    unsigned char b[4];
+    std::memcpy(b, p, 4);
+    const unsigned short one = 1;
+    if ( 0 == *reinterpret_cast<const unsigned char*>(&one) ) // big endian
+    {
+        std::swap(b[0], b[3]);
+        std::swap(b[1], b[2]);
+    }
+    float val;
+    std::memcpy(&val, b, 4);
+    return val;
+}
+
+/// Adds the vertex (x,y,z), reusing an existing vertex with these
+/// coordinates if \a map is given
+template<class T>
+typename gsMesh<T>::VertexHandle addStlVertex(gsMesh<T> & mesh, gsVertexHashMap<T> * map,
+                                              const T & x, const T & y, const T & z)
+{
+    typename gsMesh<T>::VertexHandle v = map ? map->find(x,y,z) : NULL;
+    if ( !v )
+    {
+        v = mesh.addVertex(x,y,z);
+        if ( map ) map->insert(v);
+    }
+    return v;
+}
+
+template<class T>
+bool readBinaryStl(std::istream & file, const size_t nTriangles, gsMesh<T> & mesh, bool merge)
+{
+    typedef typename gsMesh<T>::VertexHandle VertexHandle;
+
+    // Every triangle: normal, three vertices (float), attribute (uint16)
+    const size_t recSize = 50, chunk = 8192;
+
+    mesh.reserve(mesh.vertex.size() + (merge ? nTriangles / 2 + 3 : 3 * nTriangles),
+                 mesh.face.size() + nTriangles);
+    gsVertexHashMap<T> map(merge ? nTriangles / 2 : 0);
+
+    file.seekg(84);
+    std::vector<char> buf(chunk * recSize);
+    VertexHandle v[3];
+    for ( size_t first = 0; first < nTriangles; first += chunk )
+    {
+        const size_t n = std::min(chunk, nTriangles - first);
+        if ( !file.read(&buf[0], n * recSize) )
+            return false;
+        for ( size_t t = 0; t != n; ++t )
+        {
+            const char * rec = &buf[t * recSize] + 12; // skip the normal
+            for ( int k = 0; k != 3; ++k, rec += 12 )
+                v[k] = addStlVertex<T>(mesh, merge ? &map : NULL,
+                                       (T)stlFloat(rec), (T)stlFloat(rec + 4),
+                                       (T)stlFloat(rec + 8));
+            mesh.addFace(v[0], v[1], v[2]);
+        }
+    }
+    return true;
+}
+
+template<class T>
+bool readAsciiStl(std::istream & file, gsMesh<T> & mesh, bool merge)
+{
+    typedef typename gsMesh<T>::VertexHandle VertexHandle;
+
+    gsVertexHashMap<T> map;
+    std::vector<VertexHandle> loop;
+    gsLineReader lines(file);
+    char * line;
+    T x, y, z;
+    while ( lines.next(line) )
+    {
+        const char * p = skipSpace(line);
+        if ( readKeyword(p, "vertex") )
+        {
+            if ( !readPoint(p, x, y, z) )
+            {
+                gsWarn<< "gsReadMesh: invalid vertex in line "<< lines.lineNumber() <<".\n";
+                return false;
+            }
+            loop.push_back( addStlVertex<T>(mesh, merge ? &map : NULL, x, y, z) );
+        }
+        else if ( readKeyword(p, "endloop") )
+        {
+            if ( loop.size() == 3 )
+                mesh.addFace(loop[0], loop[1], loop[2]);
+            else if ( loop.size() > 3 )
+                mesh.addFace(loop);
+            loop.clear();
+        }
+        // solid, facet normal, outer loop, endfacet, endsolid: nothing to do
+    }
+    return true;
+}
+
+template<class T>
+bool readOffData(gsLineReader & lines, gsMesh<T> & mesh)
+{
+    typedef typename gsMesh<T>::VertexHandle VertexHandle;
+
+    // OFF, possibly with prefixes (COFF, NOFF, ...); the counts may
+    // follow on the same line
+    const char * p;
+    if ( !nextDataLine(lines, p) )
+        return false;
+    const char * key = std::strstr(p, "OFF");
+    if ( !key )
+        return false;
+    p = skipSpace(key + 3);
+    if ( ('\0' == *p || '#' == *p) && !nextDataLine(lines, p) )
+        return false;
+
+    long nv, nf;
+    if ( !readIndex(p, nv) || !readIndex(p, nf) || nv < 0 || nf < 0 )
+        return false;
+
+    const size_t offset = mesh.vertex.size();
+    mesh.reserve(offset + nv, mesh.face.size() + nf);
+
+    T x, y, z;
+    for ( long i = 0; i != nv; ++i )
+    {
+        if ( !nextDataLine(lines, p) || !readPoint(p, x, y, z) )
+            return false;
+        mesh.addVertex(x, y, z);
+    }
+
+    std::vector<VertexHandle> face;
+    long c, k;
+    for ( long i = 0; i != nf; ++i )
+    {
+        if ( !nextDataLine(lines, p) || !readIndex(p, c) || c < 3 )
+            return false;
+        face.resize(c);
+        for ( long j = 0; j != c; ++j )
+        {
+            if ( !readIndex(p, k) || k < 0 || k >= nv )
+                return false;
+            face[j] = mesh.vertex[offset + k];
+        }
+        // Colors following the indices are ignored
+        if ( 3 == c )
+            mesh.addFace(face[0], face[1], face[2]);
+        else
+            mesh.addFace(face);
+    }
+    return true;
+}
+
+template<class T>
+bool readObjData(gsLineReader & lines, gsMesh<T> & mesh)
+{
+    typedef typename gsMesh<T>::VertexHandle VertexHandle;
+
+    const long offset = static_cast<long>( mesh.vertex.size() );
+    std::vector<VertexHandle> face;
+    char * line;
+    T x, y, z;
+    long k;
+    while ( lines.next(line) )
+    {
+        const char * p = skipSpace(line);
+        if ( 'v' == p[0] && (' ' == p[1] || '\t' == p[1]) )
+        {
+            ++p;
+            if ( !readPoint(p, x, y, z) )
+                return false;
+            mesh.addVertex(x, y, z);
+        }
+        else if ( 'f' == p[0] && (' ' == p[1] || '\t' == p[1]) )
+        {
+            face.clear();
+            const long nv = static_cast<long>( mesh.vertex.size() ) - offset;
+            for ( p = skipSpace(p + 1); *p; p = skipSpace(p) )
+            {
+                // Vertex index, followed by /texture/normal indices;
+                // negative indices count from the last vertex
+                if ( !readIndex(p, k) )
+                    return false;
+                k = k < 0 ? nv + k : k - 1;
+                if ( k < 0 || k >= nv )
+                    return false;
+                face.push_back( mesh.vertex[offset + k] );
+                while ( *p && ' ' != *p && '\t' != *p )
+                    ++p;
+            }
+            if ( face.size() == 3 )
+                mesh.addFace(face[0], face[1], face[2]);
+            else if ( face.size() > 3 )
+                mesh.addFace(face);
+        }
+        // Other elements (normals, texture coordinates, groups,
+        // free-form geometry, ...) are ignored
+    }
+    return true;
+}
+
+} // namespace internal
+
+template<class T>
+bool gsReadStl(std::string const & fn, gsMesh<T> & mesh, bool merge)
+{
+    std::ifstream file(fn.c_str(), std::ios::in | std::ios::binary);
+    if ( !file.good() )
+    {
+        gsWarn<< "gsReadMesh: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    // A binary file has an 80 byte header, the number of triangles
+    // and 50 bytes per triangle. The header may start with "solid",
+    // hence the size decides.
+    file.seekg(0, std::ios::end);
+    const unsigned long long size = static_cast<unsigned long long>( file.tellg() );
+    file.seekg(0, std::ios::beg);
+
+    char head[84];
+    if ( size >= 84 && file.read(head, 84) )
+    {
+        unsigned char b[4];
+        std::memcpy(b, head + 80, 4);
+        const unsigned long long n = b[0] | (b[1] << 8) | (b[2] << 16)
+            | (static_cast<unsigned long long>(b[3]) << 24);
+        if ( 84 + 50 * n == size )
+            return internal::readBinaryStl(file, static_cast<size_t>(n), mesh, merge);
+    }
+
+    file.clear();
+    file.seekg(0, std::ios::beg);
+    return internal::readAsciiStl(file, mesh, merge);
+}
+
+template<class T>
+bool gsReadOff(std::string const & fn, gsMesh<T> & mesh)
+{
+    std::ifstream file(fn.c_str(), std::ios::in | std::ios::binary);
+    if ( !file.good() )
+    {
+        gsWarn<< "gsReadMesh: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    internal::gsLineReader lines(file);
+    if ( !internal::readOffData(lines, mesh) )
+    {
+        gsWarn<< "gsReadMesh: invalid OFF file "<< fn <<" (line "<< lines.lineNumber() <<").\n";
+        return false;
+    }
+    return true;
+}
+
+template<class T>
+bool gsReadObj(std::string const & fn, gsMesh<T> & mesh)
+{
+    std::ifstream file(fn.c_str(), std::ios::in | std::ios::binary);
+    if ( !file.good() )
+    {
+        gsWarn<< "gsReadMesh: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    internal::gsLineReader lines(file);
+    if ( !internal::readObjData(lines, mesh) )
+    {
+        gsWarn<< "gsReadMesh: invalid OBJ file "<< fn <<" (line "<< lines.lineNumber() <<").\n";
+        return false;
+    }
+    return true;
+}
+
+template<class T>
+bool gsReadMesh(std::string const & fn, gsMesh<T> & mesh, bool merge)
+{
+    std::string ext = fn.substr( fn.find_last_of('.') + 1 );
+    for ( std::string::iterator it = ext.begin(); it != ext.end(); ++it )
+        *it = static_cast<char>( std::tolower(*it) );
+
+    if ( ext == "stl" )
+        return gsReadStl(fn, mesh, merge);
+    if ( ext == "obj" )
+        return gsReadObj(fn, mesh);
+    if ( ext == "off" )
+        return gsReadOff(fn, mesh);
+
+    gsWarn<< "gsReadMesh: unknown mesh format \"."<< ext <<"\".\n";
+    return false;
+}
+
+} // namespace gismo
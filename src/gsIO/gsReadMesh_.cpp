@@ -0,0 +1,21 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsIO/gsReadMesh.h>
+#include <gsIO/gsReadMesh.hpp>
+
+namespace gismo
+{
+
+TEMPLATE_INST
+bool gsReadMesh(std::string const & fn, gsMesh<real_t> & mesh, bool merge);
+
+TEMPLATE_INST
+bool gsReadStl(std::string const & fn, gsMesh<real_t> & mesh, bool merge);
+
+TEMPLATE_INST
+bool gsReadObj(std::string const & fn, gsMesh<real_t> & mesh);
+
+TEMPLATE_INST
+bool gsReadOff(std::string const & fn, gsMesh<real_t> & mesh);
+
+}
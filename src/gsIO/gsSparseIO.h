@@ -0,0 +1,152 @@
+/** @file gsSparseIO.h
+
+    @brief Provides export and import of sparse matrices, vectors and
+    assembled systems in Matrix Market and in a binary format.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsCore/gsDofMapper.h>
+#include <gsIO/gsMappedFile.h>
+
+#include <string>
+#include <vector>
+
+namespace gismo {
+
+/// \brief Writes the sparse matrix \a mat to the Matrix Market file
+/// \a fn (coordinate format, real, general).
+///
+/// Matrix Market is a text format for interchange with other
+/// software; large systems are better stored with gsSparseSystemFile.
+/// \ingroup IO
+template<class T>
+bool gsWriteMatrixMarket(const gsSparseMatrix<T> & mat, const std::string & fn);
+
+/// \brief Writes the dense matrix (or vector) \a mat to the Matrix
+/// Market file \a fn (array format, real, general)
+/// \ingroup IO
+template<class T>
+bool gsWriteMatrixMarket(const gsMatrix<T> & mat, const std::string & fn);
+
+/// \brief Reads a Matrix Market file into the sparse matrix \a result.
+///
+/// Coordinate and array files with real, integer or pattern entries
+/// are read, symmetric and skew-symmetric files are expanded.
+/// Complex matrices are not supported.
+/// \ingroup IO
+template<class T>
+bool gsReadMatrixMarket(const std::string & fn, gsSparseMatrix<T> & result);
+
+/// \brief Reads a Matrix Market file into the dense matrix \a result
+/// (see gsReadMatrixMarket(const std::string &, gsSparseMatrix<T> &))
+/// \ingroup IO
+template<class T>
+bool gsReadMatrixMarket(const std::string & fn, gsMatrix<T> & result);
+
+/**
+   \brief Binary file holding an assembled system: a sparse matrix in
+   compressed (CSC) form, optionally a right-hand side and the DOF
+   mappers describing the unknowns.
+
+   The file consists of a header, the column pointers, the row
+   indices, the values, the right-hand side and the mappers, each
+   section aligned to 64 bytes and stored in the native byte order.
+
+   write() streams the arrays of the matrix to the file without
+   copying. open() maps the file into memory (see gsMappedFile):
+   matrix() and rhs() are views of the mapping, which are valid as
+   long as the file is open, and only the parts which are used are
+   read from disk.
+
+   \verbatim
+   gsSparseSystemFile<>::write("system.gsm", assembler.matrix(), assembler.rhs(),
+                               assembler.system().colMappers());
+   ...
+   gsSparseSystemFile<> file("system.gsm");
+   gsMatrix<> x = solver.compute(file.matrix()).solve(file.rhs());
+   \endverbatim
+
+   \ingroup IO
+*/
+template<class T>
+class gsSparseSystemFile
+{
+public:
+    typedef Eigen::MappedSparseMatrix<T, 0, index_t> MappedMatrix;
+
+public:
+
+    gsSparseSystemFile() : m_header(NULL) { }
+
+    /// Opens the file \a fn, see open()
+    explicit gsSparseSystemFile(const std::string & fn) : m_header(NULL)
+    { open(fn); }
+
+    /// \brief Writes the matrix \a mat, the right-hand side \a rhs
+    /// (may be empty) and the mappers \a mappers to the file \a fn
+    static bool write(const std::string & fn, const gsSparseMatrix<T> & mat,
+                      const gsMatrix<T> & rhs = gsMatrix<T>(),
+                      const std::vector<gsDofMapper> & mappers = std::vector<gsDofMapper>());
+
+    /// \brief Opens the file \a fn. Returns false if the file can not
+    /// be read, or was written with a different scalar or index type
+    bool open(const std::string & fn);
+
+    /// Closes the file, the views become invalid
+    void close() { m_file.close(); m_header = NULL; }
+
+    /// True if a file is open
+    bool isOpen() const { return NULL != m_header; }
+
+    index_t rows()     const;
+    index_t cols()     const;
+    index_t nonZeros() const;
+
+    /// Read-only view of the matrix in the file
+    MappedMatrix matrix() const;
+
+    /// Read-only view of the right-hand side (empty if none was written)
+    gsAsConstMatrix<T> rhs() const;
+
+    /// Number of DOF mappers in the file
+    size_t numMappers() const;
+
+    /// Reads the DOF mapper \a i into \a result
+    void getMapper(size_t i, gsDofMapper & result) const;
+
+private:
+
+    struct Header;
+
+    /// Returns the section \a k of the file: 1-3 the matrix arrays,
+    /// 4 the right-hand side, 5 + 3i to 7 + 3i the mapper i
+    template<class U> const U * section(size_t k) const
+    { return reinterpret_cast<const U*>(m_file.data() + m_sections[k]); }
+
+private:
+
+    gsMappedFile m_file;
+    const Header * m_header;
+
+    /// Positions of the sections in the file
+    std::vector<size_t> m_sections;
+
+private:
+    // Copying is not allowed
+    gsSparseSystemFile(const gsSparseSystemFile &);
+    gsSparseSystemFile & operator=(const gsSparseSystemFile &);
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSparseIO.hpp)
+#endif
@@ -0,0 +1,487 @@
+/** @file gsSparseIO.hpp
+
+    @brief Provides implementation of the Matrix Market and binary
+    export and import of sparse matrices and assembled systems.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsIO/gsSparseIO.h>
+#include <gsIO/gsXml.h>
+#include <gsIO/gsLineReader.h>
+
+#include <fstream>
+#include <cstring>
+
+namespace gismo {
+
+namespace internal {
+
+/// Writes the text \a out to \a file once it exceeds a few megabytes
+inline void flushText(std::ofstream & file, std::string & out, bool force = false)
+{
+    if ( force || out.size() > (1 << 22) )
+    {
+        file.write(out.data(), out.size());
+        out.clear();
+    }
+}
+
+inline void appendIndex(std::string & out, long val)
+{
+    char buf[24];
+    char * p = buf + sizeof(buf);
+    const bool neg = val < 0;
+    unsigned long u = neg ? -static_cast<unsigned long>(val) : val;
+    do { *--p = static_cast<char>('0' + u % 10); } while ( u /= 10 );
+    if ( neg ) *--p = '-';
+    out.append(p, buf + sizeof(buf));
+}
+
+/// Header line of a Matrix Market file
+struct mmHeader
+{
+    bool coordinate, pattern, symmetric, skew;
+};
+
+inline bool readMMHeader(gsLineReader & lines, mmHeader & h)
+{
+    char * line;
+    if ( !lines.next(line) )
+        return false;
+    for ( char * c = line; *c; ++c )
+        *c = static_cast<char>( std::tolower(static_cast<unsigned char>(*c)) );
+
+    char banner[32], object[32], format[32], field[32], symmetry[32];
+    if ( 5 != std::sscanf(line, "%31s %31s %31s %31s %31s",
+                          banner, object, format, field, symmetry)
+         || 0 != std::strcmp(banner, "%%matrixmarket")
+         || 0 != std::strcmp(object, "matrix") )
+    {
+        gsWarn<< "gsReadMatrixMarket: not a Matrix Market matrix file.\n";
+        return false;
+    }
+    h.coordinate = 0 == std::strcmp(format, "coordinate");
+    h.pattern    = 0 == std::strcmp(field, "pattern");
+    h.symmetric  = 0 == std::strcmp(symmetry, "symmetric");
+    h.skew       = 0 == std::strcmp(symmetry, "skew-symmetric");
+
+    if ( !h.coordinate && 0 != std::strcmp(format, "array") )
+    {
+        gsWarn<< "gsReadMatrixMarket: unknown format \""<< format <<"\".\n";
+        return false;
+    }
+    if ( 0 != std::strcmp(field, "real") && 0 != std::strcmp(field, "double")
+         && 0 != std::strcmp(field, "integer") && !(h.pattern && h.coordinate) )
+    {
+        gsWarn<< "gsReadMatrixMarket: "<< field <<" matrices are not supported.\n";
+        return false;
+    }
+    if ( !h.symmetric && !h.skew && 0 != std::strcmp(symmetry, "general") )
+    {
+        gsWarn<< "gsReadMatrixMarket: "<< symmetry <<" matrices are not supported.\n";
+        return false;
+    }
+    return true;
+}
+
+/// Reads the entries of a Matrix Market file (after the header) as triplets
+template<class T>
+bool readMMEntries(gsLineReader & lines, const mmHeader & h, index_t & rows,
+                   index_t & cols, gsSparseEntries<T> & entries)
+{
+    const char * p;
+    if ( !nextDataLine(lines, p) )
+        return false;
+    long r, c, nz = 0;
+    if ( !readIndex(p, r) || !readIndex(p, c) || r < 0 || c < 0 )
+        return false;
+    if ( h.coordinate && (!readIndex(p, nz) || nz < 0) )
+        return false;
+    rows = static_cast<index_t>(r);
+    cols = static_cast<index_t>(c);
+
+    // Arrays are stored column by column, the lower triangle only if
+    // (skew-)symmetric
+    if ( !h.coordinate )
+        nz = h.skew ? r * (r - 1) / 2 : h.symmetric ? r * (r + 1) / 2 : r * c;
+    long i = h.skew && !h.coordinate ? 1 : 0, j = 0;
+
+    entries.clear();
+    entries.reserve( (h.symmetric || h.skew) ? 2 * nz : nz );
+    T val = 1;
+    for ( long k = 0; k != nz; ++k )
+    {
+        if ( !nextDataLine(lines, p) )
+            return false;
+        if ( h.coordinate )
+        {
+            if ( !readIndex(p, i) || !readIndex(p, j) || i < 1 || i > r || j < 1 || j > c )
+                return false;
+            --i; --j;
+        }
+        if ( !h.pattern && !readValue(p, val) )
+            return false;
+
+        if ( 0 != val )
+        {
+            entries.add(static_cast<index_t>(i), static_cast<index_t>(j), val);
+            if ( i != j && h.symmetric )
+                entries.add(static_cast<index_t>(j), static_cast<index_t>(i), val);
+            else if ( i != j && h.skew )
+                entries.add(static_cast<index_t>(j), static_cast<index_t>(i), -val);
+        }
+
+        if ( !h.coordinate && ++i == r )
+        {
+            ++j;
+            i = h.skew ? j + 1 : h.symmetric ? j : 0;
+        }
+    }
+    return true;
+}
+
+template<class T>
+bool readMatrixMarket(const std::string & fn, index_t & rows, index_t & cols,
+                      gsSparseEntries<T> & entries)
+{
+    std::ifstream file(fn.c_str(), std::ios::in | std::ios::binary);
+    if ( !file.good() )
+    {
+        gsWarn<< "gsReadMatrixMarket: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    gsLineReader lines(file);
+    mmHeader h;
+    if ( !readMMHeader(lines, h) )
+        return false;
+    if ( !readMMEntries(lines, h, rows, cols, entries) )
+    {
+        gsWarn<< "gsReadMatrixMarket: invalid file "<< fn <<" (line "
+              << lines.lineNumber() <<").\n";
+        return false;
+    }
+    return true;
+}
+
+inline size_t alignSection(size_t pos) { return (pos + 63) & ~static_cast<size_t>(63); }
+
+/// Writes zeros up to the next multiple of 64 bytes
+inline void padSection(std::ostream & out, size_t & pos)
+{
+    static const char zeros[64] = {0};
+    const size_t next = alignSection(pos);
+    out.write(zeros, next - pos);
+    pos = next;
+}
+
+template<class U>
+void writeSection(std::ostream & out, size_t & pos, const U * data, size_t n)
+{
+    if ( n )
+        out.write(reinterpret_cast<const char*>(data), n * sizeof(U));
+    pos += n * sizeof(U);
+    padSection(out, pos);
+}
+
+} // namespace internal
+
+template<class T>
+bool gsWriteMatrixMarket(const gsSparseMatrix<T> & mat, const std::string & fn)
+{
+    std::ofstream file(fn.c_str(), std::ios::out | std::ios::binary);
+    if ( !file.good() )
+    {
+        gsWarn<< "gsWriteMatrixMarket: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    std::string out;
+    out.reserve( (1 << 22) + 128 );
+    out += "%%MatrixMarket matrix coordinate real general\n% Created by G+Smo\n";
+    internal::appendIndex(out, mat.rows());    out += ' ';
+    internal::appendIndex(out, mat.cols());    out += ' ';
+    internal::appendIndex(out, mat.nonZeros()); out += '\n';
+
+    for ( index_t k = 0; k < mat.outerSize(); ++k )
+        for ( typename gsSparseMatrix<T>::InnerIterator it(mat, k); it; ++it )
+        {
+            internal::appendIndex(out, it.row() + 1); out += ' ';
+            internal::appendIndex(out, it.col() + 1); out += ' ';
+            internal::appendValue(out, it.value());   out += '\n';
+            internal::flushText(file, out);
+        }
+    internal::flushText(file, out, true);
+    file.close();
+    return !file.fail();
+}
+
+template<class T>
+bool gsWriteMatrixMarket(const gsMatrix<T> & mat, const std::string & fn)
+{
+    std::ofstream file(fn.c_str(), std::ios::out | std::ios::binary);
+    if ( !file.good() )
+    {
+        gsWarn<< "gsWriteMatrixMarket: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    std::string out;
+    out.reserve( (1 << 22) + 128 );
+    out += "%%MatrixMarket matrix array real general\n% Created by G+Smo\n";
+    internal::appendIndex(out, mat.rows()); out += ' ';
+    internal::appendIndex(out, mat.cols()); out += '\n';
+
+    for ( index_t j = 0; j < mat.cols(); ++j )
+        for ( index_t i = 0; i < mat.rows(); ++i )
+        {
+            internal::appendValue(out, mat(i,j)); out += '\n';
+            internal::flushText(file, out);
+        }
+    internal::flushText(file, out, true);
+    file.close();
+    return !file.fail();
+}
+
+template<class T>
+bool gsReadMatrixMarket(const std::string & fn, gsSparseMatrix<T> & result)
+{
+    index_t rows, cols;
+    gsSparseEntries<T> entries;
+    if ( !internal::readMatrixMarket(fn, rows, cols, entries) )
+        return false;
+    result.resize(rows, cols);
+    result.setFrom(entries);
+    result.makeCompressed();
+    return true;
+}
+
+template<class T>
+bool gsReadMatrixMarket(const std::string & fn, gsMatrix<T> & result)
+{
+    index_t rows, cols;
+    gsSparseEntries<T> entries;
+    if ( !internal::readMatrixMarket(fn, rows, cols, entries) )
+        return false;
+    result.setZero(rows, cols);
+    for ( typename gsSparseEntries<T>::const_iterator it = entries.begin();
+          it != entries.end(); ++it )
+        result(it->row(), it->col()) += it->value();
+    return true;
+}
+
+/// File header, followed by the sections of the file
+template<class T>
+struct gsSparseSystemFile<T>::Header
+{
+    char     magic[8];
+    unsigned int version, flags, scalarSize, indexSize;
+    unsigned long long rows, cols, nnz, rhsCols, numMappers;
+
+    static const char * signature() { return "GSMOSPM"; }
+};
+
+template<class T>
+bool gsSparseSystemFile<T>::write(const std::string & fn, const gsSparseMatrix<T> & mat,
+                                  const gsMatrix<T> & rhs,
+                                  const std::vector<gsDofMapper> & mappers)
+{
+    GISMO_ASSERT( 0 == rhs.size() || rhs.rows() == mat.rows(),
+                  "The right-hand side does not match the matrix.");
+
+    // The arrays are written as they are; an uncompressed matrix is
+    // compressed in a copy
+    if ( !mat.isCompressed() )
+    {
+        gsSparseMatrix<T> tmp(mat);
+        tmp.makeCompressed();
+        return write(fn, tmp, rhs, mappers);
+    }
+
+    std::ofstream file(fn.c_str(), std::ios::out | std::ios::binary);
+    if ( !file.good() )
+    {
+        gsWarn<< "gsSparseSystemFile: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    Header h;
+    std::memset(&h, 0, sizeof(Header));
+    std::memcpy(h.magic, Header::signature(), 8);
+    h.version    = 1;
+    h.flags      = 0;
+    h.scalarSize = sizeof(T);
+    h.indexSize  = sizeof(index_t);
+    h.rows       = mat.rows();
+    h.cols       = mat.cols();
+    h.nnz        = mat.nonZeros();
+    h.rhsCols    = rhs.cols();
+    h.numMappers = mappers.size();
+
+    size_t pos = 0;
+    internal::writeSection(file, pos, &h, 1);
+    internal::writeSection(file, pos, mat.outerIndexPtr(), mat.outerSize() + 1);
+    internal::writeSection(file, pos, mat.innerIndexPtr(), mat.nonZeros());
+    internal::writeSection(file, pos, mat.valuePtr()     , mat.nonZeros());
+    internal::writeSection(file, pos, rhs.data()         , rhs.size());
+
+    std::vector<index_t> dofs;
+    std::vector<unsigned long long> offsets;
+    for ( size_t m = 0; m != mappers.size(); ++m )
+    {
+        const gsDofMapper & dm = mappers[m];
+        const unsigned long long info[8] = { dm.mapSize(), dm.numPatches(),
+                                   static_cast<unsigned long long>(dm.freeSize()),
+                                   static_cast<unsigned long long>(dm.coupledSize()),
+                                   static_cast<unsigned long long>(dm.boundarySize()),
+                                   static_cast<unsigned long long>(dm.shift()),
+                                   static_cast<unsigned long long>(dm.boundaryShift()), 0 };
+        offsets.resize(dm.numPatches());
+        for ( size_t k = 0; k != offsets.size(); ++k )
+            offsets[k] = dm.offset(k);
+        dofs.resize(dm.mapSize());
+        for ( size_t n = 0; n != dofs.size(); ++n )
+            dofs[n] = dm.mapIndex(n) - dm.shift();
+
+        internal::writeSection(file, pos, info, 8);
+        internal::writeSection(file, pos, offsets.empty() ? NULL : &offsets[0], offsets.size());
+        internal::writeSection(file, pos, dofs.empty()    ? NULL : &dofs[0]   , dofs.size());
+    }
+
+    file.close();
+    return !file.fail();
+}
+
+template<class T>
+bool gsSparseSystemFile<T>::open(const std::string & fn)
+{
+    close();
+    if ( !m_file.open(fn) )
+    {
+        gsWarn<< "gsSparseSystemFile: cannot open file "<< fn <<".\n";
+        return false;
+    }
+
+    const Header * h = reinterpret_cast<const Header*>(m_file.data());
+    if ( m_file.size() < sizeof(Header) || 0 != std::memcmp(h->magic, Header::signature(), 8)
+         || 1 != h->version )
+    {
+        gsWarn<< "gsSparseSystemFile: "<< fn <<" is not a sparse system file.\n";
+        m_file.close();
+        return false;
+    }
+    if ( sizeof(T) != h->scalarSize || sizeof(index_t) != h->indexSize )
+    {
+        gsWarn<< "gsSparseSystemFile: "<< fn <<" was written with "<< h->scalarSize
+              <<"-byte scalars and "<< h->indexSize <<"-byte indices.\n";
+        m_file.close();
+        return false;
+    }
+
+    // Locate the sections and check that they are in the file
+    const size_t size = m_file.size();
+    const size_t sizes[4] = { (h->cols + 1) * sizeof(index_t), h->nnz * sizeof(index_t),
+                              h->nnz * sizeof(T), h->rows * h->rhsCols * sizeof(T) };
+    m_sections.resize(5 + 3 * h->numMappers);
+    m_sections[0] = 0;
+    m_sections[1] = internal::alignSection(sizeof(Header));
+    for ( size_t k = 1; k != 5; ++k )
+        m_sections[k+1] = internal::alignSection(m_sections[k] + sizes[k-1]);
+    bool valid = m_sections[5] <= internal::alignSection(size);
+    for ( size_t k = 5; valid && k + 1 < m_sections.size(); k += 3 )
+    {
+        const unsigned long long * info =
+            reinterpret_cast<const unsigned long long*>(m_file.data() + m_sections[k]);
+        valid = m_sections[k] + 64 <= size;
+        if ( valid )
+        {
+            m_sections[k+1] = m_sections[k] + 64;
+            m_sections[k+2] = internal::alignSection(m_sections[k+1] + info[1] * sizeof(unsigned long long));
+            const size_t next = internal::alignSection(m_sections[k+2] + info[0] * sizeof(index_t));
+            if ( k + 3 < m_sections.size() )
+                m_sections[k+3] = next;
+            valid = next <= internal::alignSection(size);
+        }
+    }
+    if ( !valid )
+    {
+        gsWarn<< "gsSparseSystemFile: "<< fn <<" is truncated.\n";
+        close();
+        return false;
+    }
+    m_header = h;
+    return true;
+}
+
+template<class T>
+index_t gsSparseSystemFile<T>::rows() const
+{
+    GISMO_ASSERT(isOpen(), "No file is open.");
+    return static_cast<index_t>(m_header->rows);
+}
+
+template<class T>
+index_t gsSparseSystemFile<T>::cols() const
+{
+    GISMO_ASSERT(isOpen(), "No file is open.");
+    return static_cast<index_t>(m_header->cols);
+}
+
+template<class T>
+index_t gsSparseSystemFile<T>::nonZeros() const
+{
+    GISMO_ASSERT(isOpen(), "No file is open.");
+    return static_cast<index_t>(m_header->nnz);
+}
+
+template<class T>
+typename gsSparseSystemFile<T>::MappedMatrix gsSparseSystemFile<T>::matrix() const
+{
+    GISMO_ASSERT(isOpen(), "No file is open.");
+    // The mapped matrix is used read-only
+    return MappedMatrix(rows(), cols(), nonZeros(),
+                        const_cast<index_t*>(section<index_t>(1)),
+                        const_cast<index_t*>(section<index_t>(2)),
+                        const_cast<T*>      (section<T>      (3)) );
+}
+
+template<class T>
+gsAsConstMatrix<T> gsSparseSystemFile<T>::rhs() const
+{
+    GISMO_ASSERT(isOpen(), "No file is open.");
+    return gsAsConstMatrix<T>(section<T>(4),
+                              m_header->rhsCols ? rows() : 0,
+                              static_cast<index_t>(m_header->rhsCols));
+}
+
+template<class T>
+size_t gsSparseSystemFile<T>::numMappers() const
+{
+    GISMO_ASSERT(isOpen(), "No file is open.");
+    return static_cast<size_t>(m_header->numMappers);
+}
+
+template<class T>
+void gsSparseSystemFile<T>::getMapper(size_t i, gsDofMapper & result) const
+{
+    GISMO_ASSERT(i < numMappers(), "Invalid mapper index "<< i <<".");
+    const unsigned long long * info    = section<unsigned long long>(5 + 3 * i);
+    const unsigned long long * offsets = section<unsigned long long>(6 + 3 * i);
+    const index_t            * dofs    = section<index_t>(7 + 3 * i);
+
+    result.setMapping(std::vector<index_t>(dofs, dofs + info[0]),
+                      std::vector<std::size_t>(offsets, offsets + info[1]),
+                      static_cast<index_t>(info[2]), static_cast<index_t>(info[3]),
+                      static_cast<index_t>(info[4]));
+    result.setShift        ( static_cast<index_t>(info[5]) );
+    result.setBoundaryShift( static_cast<index_t>(info[6]) );
+}
+
+} // namespace gismo
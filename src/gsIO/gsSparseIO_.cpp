@@ -0,0 +1,23 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsIO/gsSparseIO.h>
+#include <gsIO/gsSparseIO.hpp>
+
+namespace gismo
+{
+
+TEMPLATE_INST
+bool gsWriteMatrixMarket(const gsSparseMatrix<real_t> & mat, const std::string & fn);
+
+TEMPLATE_INST
+bool gsWriteMatrixMarket(const gsMatrix<real_t> & mat, const std::string & fn);
+
+TEMPLATE_INST
+bool gsReadMatrixMarket(const std::string & fn, gsSparseMatrix<real_t> & result);
+
+TEMPLATE_INST
+bool gsReadMatrixMarket(const std::string & fn, gsMatrix<real_t> & result);
+
+CLASS_TEMPLATE_INST gsSparseSystemFile<real_t>;
+
+}
@@ -0,0 +1,176 @@
+/** @file gsVtkDataWriter.cpp
+
+    @brief Provides a helper class writing the data arrays of VTK XML
+    (Paraview) files in ascii, base64 or appended binary format.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsIO/gsVtkDataWriter.h>
+#include <gsIO/gsXml.h>
+
+#include <zlib/zlib.h>
+
+namespace gismo
+{
+
+namespace
+{
+
+// Uncompressed size of the blocks of compressed data (as used by VTK)
+const size_t s_blockSize = 32768;
+
+// The header entries of binary data
+typedef unsigned long long headerType;
+
+bool isLittleEndian()
+{
+    const unsigned short one = 1;
+    return 1 == *reinterpret_cast<const unsigned char*>(&one);
+}
+
+}
+
+gsVtkDataWriter::gsVtkDataWriter()
+: m_format(ascii), m_compress(false), m_float64(false)
+{ }
+
+gsVtkDataWriter::gsVtkDataWriter(const gsOptionList & opt)
+: m_format(formatFromString(opt.askString("Format", "ascii"))),
+  m_compress(opt.askSwitch("Compress", false)),
+  m_float64(opt.askSwitch("Float64", false))
+{ }
+
+gsVtkDataWriter::gsVtkDataWriter(format fmt, bool compress, bool float64)
+: m_format(fmt), m_compress(compress), m_float64(float64)
+{ }
+
+gsOptionList gsVtkDataWriter::defaultOptions()
+{
+    gsOptionList opt;
+    opt.addString("Format", "Encoding of the data arrays: ascii, base64 or appended", "ascii");
+    opt.addSwitch("Compress", "Compress binary data with zlib", false);
+    opt.addSwitch("Float64", "Write floating point data in double precision", false);
+    return opt;
+}
+
+gsVtkDataWriter::format gsVtkDataWriter::formatFromString(const std::string & str)
+{
+    if ( "ascii"    == str ) return ascii;
+    if ( "base64"   == str ) return base64;
+    if ( "appended" == str ) return appended;
+    GISMO_ERROR("Unknown VTK data format \""<< str <<"\", expected ascii, base64 or appended.");
+}
+
+std::string gsVtkDataWriter::fileAttributes() const
+{
+    // Version 1.0 is needed for the 64 bit headers
+    std::string res = isLittleEndian() ? "version=\"1.0\" byte_order=\"LittleEndian\""
+                                       : "version=\"1.0\" byte_order=\"BigEndian\"";
+    if ( isBinary() )
+    {
+        res += " header_type=\"UInt64\"";
+        if ( m_compress )
+            res += " compressor=\"vtkZLibDataCompressor\"";
+    }
+    return res;
+}
+
+void gsVtkDataWriter::intArray(std::ostream & out, const std::string & attributes,
+                               const std::vector<int> & data)
+{
+    if ( ascii == m_format )
+    {
+        out <<"<DataArray type=\"Int32\" "<< attributes <<" format=\"ascii\">\n";
+        for ( std::vector<int>::const_iterator it = data.begin(); it != data.end(); ++it )
+            out << *it <<" ";
+        out <<"\n</DataArray>\n";
+    }
+    else
+        binaryArray(out, "Int32", attributes,
+                    reinterpret_cast<const char*>(data.empty() ? NULL : &data[0]),
+                    data.size() * sizeof(int));
+}
+
+void gsVtkDataWriter::binaryArray(std::ostream & out, const char * type,
+                                  const std::string & attributes,
+                                  const char * data, size_t nbytes)
+{
+    // Header and (possibly compressed) data
+    std::vector<headerType> header;
+    std::vector<char> compressed;
+    const char * body = data;
+    size_t bodySize   = nbytes;
+
+    if ( m_compress )
+    {
+        // Header: number of blocks, block size, size of the last
+        // block, compressed size of every block
+        const size_t nBlocks = (nbytes + s_blockSize - 1) / s_blockSize;
+        header.resize(3 + nBlocks);
+        header[0] = nBlocks;
+        header[1] = s_blockSize;
+        header[2] = ( nBlocks && nbytes % s_blockSize ) ? nbytes % s_blockSize : s_blockSize;
+
+        compressed.resize( nBlocks * compressBound(s_blockSize) );
+        size_t pos = 0;
+        for ( size_t b = 0; b != nBlocks; ++b )
+        {
+            const size_t in = ( b + 1 == nBlocks ) ? nbytes - b * s_blockSize : s_blockSize;
+            uLongf csize = compressBound(in);
+            const int err = compress2(reinterpret_cast<Bytef*>(&compressed[pos]), &csize,
+                                      reinterpret_cast<const Bytef*>(data + b * s_blockSize),
+                                      in, Z_DEFAULT_COMPRESSION);
+            GISMO_ENSURE( Z_OK == err, "Compression of VTK data failed (zlib error "<< err <<")." );
+            header[3 + b] = csize;
+            pos += csize;
+        }
+        compressed.resize(pos);
+        body     = compressed.empty() ? NULL : &compressed[0];
+        bodySize = pos;
+    }
+    else
+        header.push_back(nbytes);
+
+    const char * hdr = reinterpret_cast<const char*>(&header[0]);
+    const size_t hdrSize = header.size() * sizeof(headerType);
+
+    out <<"<DataArray type=\""<< type <<"\" "<< attributes;
+    if ( base64 == m_format )
+    {
+        // Header and data are encoded separately
+        std::string enc;
+        encodeBase64(hdr, hdrSize, enc);
+        encodeBase64(body, bodySize, enc);
+        out <<" format=\"binary\">\n"<< enc <<"\n</DataArray>\n";
+    }
+    else // appended
+    {
+        out <<" format=\"appended\" offset=\""<< m_appended.size() <<"\"/>\n";
+        m_appended.insert(m_appended.end(), hdr, hdr + hdrSize);
+        if ( bodySize )
+            m_appended.insert(m_appended.end(), body, body + bodySize);
+    }
+}
+
+void gsVtkDataWriter::finish(std::ostream & out)
+{
+    if ( m_appended.empty() )
+        return;
+
+    out <<"<AppendedData encoding=\"raw\">\n_";
+    out.write(&m_appended[0], m_appended.size());
+    out <<"\n</AppendedData>\n";
+    m_appended.clear();
+}
+
+void gsVtkDataWriter::encodeBase64(const char * data, size_t n, std::string & result)
+{
+    internal::encodeBase64(data, n, result);
+}
+
+} // namespace gismo
@@ -0,0 +1,183 @@
+/** @file gsVtkDataWriter.h
+
+    @brief Provides a helper class writing the data arrays of VTK XML
+    (Paraview) files in ascii, base64 or appended binary format.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsCore/gsExport.h>
+#include <gsIO/gsOptionList.h>
+
+namespace gismo
+{
+
+/**
+    \brief Writes the \c DataArray elements of a VTK XML file.
+
+    Depending on the format, the data are written as text (ascii),
+    inline as base64 encoded binary (base64), or as raw binary blocks
+    in the \c AppendedData section at the end of the file (appended).
+    Binary data can be compressed with zlib, and floating point data
+    are stored either in single (Float32) or double (Float64)
+    precision.
+
+    Typical usage is
+    \verbatim
+    gsVtkDataWriter vtk(opt); // e.g. opt = gsVtkDataWriter::defaultOptions()
+    file <<"<VTKFile type=\"StructuredGrid\" "<< vtk.fileAttributes() <<">\n";
+    ...
+    vtk.floatArray(file, "NumberOfComponents=\"3\"", points);
+    ...
+    file <<"</StructuredGrid>\n";
+    vtk.finish(file); // writes the appended data (if any)
+    file <<"</VTKFile>\n";
+    \endverbatim
+
+    Binary formats require the file to be opened in binary mode.
+
+    The gsWriteParaview functions accept the options of the writers
+    (see defaultOptions()) as their last argument.
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsVtkDataWriter
+{
+public:
+
+    /// Encoding of the data arrays
+    enum format
+    {
+        ascii    = 0, ///< inline text
+        base64   = 1, ///< inline base64 encoded binary data
+        appended = 2  ///< raw binary data in the AppendedData section
+    };
+
+public:
+
+    /// Constructor using ascii, single precision data
+    gsVtkDataWriter();
+
+    /// Constructor using the format given by the options \a opt (see
+    /// defaultOptions())
+    explicit gsVtkDataWriter(const gsOptionList & opt);
+
+    /// Constructor
+    /// \param fmt      encoding of the data arrays
+    /// \param compress if true, binary data are compressed with zlib
+    /// \param float64  if true, floating point data are written in double precision
+    gsVtkDataWriter(format fmt, bool compress, bool float64);
+
+    /// \brief Returns the options choosing the format: \em Format
+    /// ("ascii", "base64" or "appended"), \em Compress and \em Float64
+    static gsOptionList defaultOptions();
+
+    /// Reads the format from a string ("ascii", "base64" or "appended")
+    static format formatFromString(const std::string & str);
+
+    /// Returns the attributes of the \c VTKFile element (version, byte
+    /// order, and header type and compressor for binary data)
+    std::string fileAttributes() const;
+
+    /// Type name of floating point arrays, "Float32" or "Float64"
+    const char * floatType() const { return m_float64 ? "Float64" : "Float32"; }
+
+    /// Returns true if the data arrays are written in binary form
+    bool isBinary() const { return ascii != m_format; }
+
+    /// \brief Writes a floating point data array of \a n values
+    ///
+    /// \param out        the output stream
+    /// \param attributes further attributes of the element, e.g. Name and NumberOfComponents
+    /// \param data       the values; components of one tuple are consecutive
+    /// \param n          number of values
+    template<class T>
+    void floatArray(std::ostream & out, const std::string & attributes,
+                    const T * data, size_t n);
+
+    /// \brief Writes the coefficients of \a data (column-wise) as a
+    /// floating point data array, i.e. every column is one tuple
+    template<class T>
+    void floatArray(std::ostream & out, const std::string & attributes,
+                    const gsMatrix<T> & data)
+    { floatArray(out, attributes, data.data(), static_cast<size_t>(data.size())); }
+
+    /// Writes an Int32 data array
+    void intArray(std::ostream & out, const std::string & attributes,
+                  const std::vector<int> & data);
+
+    /// \brief Writes the \c AppendedData section, if appended data
+    /// have been written. Call this after closing the data set
+    /// element, before closing the \c VTKFile element
+    void finish(std::ostream & out);
+
+    /// Appends the base64 encoding of \a n bytes at \a data to \a result
+    static void encodeBase64(const char * data, size_t n, std::string & result);
+
+private:
+
+    /// Writes the binary block of a data array, including its header
+    void binaryArray(std::ostream & out, const char * type,
+                     const std::string & attributes,
+                     const char * data, size_t nbytes);
+
+private:
+
+    format m_format;
+    bool   m_compress;
+    bool   m_float64;
+
+    /// Buffer for the appended data
+    std::vector<char> m_appended;
+};
+
+template<class T>
+void gsVtkDataWriter::floatArray(std::ostream & out, const std::string & attributes,
+                                 const T * data, size_t n)
+{
+    if ( ascii == m_format )
+    {
+        out <<"<DataArray type=\""<< floatType() <<"\" "<< attributes <<" format=\"ascii\">\n";
+        if ( m_float64 ) // keep all digits
+        {
+            const std::ios_base::fmtflags flags = out.flags();
+            const std::streamsize prec = out.precision(17);
+            out.unsetf(std::ios_base::floatfield);
+            for ( size_t i = 0; i != n; ++i )
+                out << data[i] <<" ";
+            out.flags(flags);
+            out.precision(prec);
+        }
+        else
+        {
+            for ( size_t i = 0; i != n; ++i )
+                out << data[i] <<" ";
+        }
+        out <<"\n</DataArray>\n";
+    }
+    else if ( m_float64 )
+    {
+        std::vector<double> buf(n);
+        for ( size_t i = 0; i != n; ++i )
+            buf[i] = static_cast<double>(data[i]);
+        binaryArray(out, "Float64", attributes, reinterpret_cast<const char*>(n ? &buf[0] : NULL),
+                    n * sizeof(double));
+    }
+    else
+    {
+        std::vector<float> buf(n);
+        for ( size_t i = 0; i != n; ++i )
+            buf[i] = static_cast<float>(data[i]);
+        binaryArray(out, "Float32", attributes, reinterpret_cast<const char*>(n ? &buf[0] : NULL),
+                    n * sizeof(float));
+    }
+}
+
+} // namespace gismo
@@ -38,6 +38,13 @@ template<class T>
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
                      unsigned npts=NS, bool mesh = false, bool ctrlNet = false);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
+                     unsigned npts, bool mesh, bool ctrlNet,
+                     const gsOptionList & vtkOpt);
+
 /// \brief Export a mesh to paraview file
 ///
 /// \param sl a gsMesh obect
@@ -46,6 +53,12 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 template <class T>
 void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     const gsOptionList & vtkOpt);
+
 /// \brief Export a vector of meshes, each mesh in its own file.
 ///
 /// \param meshes vector of gsMesh objects
@@ -64,6 +77,54 @@ template<class T>
 void gsWriteParaview(const gsField<T> & field, std::string const & fn, 
                      unsigned npts=NS, bool mesh = false);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview(const gsField<T> & field, std::string const & fn, 
+                     unsigned npts, bool mesh, const gsOptionList & vtkOpt);
+
+/// \brief Write a file containing a solution field (as color on its
+/// geometry) to paraview file, distributing the work over the
+/// processes of \a comm
+///
+/// Every process samples and writes the patches \a i with \a i mod
+/// comm.size() == comm.rank() to its own files; after all processes
+/// are done, process zero writes the collection (.pvd) file
+/// referencing all of them. Collective over \a comm. Within every
+/// process, the patches are written concurrently if OpenMP is enabled
+/// and the field is isogeometric, with a separate function per patch.
+///
+/// \param field a field object
+/// \param comm the communicator of the processes taking part
+/// \param fn filename where paraview file is written
+/// \param npts number of points used for sampling each patch
+/// \param mesh if true, the parameter mesh is plotted as well
+template<class T>
+void gsWriteParaview(const gsField<T> & field, gsMpiComm const & comm,
+                     std::string const & fn, unsigned npts=NS, bool mesh = false);
+
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview(const gsField<T> & field, gsMpiComm const & comm,
+                     std::string const & fn, unsigned npts, bool mesh,
+                     const gsOptionList & vtkOpt);
+
+/// \brief Write the geometry, and the field if present, at the
+/// sampling points chosen by \a sampler (see gsAdaptiveSampler) to
+/// paraview files: one structured grid per patch, collected in \a fn.pvd
+///
+/// \param sampler an adaptive sampler, after gsAdaptiveSampler::compute()
+/// \param fn filename where paraview file is written
+template<class T>
+void gsWriteParaview(const gsAdaptiveSampler<T> & sampler, std::string const & fn);
+
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview(const gsAdaptiveSampler<T> & sampler, std::string const & fn,
+                     const gsOptionList & vtkOpt);
+
 /// \brief Export a multipatch Geometry (without scalar information) to paraview file
 ///
 /// \param Geo a multipatch object
@@ -90,6 +151,24 @@ void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo,
                       std::string const & fn, unsigned npts=NS,
                       bool mesh = false, bool ctrlNet = false);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, 
+                      std::string const & fn, unsigned npts,
+                      bool mesh, bool ctrlNet, const gsOptionList & vtkOpt);
+
+/// \brief As gsWriteParaview(const gsMultiPatch<T>&, std::string const&,
+/// unsigned, bool, bool), the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview(const gsMultiPatch<T> & Geo, std::string const & fn, 
+                     unsigned npts, bool mesh, bool ctrlNet,
+                     const gsOptionList & vtkOpt)
+{
+    gsWriteParaview( Geo.patches(), fn, npts, mesh, ctrlNet, vtkOpt);
+}
+
 /// \brief Export a composite Geometry to paraview file
 ///
 /// \param Geo a composite geometry
@@ -112,6 +191,13 @@ template<class T>
 void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, 
                                std::string const & fn, unsigned npts =NS);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, 
+                               std::string const & fn, unsigned npts,
+                               const gsOptionList & vtkOpt);
+
 
 /// \brief Export a Geometry slice to paraview file
 ///
@@ -148,6 +234,12 @@ template<class T>
 void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn, 
                      unsigned npts =NS, bool mesh = false);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn, 
+                     unsigned npts, bool mesh, const gsOptionList & vtkOpt);
+
 
 /// \brief Export 2D Point set to Paraview file
 ///
@@ -159,6 +251,14 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
                            gsMatrix<T> const& Y, 
                            std::string const & fn);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaviewPoints(gsMatrix<T> const& X, 
+                           gsMatrix<T> const& Y, 
+                           std::string const & fn,
+                           const gsOptionList & vtkOpt);
+
 /// \brief Export 3D Point set to Paraview file
 ///
 /// \param X  1 times n matrix of values for x direction
@@ -171,6 +271,15 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
                            gsMatrix<T> const& Z,
                            std::string const & fn);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaviewPoints(gsMatrix<T> const& X,
+                           gsMatrix<T> const& Y,
+                           gsMatrix<T> const& Z,
+                           std::string const & fn,
+                           const gsOptionList & vtkOpt);
+
 /// \brief Export Point set to Paraview file
 ///
 /// \param points matrix that contain 2D or 3D points, points are columns
@@ -178,6 +287,12 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 template<class T>
 void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn);
 
+/// \brief As above, the VTK data is written as specified by the
+/// options \a vtkOpt (see gsVtkDataWriter::defaultOptions())
+template<class T>
+void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn,
+                           const gsOptionList & vtkOpt);
+
 
 /// \brief Depicting edge graph of each volume of one gsSolid with a segmenting loop
 ///
@@ -258,6 +373,15 @@ void writeSinglePatchField(const gsFunction<T> & geometry,
                            const bool isParam,
                            std::string const & fn, unsigned npts);
 
+// function to plot a field on a single patch, see gsVtkDataWriter
+// for the options vtkOpt
+template<class T>
+void writeSinglePatchField(const gsFunction<T> & geometry,
+                           const gsFunction<T> & parField,
+                           const bool isParam,
+                           std::string const & fn, unsigned npts,
+                           const gsOptionList & vtkOpt);
+
 // Please document
 template <class T>
 void plot_errors(const gsMatrix<T> & orig, 
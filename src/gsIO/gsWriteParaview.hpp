@@ -17,16 +17,22 @@
 #include <gsIO/gsWriteParaview.h>
 #include <gsIO/gsParaviewCollection.h>
 #include <gsIO/gsIOUtils.h>
+#include <gsIO/gsVtkDataWriter.h>
+#include <gsIO/gsAdaptiveSampler.h>
 
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsGeometrySlice.h>
 #include <gsCore/gsField.h>
 #include <gsCore/gsDebug.h>
 
+#include <gsMpi/gsMpi.h>
+
 #include <gsModeling/gsTrimSurface.h>
 #include <gsModeling/gsSolid.h>
 //#include <gsUtils/gsMesh/gsHeMesh.h>
 
+#include <set>
+
 
 #define PLOT_PRECISION 5
 
@@ -36,80 +42,65 @@ namespace gismo
 // Export a 3D parametric mesh
 template<class T>
 void writeSingleBasisMesh3D(const gsMesh<T> & sl,
-                            std::string const & fn)
+                            std::string const & fn, const gsOptionList & vtkOpt)
 {
     const unsigned numVer = sl.numVertices;
     const unsigned numEl  = numVer / 8;
     std::string mfn(fn);
     mfn.append(".vtu");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     if ( ! file.is_open() )
         std::cout<<"Problem opening "<<fn<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
     
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"UnstructuredGrid\" "<< vtk.fileAttributes() <<">\n";
     file <<"<UnstructuredGrid>\n";
     
     // Number of vertices and number of cells
     file <<"<Piece NumberOfPoints=\""<< numVer <<"\" NumberOfCells=\""<<numEl<<"\">\n";
     
     // Coordinates of vertices
-    file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin(); it!=sl.vertex.end(); ++it)
+    gsMatrix<T> coords(3, numVer), data(1, numVer);
+    for (unsigned i = 0; i!= numVer;++i)
     {
-        file << ((*it)->coords)[0] << " " << ((*it)->coords)[1] << " " << ((*it)->coords)[2] << " \n";
+        coords.col(i) = sl.vertex[i]->coords;
+        data(0,i)     = sl.vertex[i]->data;
     }
-    file << "\n";
-    file <<"</DataArray>\n";
+    file <<"<Points>\n";
+    vtk.floatArray(file, "NumberOfComponents=\"3\"", coords);
     file <<"</Points>\n";
 
     // Point data
     file <<"<PointData Scalars=\"CellVolume\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"CellVolume\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin(); it!=sl.vertex.end(); ++it)
-    {
-        file << (*it)->data <<" ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+    vtk.floatArray(file, "Name=\"CellVolume\" NumberOfComponents=\"1\"", data);
     file <<"</PointData>\n";
 
     // Cells
     file <<"<Cells>\n";
+    std::vector<int> cells(numVer);
 
     // Connectivity
-    file <<"<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
     for (unsigned i = 0; i!= numVer;++i)
-    {
-        file << i << " ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+        cells[i] = i;
+    vtk.intArray(file, "Name=\"connectivity\"", cells);
 
     // Offsets
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << 8*i << " ";
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    cells.resize(numEl);
+    for (unsigned i = 0; i!= numEl;++i)
+        cells[i] = 8*(i+1);
+    vtk.intArray(file, "Name=\"offsets\"", cells);
 
     // Type
-    file << "<DataArray type=\"Int32\" Name=\"types\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << "11 ";
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    std::fill(cells.begin(), cells.end(), 11);
+    vtk.intArray(file, "Name=\"types\"", cells);
 
     file <<"</Cells>\n";
     file << "</Piece>\n";
     file <<"</UnstructuredGrid>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
     
@@ -121,84 +112,67 @@ void writeSingleBasisMesh3D(const gsMesh<T> & sl,
 // 
 template<class T>
 void writeSingleBasisMesh2D(const gsMesh<T> & sl,
-                            std::string const & fn)
+                            std::string const & fn, const gsOptionList & vtkOpt)
 {
     const unsigned numVer = sl.numVertices;
     const unsigned numEl  = numVer / 4; //(1<<dim)
     std::string mfn(fn);
     mfn.append(".vtu");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     if ( ! file.is_open() )
         std::cout<<"Problem opening "<<fn<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
     
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"UnstructuredGrid\" "<< vtk.fileAttributes() <<">\n";
     file <<"<UnstructuredGrid>\n";
     
     // Number of vertices and number of cells
     file <<"<Piece NumberOfPoints=\""<< numVer <<"\" NumberOfCells=\""<<numEl<<"\">\n";
     
-    // Coordinates of vertices
-    file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin(); it!=sl.vertex.end(); it+=4)
+    // Coordinates of vertices, order is important!
+    static const unsigned order[4] = {0, 1, 3, 2};
+    gsMatrix<T> coords(3, numVer), data(1, numVer);
+    for (unsigned i = 0; i!= numVer;++i)
     {
-        // order is important!
-        file << ((*it)->coords)[0] << " " << ((*it)->coords)[1] << " " << ((*it)->coords)[2] << " \n";
-        file << ((*(it+1))->coords)[0] << " " << ((*(it+1))->coords)[1] << " " << ((*(it+1))->coords)[2] << " \n";
-        file << ((*(it+3))->coords)[0] << " " << ((*(it+3))->coords)[1] << " " << ((*(it+3))->coords)[2] << " \n";
-        file << ((*(it+2))->coords)[0] << " " << ((*(it+2))->coords)[1] << " " << ((*(it+2))->coords)[2] << " \n";
+        const gsVertex<T> & v = *sl.vertex[i - i%4 + order[i%4]];
+        coords.col(i) = v.coords;
+        data(0,i)     = v.data;
     }
-    file << "\n";
-    file <<"</DataArray>\n";
+    file <<"<Points>\n";
+    vtk.floatArray(file, "NumberOfComponents=\"3\"", coords);
     file <<"</Points>\n";
 
     // Point data
     file <<"<PointData Scalars=\"CellArea\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"CellVolume\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin(); it!=sl.vertex.end(); ++it)
-    {
-        file << (*it)->data <<" ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+    vtk.floatArray(file, "Name=\"CellVolume\" NumberOfComponents=\"1\"", data);
     file <<"</PointData>\n";
 
     // Cells
     file <<"<Cells>\n";
+    std::vector<int> cells(numVer);
 
     // Connectivity
-    file <<"<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
     for (unsigned i = 0; i!= numVer;++i)
-    {
-        file << i << " ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+        cells[i] = i;
+    vtk.intArray(file, "Name=\"connectivity\"", cells);
 
     // Offsets
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << 4*i << " "; //step: (1<<dim) 
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    cells.resize(numEl);
+    for (unsigned i = 0; i!= numEl;++i)
+        cells[i] = 4*(i+1); //step: (1<<dim) 
+    vtk.intArray(file, "Name=\"offsets\"", cells);
 
     // Type
-    file << "<DataArray type=\"Int32\" Name=\"types\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << "9 ";// 11: 3D, 9: 2D
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    std::fill(cells.begin(), cells.end(), 9); // 11: 3D, 9: 2D
+    vtk.intArray(file, "Name=\"types\"", cells);
 
     file <<"</Cells>\n";
     file << "</Piece>\n";
     file <<"</UnstructuredGrid>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
     
@@ -210,22 +184,23 @@ void writeSingleBasisMesh2D(const gsMesh<T> & sl,
 /// Export a parametric mesh
 template<class T>
 void writeSingleBasisMesh(const gsBasis<T> & basis,
-                         std::string const & fn)
+                         std::string const & fn, const gsOptionList & vtkOpt)
 {
     gsMesh<T> msh;
     makeMesh<T>(basis, msh);
     if ( basis.dim() == 3)
-        writeSingleBasisMesh3D(msh,fn);
+        writeSingleBasisMesh3D(msh,fn,vtkOpt);
     else if ( basis.dim() == 2)
-        writeSingleBasisMesh2D(msh,fn);
+        writeSingleBasisMesh2D(msh,fn,vtkOpt);
     else
-        gsWriteParaview(msh, fn, false);
+        gsWriteParaview(msh, fn, false, vtkOpt);
 }
 
 /// Export a computational mesh
 template<class T>
 void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo, 
-                         std::string const & fn, unsigned resolution = 8)
+                         std::string const & fn, unsigned resolution,
+                         const gsOptionList & vtkOpt)
 {
     gsMesh<T> msh;
     makeMesh<T>(basis, msh, resolution);
@@ -237,13 +212,13 @@ void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
     // else if ( basis.dim() == 2)
     //     writeSingleBasisMesh2D(msh,fn);
     // else
-        gsWriteParaview(msh, fn, false);
+        gsWriteParaview(msh, fn, false, vtkOpt);
 }
 
 /// Export a control net
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo, 
-                           std::string const & fn)
+                           std::string const & fn, const gsOptionList & vtkOpt)
 {
     const int d = Geo.parDim();
     gsMesh<T> msh;
@@ -261,27 +236,20 @@ void writeSingleControlNet(const gsGeometry<T> & Geo,
     }
 
 
-    gsWriteParaview(msh, fn, false);
+    gsWriteParaview(msh, fn, false, vtkOpt);
 }
 
+/// Writes the values \a eval_field at the points \a eval_geo of a
+/// structured grid with \a np points per direction to the file \a
+/// fn.vts (no point data if \a eval_field has no rows)
 template<class T>
-void writeSinglePatchField(const gsFunction<T> & geometry,
-                           const gsFunction<T> & parField,
-                           const bool isParam,
-                           std::string const & fn, unsigned npts)
+void writeStructuredField(gsMatrix<T> eval_geo, gsMatrix<T> eval_field,
+                          gsVector<unsigned> np, std::string const & fn,
+                          const gsOptionList & vtkOpt)
 {
-    const int n = geometry.targetDim();
-    const int d = geometry.domainDim();
-
-    gsMatrix<T> ab = geometry.support();
-    gsVector<T> a = ab.col(0);
-    gsVector<T> b = ab.col(1);
-
-    gsVector<unsigned> np = uniformSampleCount(a, b, npts);
-    gsMatrix<T> pts = gsPointGrid(a, b, np);
-
-    gsMatrix<T> eval_geo = geometry.eval(pts);//pts
-    gsMatrix<T>  eval_field = isParam ? parField.eval(pts) : parField.eval(eval_geo);
+    const int n = eval_geo.rows();
+    const int d = np.size();
+    const int m = eval_field.rows();
 
     if ( 3 - d > 0 )
     {
@@ -304,50 +272,80 @@ void writeSinglePatchField(const gsFunction<T> & geometry,
         gsWarn<< "Data is more than 3 dimensions.\n";
     }
 
-    //GISMO_ASSERT( eval_field.rows() == field.dim(), "Error in field dimension");
-    if ( eval_field.rows() > 1 )
+    if ( m > 1 && m < 3 )
     {
         eval_field.conservativeResize(3,eval_geo.cols() );
-        eval_field.bottomRows( 3-d ).setZero();
+        eval_field.bottomRows( 3-m ).setZero();
     }
     
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< vtk.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
-    file <<"<PointData "<< ( eval_field.rows()==1 ?"Scalars":"Vectors")<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<< eval_field.rows() <<"\">\n";
-    for ( index_t j=0; j<eval_field.cols(); ++j)
-        for ( index_t i=0; i<eval_field.rows(); ++i)
-            file<< eval_field(i,j) <<" ";
-    file <<"</DataArray>\n";
-    file <<"</PointData>\n";
+    if ( m > 0 )
+    {
+        file <<"<PointData "<< ( eval_field.rows()==1 ?"Scalars":"Vectors")<<"=\"SolutionField\">\n";
+        vtk.floatArray(file, "Name=\"SolutionField\" NumberOfComponents=\""
+                       + internal::toString(eval_field.rows()) +"\"", eval_field);
+        file <<"</PointData>\n";
+    }
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-        for ( index_t i=0; i<3; ++i)
-            file<< eval_geo(i,j) <<" ";
-    file <<"</DataArray>\n";
+    vtk.floatArray(file, "NumberOfComponents=\"3\"", eval_geo);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
 
     file.close();
 }
 
+template<class T>
+void writeSinglePatchField(const gsFunction<T> & geometry,
+                           const gsFunction<T> & parField,
+                           const bool isParam,
+                           std::string const & fn, unsigned npts)
+{
+    writeSinglePatchField(geometry, parField, isParam, fn, npts,
+                          gsVtkDataWriter::defaultOptions());
+}
+
+template<class T>
+void writeSinglePatchField(const gsFunction<T> & geometry,
+                           const gsFunction<T> & parField,
+                           const bool isParam,
+                           std::string const & fn, unsigned npts,
+                           const gsOptionList & vtkOpt)
+{
+    gsMatrix<T> ab = geometry.support();
+    gsVector<T> a = ab.col(0);
+    gsVector<T> b = ab.col(1);
+
+    gsVector<unsigned> np = uniformSampleCount(a, b, npts);
+    gsMatrix<T> pts = gsPointGrid(a, b, np);
+
+    gsMatrix<T> eval_geo = geometry.eval(pts);//pts
+    gsMatrix<T>  eval_field = isParam ? parField.eval(pts) : parField.eval(eval_geo);
+
+    //GISMO_ASSERT( eval_field.rows() == field.dim(), "Error in field dimension");
+    writeStructuredField(eval_geo, eval_field, np, fn, vtkOpt);
+}
+
 /// Write a file containing a solution field over a single geometry
 template<class T>
 void writeSinglePatchField(const gsField<T> & field, int patchNr, 
-                           std::string const & fn, unsigned npts)
+                           std::string const & fn, unsigned npts,
+                           const gsOptionList & vtkOpt)
 {
-    writeSinglePatchField(field.patch(patchNr), field.function(patchNr), field.isParametrized(), fn, npts);
+    writeSinglePatchField(field.patch(patchNr), field.function(patchNr), field.isParametrized(),
+                          fn, npts, vtkOpt);
 /*
     const int n = field.geoDim();
     const int d = field.parDim();
@@ -427,7 +425,8 @@ void writeSinglePatchField(const gsField<T> & field, int patchNr,
 template<class T>
 void writeSingleGeometry(gsFunction<T> const& func, 
                          gsMatrix<T> const& supp, 
-                         std::string const & fn, unsigned npts)
+                         std::string const & fn, unsigned npts,
+                         const gsOptionList & vtkOpt)
 {
     const int n = func.targetDim();
     const int d = func.domainDim();
@@ -465,32 +464,22 @@ void writeSingleGeometry(gsFunction<T> const& func,
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     if ( ! file.is_open() )
         std::cout<<"Problem opening "<<fn<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< vtk.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
-    // Add norm of the point as data
-    // file <<"<PointData Scalars =\"PointNorm\">\n";
-    // file <<"<DataArray type=\"Float32\" Name=\"PointNorm\" format=\"ascii\" NumberOfComponents=\""<< 1 <<"\">\n";
-    // for ( index_t j=0; j<eval_geo.cols(); ++j)
-    //     file<< eval_geo.col(j).norm() <<" ";
-    // file <<"</DataArray>\n";
-    // file <<"</PointData>\n";
-    // end norm
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<eval_func.rows()<<"\">\n";
-    for ( index_t j=0; j<eval_func.cols(); ++j)
-        for ( index_t i=0; i<eval_func.rows(); ++i)
-            file<< eval_func(i,j) <<" ";
-    file <<"</DataArray>\n";
+    vtk.floatArray(file, "NumberOfComponents=\""+ internal::toString(eval_func.rows()) +"\"", eval_func);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -499,7 +488,8 @@ void writeSingleGeometry(gsFunction<T> const& func,
 template<class T>
 void writeSingleCurve(gsFunction<T> const& func, 
                       gsMatrix<T> const& supp, 
-                      std::string const & fn, unsigned npts)
+                      std::string const & fn, unsigned npts,
+                      const gsOptionList & vtkOpt)
 {
     const unsigned n = func.targetDim();
     const unsigned d = func.domainDim();
@@ -530,59 +520,56 @@ void writeSingleCurve(gsFunction<T> const& func,
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     if ( ! file.is_open() )
         gsInfo<<"Problem opening "<<fn<<"\n";
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< vtk.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     // Accounting
     file <<"<Piece NumberOfPoints=\""<< npts
          <<"\" NumberOfVerts=\"0\" NumberOfLines=\""<< npts-1
          <<"\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<eval_func.rows()<<"\">\n";
-    for ( index_t j=0; j<eval_func.cols(); ++j)
-        for ( index_t i=0; i<eval_func.rows(); ++i)
-            file<< eval_func(i,j) <<" ";
-    file <<"\n</DataArray>\n";
+    vtk.floatArray(file, "NumberOfComponents=\""+ internal::toString(eval_func.rows()) +"\"", eval_func);
     file <<"</Points>\n";
     // Lines
     file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<npts-1<<"\">\n";
+    std::vector<int> cells(2*(npts-1));
     for (unsigned i=0; i< npts-1; ++i )
     {
-        file << i << " " << i+1 << " ";
+        cells[2*i  ] = i;
+        cells[2*i+1] = i+1;
     }
+    vtk.intArray(file, "Name=\"connectivity\"", cells);
     // offsets
-    file <<"\n</DataArray>\n";
-    unsigned offset(0);
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<npts-1<<"\">\n";
+    cells.resize(npts-1);
     for (unsigned i=0; i< npts-1; ++i )
-    {
-        offset +=2;
-        file << offset << " ";
-    }
-    file <<"\n</DataArray>\n";
+        cells[i] = 2*(i+1);
+    vtk.intArray(file, "Name=\"offsets\"", cells);
     file <<"</Lines>\n";
     // Closing 
     file <<"</Piece>\n";
     file <<"</PolyData>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
 
 template<class T>
-void writeSingleCurve(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts)
+void writeSingleCurve(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts,
+                      const gsOptionList & vtkOpt)
 {
     gsMatrix<T> ab = Geo.parameterRange();
-    writeSingleCurve( Geo, ab, fn, npts);
+    writeSingleCurve( Geo, ab, fn, npts, vtkOpt);
 }
 
 template<class T>
-void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts)
+void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts,
+                         const gsOptionList & vtkOpt)
 {
     /*
       gsMesh<T> msh;
@@ -591,7 +578,7 @@ void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsi
       return;
     //*/
     gsMatrix<T> ab = Geo.parameterRange();
-    writeSingleGeometry( Geo, ab, fn, npts);
+    writeSingleGeometry( Geo, ab, fn, npts, vtkOpt);
 }
 
 template<class T>
@@ -604,11 +591,48 @@ void writeSingleTrimSurface(const gsTrimSurface<T> & surf,
     delete msh;
 }
 
-/// Write a file containing a solution field over a geometry
+namespace internal
+{
+
+/// \brief True if the patches of \a field can be sampled
+/// concurrently: every patch and every field function is a separate
+/// isogeometric function. Other functions may keep evaluation state
+/// (e.g. gsFunctionExpr) or be shared by all patches.
 template<class T>
-void gsWriteParaview(const gsField<T> & field, 
-                     std::string const & fn, 
-                     unsigned npts, bool mesh)
+bool concurrentPatches(const gsField<T> & field)
+{
+    if ( !field.isParametrized() )
+        return false;
+    std::set<const void *> seen;
+    for ( int i = 0; i != field.nPatches(); ++i )
+    {
+        const gsFunction<T> & f = field.function(i);
+        if ( !dynamic_cast<const gsGeometry<T> *>(&f) ||
+             !seen.insert(&f).second || !seen.insert(&field.patch(i)).second )
+            return false;
+    }
+    return true;
+}
+
+/// True if the geometries \a geo are separate objects
+template<class T>
+bool concurrentPatches(const std::vector<gsGeometry<T> *> & geo)
+{
+    std::set<const void *> seen(geo.begin(), geo.end());
+    return seen.size() == geo.size();
+}
+
+} // namespace internal
+
+/// Writes the patches \a i of \a field with \a i mod \a nProcs ==
+/// \a rank, concurrently if OpenMP is enabled and the patches allow
+/// it (see internal::concurrentPatches).
+template<class T>
+void writeFieldPatches(const gsField<T> & field, 
+                       std::string const & fn, 
+                       unsigned npts, bool mesh,
+                       const int rank, const int nProcs,
+                       const gsOptionList & vtkOpt)
 {
     if (mesh && (!field.isParametrized()) )
     {
@@ -616,32 +640,135 @@ void gsWriteParaview(const gsField<T> & field,
         mesh = false;
     }
 
-    const unsigned n = field.nPatches();
-    gsParaviewCollection collection(fn);
+    const index_t n = field.nPatches();
+    const bool concurrent = internal::concurrentPatches(field);
+    GISMO_UNUSED(concurrent);
 
-    for ( unsigned i=0; i < n; ++i )
+    // The patches are sampled and written independently
+#   pragma omp parallel for schedule(dynamic) if(concurrent)
+    for ( index_t i = rank; i < n; i += nProcs )
     {
-        std::string fileName = fn + internal::toString<unsigned>(i);
-        writeSinglePatchField( field, i, fileName, npts );
-        collection.addPart(fileName, ".vts");
+        const std::string fileName = fn + internal::toString<index_t>(i);
+        writeSinglePatchField( field, i, fileName, npts, vtkOpt );
         if ( mesh ) 
-        {
-            fileName+= "_mesh";
             writeSingleCompMesh(field.igaFunction(i).basis(), 
-                                field.patch(i), fileName);
-
-            collection.addPart(fileName, ".vtp");
-        }
+                                field.patch(i), fileName + "_mesh", 8, vtkOpt);
+    }
+}
 
+/// Writes the collection file referencing the pieces written by
+/// writeFieldPatches
+template<class T>
+void writeFieldCollection(const gsField<T> & field, 
+                          std::string const & fn, bool mesh)
+{
+    mesh = mesh && field.isParametrized();
+    const index_t n = field.nPatches();
+    gsParaviewCollection collection(fn);
+    for ( index_t i=0; i < n; ++i )
+    {
+        const std::string fileName = fn + internal::toString<index_t>(i);
+        collection.addPart(fileName, ".vts");
+        if ( mesh ) 
+            collection.addPart(fileName + "_mesh", ".vtp");
     }
     collection.save();
 }
 
+/// Write a file containing a solution field over a geometry
+template<class T>
+void gsWriteParaview(const gsField<T> & field, 
+                     std::string const & fn, 
+                     unsigned npts, bool mesh)
+{
+    gsWriteParaview(field, fn, npts, mesh, gsVtkDataWriter::defaultOptions());
+}
+
+/// Write a file containing a solution field over a geometry
+template<class T>
+void gsWriteParaview(const gsField<T> & field, 
+                     std::string const & fn, 
+                     unsigned npts, bool mesh,
+                     const gsOptionList & vtkOpt)
+{
+    writeFieldPatches(field, fn, npts, mesh, 0, 1, vtkOpt);
+    writeFieldCollection(field, fn, mesh);
+}
+
+/// Write a file containing a solution field over a geometry, the
+/// patches are distributed over the processes of \a comm
+template<class T>
+void gsWriteParaview(const gsField<T> & field, 
+                     gsMpiComm const & comm,
+                     std::string const & fn, 
+                     unsigned npts, bool mesh)
+{
+    gsWriteParaview(field, comm, fn, npts, mesh, gsVtkDataWriter::defaultOptions());
+}
+
+/// Write a file containing a solution field over a geometry, the
+/// patches are distributed over the processes of \a comm
+template<class T>
+void gsWriteParaview(const gsField<T> & field, 
+                     gsMpiComm const & comm,
+                     std::string const & fn, 
+                     unsigned npts, bool mesh,
+                     const gsOptionList & vtkOpt)
+{
+    writeFieldPatches(field, fn, npts, mesh, comm.rank(), comm.size(), vtkOpt);
+
+    // The collection is written when all pieces exist
+    comm.barrier();
+    if ( 0 == comm.rank() )
+        writeFieldCollection(field, fn, mesh);
+}
+
+
+/// Write the geometry and field of \a sampler at its adaptive sampling points
+template<class T>
+void gsWriteParaview(const gsAdaptiveSampler<T> & sampler, std::string const & fn)
+{
+    gsWriteParaview(sampler, fn, gsVtkDataWriter::defaultOptions());
+}
+
+/// Write the geometry and field of \a sampler at its adaptive sampling points
+template<class T>
+void gsWriteParaview(const gsAdaptiveSampler<T> & sampler, std::string const & fn,
+                     const gsOptionList & vtkOpt)
+{
+    const index_t n = sampler.nPatches();
+    const bool concurrent = sampler.concurrentEvaluation();
+    GISMO_UNUSED(concurrent);
+
+    // The patches are evaluated and written independently
+#   pragma omp parallel for schedule(dynamic) if(concurrent)
+    for ( index_t i = 0; i < n; ++i )
+    {
+        gsMatrix<T> eval_geo, eval_field;
+        sampler.evaluate(i, eval_geo, eval_field);
+        writeStructuredField(eval_geo, eval_field, sampler.gridSize(i),
+                             fn + internal::toString<index_t>(i), vtkOpt);
+    }
+
+    gsParaviewCollection collection(fn);
+    for ( index_t i=0; i < n; ++i )
+        collection.addPart(fn + internal::toString<index_t>(i), ".vts");
+    collection.save();
+}
 
 /// Export a Geometry without scalar information
 template<class T>
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
                      unsigned npts, bool mesh, bool ctrlNet)
+{
+    gsWriteParaview(Geo, fn, npts, mesh, ctrlNet, gsVtkDataWriter::defaultOptions());
+}
+
+/// Export a Geometry without scalar information
+template<class T>
+void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
+                     unsigned npts, bool mesh, bool ctrlNet,
+                     const gsOptionList & vtkOpt)
 {
     const bool curve = ( Geo.domainDim() == 1 );
 
@@ -649,26 +776,26 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 
     if ( curve )
     {
-        writeSingleCurve(Geo, fn, npts);
+        writeSingleCurve(Geo, fn, npts, vtkOpt);
         collection.addPart(fn, ".vtp");
     }
     else
     {
-        writeSingleGeometry(Geo, fn, npts);
+        writeSingleGeometry(Geo, fn, npts, vtkOpt);
         collection.addPart(fn, ".vts");
     }
 
     if ( mesh ) // Output the underlying mesh
     {
         const std::string fileName = fn + "_mesh";
-        writeSingleCompMesh(Geo.basis(), Geo, fileName, npts);
+        writeSingleCompMesh(Geo.basis(), Geo, fileName, npts, vtkOpt);
         collection.addPart(fileName, ".vtp");
     }
 
     if ( ctrlNet ) // Output the control net
     {
         const std::string fileName = fn + "_cnet";
-        writeSingleControlNet(Geo, fileName);
+        writeSingleControlNet(Geo, fileName, vtkOpt);
         collection.addPart(fileName, ".vtp");
     }
 
@@ -683,7 +810,7 @@ void gsWriteParaview(const gsGeometrySlice<T> & Geo,
                      unsigned npts)
 {
     const gsMatrix<T> supp = Geo.parameterRange();
-    writeSingleGeometry(Geo, supp, fn, npts);
+    writeSingleGeometry(Geo, supp, fn, npts, gsVtkDataWriter::defaultOptions());
     // Write out a pvd file
     makeCollection(fn, ".vts"); // make also a pvd file
 }
@@ -694,38 +821,46 @@ template<class T>
 void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, std::string const & fn, 
                       unsigned npts, bool mesh, bool ctrlNet)
 {
-    const size_t n = Geo.size();
+    gsWriteParaview(Geo, fn, npts, mesh, ctrlNet, gsVtkDataWriter::defaultOptions());
+}
 
-    gsParaviewCollection collection(fn);
+/// Export a multipatch Geometry without scalar information
+template<class T>
+void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, std::string const & fn, 
+                      unsigned npts, bool mesh, bool ctrlNet,
+                      const gsOptionList & vtkOpt)
+{
+    const index_t n = Geo.size();
+    const bool concurrent = internal::concurrentPatches(Geo);
+    GISMO_UNUSED(concurrent);
 
-    for ( size_t i=0; i<n ; i++)
+    // The patches are sampled and written independently
+#   pragma omp parallel for schedule(dynamic) if(concurrent)
+    for ( index_t i=0; i<n ; i++)
     {
-        std::string fnBase = fn + internal::toString<index_t>(i);
+        const std::string fnBase = fn + internal::toString<index_t>(i);
         
-        if ( Geo.at(i)->domainDim() == 1 )
-        {
-            writeSingleCurve(*Geo[i], fnBase, npts);
-            collection.addPart(fnBase, ".vtp");
-        }
+        if ( Geo[i]->domainDim() == 1 )
+            writeSingleCurve(*Geo[i], fnBase, npts, vtkOpt);
         else
-        {
-            writeSingleGeometry( *Geo[i], fnBase, npts ) ;
-            collection.addPart(fnBase, ".vts");
-        }
+            writeSingleGeometry( *Geo[i], fnBase, npts, vtkOpt ) ;
         
         if ( mesh ) 
-        {
-            const std::string fileName = fnBase + "_mesh";
-            writeSingleCompMesh(Geo[i]->basis(), *Geo[i], fileName);
-            collection.addPart(fileName, ".vtp");
-        }
+            writeSingleCompMesh(Geo[i]->basis(), *Geo[i], fnBase + "_mesh", 8, vtkOpt);
         
         if ( ctrlNet ) // Output the control net
-        {
-            const std::string fileName = fnBase + "_cnet";
-            writeSingleControlNet(*Geo[i], fileName);
-            collection.addPart(fileName, ".vtp");
-        }
+            writeSingleControlNet(*Geo[i], fnBase + "_cnet", vtkOpt);
+    }
+
+    gsParaviewCollection collection(fn);
+    for ( index_t i=0; i<n ; i++)
+    {
+        const std::string fnBase = fn + internal::toString<index_t>(i);
+        collection.addPart(fnBase, Geo[i]->domainDim() == 1 ? ".vtp" : ".vts");
+        if ( mesh ) 
+            collection.addPart(fnBase + "_mesh", ".vtp");
+        if ( ctrlNet )
+            collection.addPart(fnBase + "_cnet", ".vtp");
     }
     collection.save();
 }
@@ -733,6 +868,14 @@ void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, std::string cons
 /// Export i-th Basis function
 template<class T>
 void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, std::string const & fn, unsigned npts)
+{
+    gsWriteParaview_basisFnct(i, basis, fn, npts, gsVtkDataWriter::defaultOptions());
+}
+
+/// Export i-th Basis function
+template<class T>
+void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, std::string const & fn, unsigned npts,
+                               const gsOptionList & vtkOpt)
 {
     // basis.support(i) --> returns a (tight) bounding box for the
     // supp. of i-th basis func.
@@ -772,39 +915,36 @@ void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, std::string const
         eval_geo.bottomRows(3-n).setZero();
     }
 
+    // Points: the graph of the basis function
+    gsMatrix<T> coords(3, eval_geo.cols());
+    coords.topRows(d)      = pts.topRows(d);
+    coords.row(d)          = eval_geo.row(0);
+    coords.bottomRows(2-d) = pts.bottomRows(2-d);
+
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     if ( ! file.is_open() )
         std::cout<<"Problem opening "<<fn<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< vtk.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     // Scalar information
     file <<"<PointData "<< "Scalars"<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<<1<<"\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-            file<< eval_geo(0,j) <<" ";
-    file <<"</DataArray>\n";
+    const gsMatrix<T> values = eval_geo.row(0);
+    vtk.floatArray(file, "Name=\"SolutionField\" NumberOfComponents=\"1\"", values);
     file <<"</PointData>\n";
     //
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<3<<"\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-    {
-        for ( int l=0; l!=d; ++l)
-            file<< pts(l,j) <<" ";
-        file<< eval_geo(0,j) <<" ";
-         for ( index_t l=d; l!=pts.rows(); ++l)
-             file<< pts(l,j) <<" ";
-    }
-    file <<"</DataArray>\n";
+    vtk.floatArray(file, "NumberOfComponents=\"3\"", coords);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -816,6 +956,7 @@ void gsWriteParaview(gsFunction<T> const& func, gsMatrix<T> const& supp, std::st
 {
     int d = func.domainDim(); // tested for d==2
     //int n= d+1;
+    GISMO_ASSERT( d <= 2, "Function plot is implemented for domain dimension up to 2.");
 
     gsVector<T> a = supp.col(0);
     gsVector<T> b = supp.col(1);
@@ -831,39 +972,35 @@ void gsWriteParaview(gsFunction<T> const& func, gsMatrix<T> const& supp, std::st
         np.bottomRows(3-d).setOnes();
     }
 
+    // Points: the graph of the function
+    gsMatrix<T> coords = gsMatrix<T>::Zero(3, ev.cols());
+    coords.topRows(d) = pts;
+    coords.row(d)     = ev.row(0);
+
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     if ( ! file.is_open() )
         std::cout<<"Problem opening "<<fn<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk;
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< vtk.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     // Scalar information
     file <<"<PointData "<< "Scalars"<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<<1<<"\">\n";
-    for ( index_t j=0; j<ev.cols(); ++j)
-            file<< ev(0,j) <<" ";
-    file <<"</DataArray>\n";
+    const gsMatrix<T> values = ev.row(0);
+    vtk.floatArray(file, "Name=\"SolutionField\" NumberOfComponents=\"1\"", values);
     file <<"</PointData>\n";
     //
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<3<<"\">\n";
-    for ( index_t j=0; j<ev.cols(); ++j)
-    {
-        for ( int i=0; i< d; ++i)
-            file<< pts(i,j) <<" ";
-        file<< ev(0,j) <<" ";
-//         for ( index_t i=d; i< pts.rows(); ++i)
-//             file<< pts(i,j) <<" ";
-    }
-    file <<"</DataArray>\n";
+    vtk.floatArray(file, "NumberOfComponents=\"3\"", coords);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -873,6 +1010,14 @@ void gsWriteParaview(gsFunction<T> const& func, gsMatrix<T> const& supp, std::st
 template<class T>
 void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn, 
                      unsigned npts, bool mesh)
+{
+    gsWriteParaview(basis, fn, npts, mesh, gsVtkDataWriter::defaultOptions());
+}
+
+/// Export Basis functions
+template<class T>
+void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn, 
+                     unsigned npts, bool mesh, const gsOptionList & vtkOpt)
 {
     const index_t n = basis.size();
     gsParaviewCollection collection(fn);
@@ -880,14 +1025,14 @@ void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn,
     for ( index_t i=0; i< n; i++)
     {
         std::string fileName = fn + internal::toString<index_t>(i);
-        gsWriteParaview_basisFnct<T>(i, basis, fileName, npts ) ;
+        gsWriteParaview_basisFnct<T>(i, basis, fileName, npts, vtkOpt ) ;
         collection.addPart(fileName, ".vts");
     }
 
     if ( mesh )
     {
         std::string fileName = fn + "_mesh";
-        writeSingleBasisMesh(basis, fileName);
+        writeSingleBasisMesh(basis, fileName, vtkOpt);
         //collection.addPart(fileName, ".vtp");
         collection.addPart(fileName, ".vtu");
     }
@@ -899,64 +1044,17 @@ void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn,
 /// Export Point set to Paraview
 template<class T>
 void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn)
+{
+    gsWriteParaviewPoints<T>(X, Y, fn, gsVtkDataWriter::defaultOptions());
+}
+
+template<class T>
+void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn,
+                           const gsOptionList & vtkOpt)
 {
     assert( X.cols() == Y.cols() );
     assert( X.rows() == 1 && Y.rows() == 1 );
-    index_t np = X.cols();
-
-    std::string mfn(fn);
-    mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
-    if ( ! file.is_open() )
-        std::cout<<"Problem opening "<<fn<<std::endl;
-    file << std::fixed; // no exponents
-    file << std::setprecision (PLOT_PRECISION);
-    file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
-    file <<"<PolyData>\n";
-    file <<"<Piece NumberOfPoints=\""<<np<<"\" NumberOfVerts=\"1\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
-    file <<"<PointData>\n";
-    file <<"</PointData>\n";
-    file <<"<CellData>\n";
-    file <<"</CellData>\n";
-    file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\" format=\"ascii\" RangeMin=\""<<X.minCoeff()<<"\" RangeMax=\""<<X.maxCoeff()<<"\">\n";
-    for (index_t i=0; i< np; ++i )
-        file << X(0,i) <<" "<<Y(0,i)<<" "<< 0.0 <<"\n";
-    file <<"\n</DataArray>\n";
-    file <<"</Points>\n";
-    file <<"<Verts>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\""<<0<<"\" RangeMax=\""<<np-1<<"\">\n";
-    for (index_t i=0; i< np; ++i )
-        file << i<<" ";
-    file <<"\n</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n"<<np<<"\n";
-    file <<"</DataArray>\n";
-    file <<"</Verts>\n";
-    file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"</Lines>\n";
-    file <<"<Strips>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"</Strips>\n";
-    file <<"<Polys>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"</Polys>\n";
-    file <<"</Piece>\n";
-    file <<"</PolyData>\n";
-    file <<"</VTKFile>\n";
-    file.close();
-
-    makeCollection(fn, ".vtp"); // make also a pvd file
+    gsWriteParaviewPoints<T>(X, Y, gsMatrix<T>::Zero(1, X.cols()), fn, vtkOpt);
 }
 
 template<class T>
@@ -964,6 +1062,16 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
                            gsMatrix<T> const& Y,
                            gsMatrix<T> const& Z,
                            std::string const & fn)
+{
+    gsWriteParaviewPoints<T>(X, Y, Z, fn, gsVtkDataWriter::defaultOptions());
+}
+
+template<class T>
+void gsWriteParaviewPoints(gsMatrix<T> const& X,
+                           gsMatrix<T> const& Y,
+                           gsMatrix<T> const& Z,
+                           std::string const & fn,
+                           const gsOptionList & vtkOpt)
 {
     GISMO_ASSERT(X.cols() == Y.cols() && X.cols() == Z.cols(),
                  "X, Y and Z must have the same size of columns!");
@@ -973,7 +1081,7 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
 
     if (!file.is_open())
     {
@@ -983,9 +1091,10 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< vtk.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     file <<"<Piece NumberOfPoints=\""<<np<<"\" NumberOfVerts=\"1\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
     file <<"<PointData>\n";
@@ -993,47 +1102,25 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
     file <<"<CellData>\n";
     file <<"</CellData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\" format=\"ascii\" RangeMin=\""<<X.minCoeff()<<"\" RangeMax=\""<<X.maxCoeff()<<"\">\n";
-
-    for (index_t i = 0; i < np; ++i)
-    {
-        file << X(0, i) << " " << Y(0, i) << " " << Z(0, i) << "\n";
-    }
-
-    file <<"\n</DataArray>\n";
+    gsMatrix<T> coords(3, np);
+    coords.row(0) = X;
+    coords.row(1) = Y;
+    coords.row(2) = Z;
+    vtk.floatArray(file, "Name=\"Points\" NumberOfComponents=\"3\"", coords);
     file <<"</Points>\n";
-    file <<"<Verts>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\""<<0<<"\" RangeMax=\""<<np-1<<"\">\n";
 
+    // All points form one poly-vertex cell
+    file <<"<Verts>\n";
+    std::vector<int> cells(np);
     for (index_t i=0; i< np; ++i )
-    {
-        file << i << " ";
-    }
-
-    file <<"\n</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n"<<np<<"\n";
-    file <<"</DataArray>\n";
+        cells[i] = i;
+    vtk.intArray(file, "Name=\"connectivity\"", cells);
+    cells.assign(1, np);
+    vtk.intArray(file, "Name=\"offsets\"", cells);
     file <<"</Verts>\n";
-    file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"</Lines>\n";
-    file <<"<Strips>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"</Strips>\n";
-    file <<"<Polys>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"</Polys>\n";
     file <<"</Piece>\n";
     file <<"</PolyData>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -1042,18 +1129,25 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 
 template<class T>
 void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn)
+{
+    gsWriteParaviewPoints<T>(points, fn, gsVtkDataWriter::defaultOptions());
+}
+
+template<class T>
+void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn,
+                           const gsOptionList & vtkOpt)
 {
     const index_t rows = points.rows();
     switch (rows)
     {
     case 1:
-        gsWriteParaviewPoints<T>(points.row(0), gsMatrix<T>::Zero(1, points.cols()), fn);
+        gsWriteParaviewPoints<T>(points.row(0), gsMatrix<T>::Zero(1, points.cols()), fn, vtkOpt);
         break;
     case 2:
-        gsWriteParaviewPoints<T>(points.row(0), points.row(1), fn);        
+        gsWriteParaviewPoints<T>(points.row(0), points.row(1), fn, vtkOpt);        
         break;
     case 3:
-        gsWriteParaviewPoints<T>(points.row(0), points.row(1), points.row(2), fn);
+        gsWriteParaviewPoints<T>(points.row(0), points.row(1), points.row(2), fn, vtkOpt);
         break;
     default:
         GISMO_ERROR("Point plotting is implemented just for 2D and 3D (rows== 1, 2 or 3).");
@@ -1231,17 +1325,26 @@ void gsWriteParaviewSolid(gsSolid<T> const& sl,
 /// Visualizing a mesh
 template <class T>
 void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
+{
+    gsWriteParaview(sl, fn, pvd, gsVtkDataWriter::defaultOptions());
+}
+
+/// Visualizing a mesh
+template <class T>
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     const gsOptionList & vtkOpt)
 {
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::out | std::ios::binary);
     if ( ! file.is_open() )
         std::cout<<"Problem opening "<<fn<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk(vtkOpt);
     
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< vtk.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     
     /// Number of vertices and number of faces
@@ -1249,92 +1352,50 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
          << sl.numEdges<<"\" NumberOfStrips=\"0\" NumberOfPolys=\""<< sl.numFaces << "\">\n";
     
     /// Coordinates of vertices
+    gsMatrix<T> coords(3, sl.vertex.size());
+    for (size_t i = 0; i != sl.vertex.size(); ++i)
+        coords.col(i) = sl.vertex[i]->coords;
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin(); it!=sl.vertex.end(); ++it)
-    {
-        file << ((*it)->coords)[0] << " ";
-        file << ((*it)->coords)[1] << " ";
-        file << ((*it)->coords)[2] << " \n";
-    }
-    
-    file << "\n";
-    file <<"</DataArray>\n";
+    vtk.floatArray(file, "NumberOfComponents=\"3\"", coords);
     file <<"</Points>\n";
 
-    // Scalar field attached to each face
-    // file << "<PointData Scalars=\"point_scalars\">\n";
-    // file << "<DataArray type=\"Int32\" Name=\"point_scalars\" format=\"ascii\">\n";
-    // for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin(); 
-    //      it!=sl.vertex.end(); ++it)
-    // {
-    //     file << 0 << " ";
-    // }
-    // file << "\n";
-    // file << "</DataArray>\n";
-    // file << "</PointData>\n";
-    
     // Write out edges
-    file << "<Lines>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
-    for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edge.begin();
-         it!=sl.edge.end(); ++it)
-    {
-            file << it->source->getId() << " " << it->target->getId() << "\n";
-    }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    int count=0;
+    std::vector<int> conn, offsets;
+    conn.reserve(2*sl.edge.size());
+    offsets.reserve(sl.edge.size());
     for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edge.begin();
          it!=sl.edge.end(); ++it)
     {
-        count+=2;
-        file << count << " ";
+        conn.push_back(it->source->getId());
+        conn.push_back(it->target->getId());
+        offsets.push_back(conn.size());
     }
-    file << "\n";
-    file << "</DataArray>\n";
+    file << "<Lines>\n";
+    vtk.intArray(file, "Name=\"connectivity\"", conn);
+    vtk.intArray(file, "Name=\"offsets\"", offsets);
     file << "</Lines>\n";
     
-    // Scalar field attached to each face (* if edges exists, this has a problem)
-    // file << "<CellData Scalars=\"cell_scalars\">\n";
-    // file << "<DataArray type=\"Int32\" Name=\"cell_scalars\" format=\"ascii\">\n";
-    // for (typename std::vector< gsFace<T>* >::const_iterator it=sl.face.begin();
-    //      it!=sl.face.end(); ++it)
-    // {
-    //     file << 1 << " ";
-    // }
-    // file << "\n";
-    // file << "</DataArray>\n";
-    // file << "</CellData>\n";
-    
     /// Which vertices belong to which faces
-    file << "<Polys>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
+    conn.clear();
+    offsets.clear();
     for (typename std::vector< gsFace<T>* >::const_iterator it=sl.face.begin();
          it!=sl.face.end(); ++it)
     {
         for (typename std::vector< gsVertex<T>* >::const_iterator vit= (*it)->vertices.begin();
              vit!=(*it)->vertices.end(); ++vit)
         {
-            file << (*vit)->getId() << " ";
+            conn.push_back((*vit)->getId());
         }
-        file << "\n";
-    }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    count=0;
-    for (typename std::vector< gsFace<T>* >::const_iterator it=sl.face.begin();
-         it!=sl.face.end(); ++it)
-    {
-        count += (*it)->vertices.size();
-        file << count << " ";
+        offsets.push_back(conn.size());
     }
-    file << "\n";
-    file << "</DataArray>\n";
+    file << "<Polys>\n";
+    vtk.intArray(file, "Name=\"connectivity\"", conn);
+    vtk.intArray(file, "Name=\"offsets\"", offsets);
     file << "</Polys>\n";
 
     file << "</Piece>\n";
     file <<"</PolyData>\n";
+    vtk.finish(file);
     file <<"</VTKFile>\n";
     file.close();
     
@@ -1459,7 +1520,7 @@ void gsWriteParaviewTrimmedCurve(const gsTrimSurface<T>& surf,
     std::string myFile(fn);
     myFile.append(".vts");
 
-    std::ofstream file(myFile.c_str());
+    std::ofstream file(myFile.c_str(), std::ios::out | std::ios::binary);
     if (!file.is_open())
     {
         gsWarn << "Problem opening " << fn << " Aborting..." << std::endl;
@@ -1468,9 +1529,10 @@ void gsWriteParaviewTrimmedCurve(const gsTrimSurface<T>& surf,
 
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataWriter vtk;
 
     file << "<?xml version=\"1.0\"?>\n";
-    file << "<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file << "<VTKFile type=\"StructuredGrid\" " << vtk.fileAttributes() << ">\n";
     file << "<StructuredGrid WholeExtent=\"0 "<< np(0) - 1 <<
             " 0 " << np(1) - 1 << " 0 " << np(2) - 1 << "\">\n";
 
@@ -1478,22 +1540,12 @@ void gsWriteParaviewTrimmedCurve(const gsTrimSurface<T>& surf,
          << np(2) - 1 << "\">\n";
 
     file << "<Points>\n";
-    file << "<DataArray type=\"Float32\" NumberOfComponents=\"" << points.rows()
-         << "\">\n";
-
-    for (index_t j = 0; j < points.cols(); ++j)
-    {
-        for (index_t i = 0; i < points.rows(); ++i)
-        {
-            file << points(i, j) << " ";
-        }
-        file << "\n";
-    }
-
-    file << "</DataArray>\n";
+    vtk.floatArray(file, "NumberOfComponents=\"" + internal::toString(points.rows())
+                   + "\"", points);
     file << "</Points>\n";
     file << "</Piece>\n";
     file << "</StructuredGrid>\n";
+    vtk.finish(file);
     file << "</VTKFile>\n";
     file.close();
 
@@ -14,18 +14,50 @@ TEMPLATE_INST
 void gsWriteParaview(const gsField<T> & field, std::string const & fn, 
                      unsigned npts, bool mesh);
 
+TEMPLATE_INST
+void gsWriteParaview(const gsField<T> & field, std::string const & fn, 
+                     unsigned npts, bool mesh, const gsOptionList & vtkOpt);
+
+TEMPLATE_INST
+void gsWriteParaview(const gsField<T> & field, gsMpiComm const & comm,
+                     std::string const & fn, unsigned npts, bool mesh);
+
+TEMPLATE_INST
+void gsWriteParaview(const gsField<T> & field, gsMpiComm const & comm,
+                     std::string const & fn, unsigned npts, bool mesh,
+                     const gsOptionList & vtkOpt);
+
+TEMPLATE_INST
+void gsWriteParaview(const gsAdaptiveSampler<T> & sampler, std::string const & fn);
+
+TEMPLATE_INST
+void gsWriteParaview(const gsAdaptiveSampler<T> & sampler, std::string const & fn,
+                     const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
                      unsigned npts, bool mesh, bool ctrlNet);
 
+TEMPLATE_INST
+void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
+                     unsigned npts, bool mesh, bool ctrlNet, const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, std::string const & fn, 
                       unsigned npts, bool mesh, bool ctrlNet);
 
+TEMPLATE_INST
+void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, std::string const & fn, 
+                      unsigned npts, bool mesh, bool ctrlNet, const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, std::string const & fn, 
                                unsigned npts );
 
+TEMPLATE_INST
+void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, std::string const & fn, 
+                               unsigned npts, const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaview(gsGeometrySlice<T> const& Geo, std::string const & fn, unsigned npts );
 
@@ -36,15 +68,31 @@ TEMPLATE_INST
 void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn, 
                      unsigned npts, bool mesh);
 
+TEMPLATE_INST
+void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn, 
+                     unsigned npts, bool mesh, const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn);
 
+TEMPLATE_INST
+void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn,
+                           const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, gsMatrix<T> const& z, std::string const & fn);
 
+TEMPLATE_INST
+void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, gsMatrix<T> const& z, std::string const & fn,
+                           const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn);
 
+TEMPLATE_INST
+void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn,
+                           const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaview(gsSolid<T> const& sl, std::string const & fn, unsigned numPoints_for_eachCurve, int vol_Num,
                      T edgeThick, gsVector3d<T> const & translate, int color_convex,
@@ -58,6 +106,10 @@ void gsWriteParaviewSolid(gsSolid<T> const  & sl,
 TEMPLATE_INST
 void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd);
 
+TEMPLATE_INST
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     const gsOptionList & vtkOpt);
+
 TEMPLATE_INST
 void gsWriteParaview(const std::vector<gsMesh<T> >& sl, std::string const & fn);
 
@@ -90,6 +142,13 @@ void writeSinglePatchField(const gsFunction<T> & geometry,
                            const bool isParam,
                            std::string const & fn, unsigned npts);
 
+TEMPLATE_INST
+void writeSinglePatchField(const gsFunction<T> & geometry,
+                           const gsFunction<T> & parField,
+                           const bool isParam,
+                           std::string const & fn, unsigned npts,
+                           const gsOptionList & vtkOpt);
+
 
 } // namespace gismo
 
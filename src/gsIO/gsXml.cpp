@@ -13,6 +13,8 @@
 
 #include <fstream>
 #include <iomanip>      // std::setprecision
+#include <clocale>      // localeconv
+#include <algorithm>
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsCore/gsBoxTopology.h>
@@ -299,6 +301,706 @@ void getBoundaries(gsXmlNode                * node,
     }
 }
 
+/* Fast conversion of numbers from and to text */
+
+namespace
+{
+
+// Exactly representable powers of ten
+const double s_pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                           1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                           1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+// Powers of ten which are exact in extended (64 bit) precision
+const long double s_pow10L[] = {
+    1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,  1e9L,
+    1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+    1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L };
+
+inline bool isSpace(const char c)
+{ return ' ' == c || '\n' == c || '\t' == c || '\r' == c; }
+
+inline bool isDigit(const char c)
+{ return c >= '0' && c <= '9'; }
+
+inline bool isTokenEnd(const char c)
+{ return '\0' == c || isSpace(c); }
+
+// True if the integer m is exactly representable as a double
+inline bool isExactDouble(unsigned long long m)
+{
+    while ( m > (1ULL << 53) && !(m & 1) ) m >>= 1;
+    return m <= (1ULL << 53);
+}
+
+inline double toReal(const char * str, char ** end, double)
+{ return strtod(str, end); }
+
+inline float toReal(const char * str, char ** end, float)
+{ return strtof(str, end); }
+
+// Parses a number with strtod (strtof for float), in the C locale
+// format; also reads fractions a/b
+template<class T>
+bool parseRealSlow(const char * & str, T & val)
+{
+    // Copy the token, so that a locale-specific decimal point can
+    // replace '.'
+    const char * end = str;
+    while ( !isTokenEnd(*end) ) ++end;
+    std::string token(str, end);
+
+    const char point = *localeconv()->decimal_point;
+    if ( '.' != point )
+        std::replace(token.begin(), token.end(), '.', point);
+
+    char * pos;
+    val = toReal(token.c_str(), &pos, T());
+    if ( pos == token.c_str() )
+        return false;
+    if ( '/' == *pos )
+    {
+        const char * den = pos + 1;
+        val /= toReal(den, &pos, T());
+        if ( pos == den )
+            return false;
+    }
+    if ( '\0' != *pos )
+        return false;
+
+    str = end;
+    return true;
+}
+
+// Computes the correctly rounded value of m * 10^e10 in x, if this
+// is possible without strtod
+template<class T>
+bool scaleExact(const unsigned long long m, const int e10, T & x)
+{
+    if ( 0 == m )
+    {
+        x = 0;
+        return true;
+    }
+
+    // Double arithmetic: both factors are exact, a single rounding
+    if ( 53 == std::numeric_limits<T>::digits && isExactDouble(m)
+         && e10 >= -22 && e10 <= 22 )
+    {
+        const double d = static_cast<double>(m);
+        x = static_cast<T>( e10 < 0 ? d / s_pow10[-e10] : d * s_pow10[e10] );
+        return true;
+    }
+
+    // Extended precision: a single rounding to 64 bits, followed by
+    // the rounding to T, which is correct unless the first result
+    // is a midpoint between two values of type T
+    if ( 64 == std::numeric_limits<long double>::digits && e10 >= -27 && e10 <= 27 )
+    {
+        const long double z = e10 < 0 ? m / s_pow10L[-e10] : m * s_pow10L[e10];
+        int ex;
+        const unsigned long long bits =
+            static_cast<unsigned long long>( std::ldexp(std::frexp(z, &ex), 64) );
+        const int drop = 64 - std::numeric_limits<T>::digits;
+        if ( (bits & ((1ULL << drop) - 1)) != (1ULL << (drop - 1)) )
+        {
+            x = static_cast<T>(z);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true if the decimal number m * 10^e10 reads back to a
+template<class T>
+bool readsBack(const unsigned long long m, const int e10, const T a)
+{
+    T x;
+    if ( !scaleExact(m, e10, x) )
+    {
+        // no decimal point, hence independent of the locale
+        char tmp[64];
+        snprintf(tmp, sizeof(tmp), "%llue%d", m, e10);
+        x = toReal(tmp, NULL, T());
+    }
+    return x == a;
+}
+
+// Computes the p leading decimal digits m of a > 0, rounded; e is
+// the decimal exponent of the leading digit (adjusted if needed).
+// Returns false if this is not possible in extended precision.
+template<class T>
+bool leadingDigits(const T a, const int p, int & e, unsigned long long & m)
+{
+    if ( 64 != std::numeric_limits<long double>::digits )
+        return false;
+    for ( int it = 0; it != 2; ++it )
+    {
+        const int k = p - 1 - e;
+        if ( k < -27 || k > 27 )
+            return false;
+        const long double y = k < 0 ? a / s_pow10L[-k] : a * s_pow10L[k];
+        m = static_cast<unsigned long long>(y + 0.5L);
+        if ( m >= static_cast<unsigned long long>(s_pow10L[p]) )
+            ++e;
+        else if ( m < static_cast<unsigned long long>(s_pow10L[p-1]) )
+            --e;
+        else
+            return true;
+    }
+    return false;
+}
+
+// Shortest representation with at least p0 and at most p1
+// significant digits which reads back to val. The format is the one
+// of printf's %g with precision p1.
+template<class T>
+char * printShortest(const T val, char * buf, const int p0, const int p1)
+{
+    if ( val != val || val - val != val - val ) // nan or inf
+        return buf + sprintf(buf, "%g", static_cast<double>(val));
+
+    // Integers are written directly
+    if ( math::abs(val) < (T)(1e15) && val == math::floor(val) )
+        return buf + sprintf(buf, "%.0f", static_cast<double>(val));
+
+    const bool neg = (val < 0);
+    const T    a   = neg ? -val : val;
+
+    // Shortest candidate which reads back to val
+    char cand[24];
+    int p = p0;
+    int e = static_cast<int>( math::floor(std::log10(static_cast<double>(a))) );
+    unsigned long long m = 0;
+    for ( ; p <= p1; ++p )
+        if ( leadingDigits(a, p, e, m) && readsBack(m, e - p + 1, a) )
+            break;
+
+    if ( p <= p1 )
+        for ( int k = p - 1; k >= 0; --k, m /= 10 )
+            cand[k] = static_cast<char>('0' + m % 10);
+    else // out of the range of the extended precision arithmetic
+    {
+        // The p1 leading digits and the exponent
+        char tmp[40];
+        sprintf(tmp, "%.*e", p1 - 1, static_cast<double>(a));
+        const char * c = tmp;
+        char dig[24];
+        int nd = 0;
+        for ( ; 'e' != *c; ++c )
+            if ( isDigit(*c) ) dig[nd++] = *c;
+        const int exp = atoi(c + 1);
+
+        // Round the digits as long as they do not read back to val
+        for ( p = p0; p < nd; ++p )
+        {
+            e = exp;
+            std::copy(dig, dig + p, cand);
+            if ( dig[p] >= '5' ) // round up
+            {
+                int k = p - 1;
+                for ( ; k >= 0 && '9' == cand[k]; --k )
+                    cand[k] = '0';
+                if ( k >= 0 )
+                    ++cand[k];
+                else // 99..9 became 100..0
+                {
+                    cand[0] = '1';
+                    ++e;
+                }
+            }
+            m = 0;
+            for ( int k = 0; k != p; ++k )
+                m = 10 * m + (cand[k] - '0');
+            if ( readsBack(m, e - p + 1, a) )
+                break;
+        }
+        if ( p == nd )
+        {
+            std::copy(dig, dig + nd, cand);
+            e = exp;
+        }
+    }
+    while ( p > 1 && '0' == cand[p-1] ) --p;
+
+    // Format as %g
+    char * out = buf;
+    if ( neg ) *out++ = '-';
+    if ( e < -4 || e >= p1 ) // scientific
+    {
+        *out++ = cand[0];
+        if ( p > 1 )
+        {
+            *out++ = '.';
+            out = std::copy(cand + 1, cand + p, out);
+        }
+        out += sprintf(out, "e%c%02d", e < 0 ? '-' : '+', e < 0 ? -e : e);
+    }
+    else if ( e < 0 ) // 0.00ddd
+    {
+        *out++ = '0';
+        *out++ = '.';
+        for ( int k = 1; k < -e; ++k ) *out++ = '0';
+        out = std::copy(cand, cand + p, out);
+    }
+    else // ddd.ddd or ddd00
+    {
+        if ( p <= e + 1 )
+        {
+            out = std::copy(cand, cand + p, out);
+            for ( int k = p; k <= e; ++k ) *out++ = '0';
+        }
+        else
+        {
+            out = std::copy(cand, cand + e + 1, out);
+            *out++ = '.';
+            out = std::copy(cand + e + 1, cand + p, out);
+        }
+    }
+    *out = '\0';
+    return out;
+}
+
+const char s_base64[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// The values of the base64 digits, -1 for other characters
+const signed char s_base64Value[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+bool isLittleEndian()
+{
+    const unsigned short one = 1;
+    return 1 == *reinterpret_cast<const unsigned char*>(&one);
+}
+
+// Reverses the bytes of every value of size width
+void swapBytes(char * data, const size_t nbytes, const size_t width)
+{
+    for ( char * v = data; v < data + nbytes; v += width )
+        std::reverse(v, v + width);
+}
+
+// Fast, locale-independent parsing, see parseReal
+template<class T>
+bool parseRealImpl(const char * & str, T & val)
+{
+    const char * p = str;
+    while ( isSpace(*p) ) ++p;
+
+    // Decimal significand, at most 19 digits are kept
+    const char * start = p;
+    const bool neg = ('-' == *p);
+    if ( '-' == *p || '+' == *p ) ++p;
+
+    unsigned long long m = 0;
+    int nd = 0, e10 = 0;
+    bool exact = true, digits = false;
+    for ( ; isDigit(*p); ++p )
+    {
+        digits = true;
+        if ( nd < 19 )
+        {
+            m = 10 * m + (*p - '0');
+            if ( m ) ++nd;
+        }
+        else
+        {
+            ++e10;
+            exact &= ('0' == *p);
+        }
+    }
+    if ( '.' == *p )
+        for ( ++p; isDigit(*p); ++p )
+        {
+            digits = true;
+            if ( nd < 19 )
+            {
+                m = 10 * m + (*p - '0');
+                if ( m ) ++nd;
+                --e10;
+            }
+            else
+                exact &= ('0' == *p);
+        }
+
+    if ( digits && ('e' == *p || 'E' == *p) )
+    {
+        const char * q = p + 1;
+        const bool eneg = ('-' == *q);
+        if ( '-' == *q || '+' == *q ) ++q;
+        if ( isDigit(*q) )
+        {
+            int e = 0;
+            for ( ; isDigit(*q); ++q )
+                if ( e < 100000 ) e = 10 * e + (*q - '0');
+            e10 += eneg ? -e : e;
+            p = q;
+        }
+    }
+
+    // Fast path: correctly rounded without strtod
+    if ( digits && exact && isTokenEnd(*p) && scaleExact(m, e10, val) )
+    {
+        if ( neg ) val = -val;
+        str = p;
+        return true;
+    }
+
+    // Long significands, large exponents, fractions, inf and nan
+    str = start;
+    return parseRealSlow(str, val);
+}
+
+}
+
+bool parseReal(const char * & str, double & val)
+{ return parseRealImpl(str, val); }
+
+bool parseReal(const char * & str, float & val)
+{ return parseRealImpl(str, val); }
+
+char * printReal(const double val, char * buf)
+{ return printShortest(val, buf, 15, 17); }
+
+char * printReal(const float val, char * buf)
+{ return printShortest(val, buf, 6, 9); }
+
+void encodeBase64(const char * data, size_t n, std::string & result)
+{
+    const unsigned char * in = reinterpret_cast<const unsigned char*>(data);
+    result.reserve( result.size() + 4 * ((n + 2) / 3) );
+
+    size_t i = 0;
+    for ( ; i + 2 < n; i += 3 )
+    {
+        const unsigned v = (in[i] << 16) | (in[i+1] << 8) | in[i+2];
+        result.push_back( s_base64[(v >> 18) & 63] );
+        result.push_back( s_base64[(v >> 12) & 63] );
+        result.push_back( s_base64[(v >>  6) & 63] );
+        result.push_back( s_base64[ v        & 63] );
+    }
+
+    if ( i < n ) // remaining one or two bytes
+    {
+        const unsigned v = (in[i] << 16) | ( i + 1 < n ? in[i+1] << 8 : 0 );
+        result.push_back( s_base64[(v >> 18) & 63] );
+        result.push_back( s_base64[(v >> 12) & 63] );
+        result.push_back( i + 1 < n ? s_base64[(v >> 6) & 63] : '=' );
+        result.push_back( '=' );
+    }
+}
+
+size_t decodeBase64(const char * str, char * dst, const size_t n)
+{
+    size_t k = 0;
+    unsigned v = 0;
+    int bits = 0;
+    for ( ; *str && '=' != *str; ++str )
+    {
+        const int d = s_base64Value[static_cast<unsigned char>(*str)];
+        if ( d < 0 ) // whitespace and line breaks
+            continue;
+        v = (v << 6) | d;
+        bits += 6;
+        if ( bits >= 8 )
+        {
+            bits -= 8;
+            if ( k < n ) dst[k] = static_cast<char>( (v >> bits) & 255 );
+            ++k;
+        }
+    }
+    return k;
+}
+
+void encodeBinary(const char * data, const size_t nbytes, const size_t width,
+                  std::string & result)
+{
+    if ( isLittleEndian() || 1 == width )
+        encodeBase64(data, nbytes, result);
+    else
+    {
+        std::vector<char> tmp(data, data + nbytes);
+        swapBytes(&tmp[0], nbytes, width);
+        encodeBase64(&tmp[0], nbytes, result);
+    }
+}
+
+bool decodeBinary(const char * str, char * dst, const size_t nbytes, const size_t width)
+{
+    if ( decodeBase64(str, dst, nbytes) != nbytes )
+        return false;
+    if ( !isLittleEndian() && 1 != width )
+        swapBytes(dst, nbytes, width);
+    return true;
+}
+
+/* Binary container format */
+
+namespace
+{
+
+// Header: magic, version, offset and size of the XML text, offset
+// and size of the data blocks, as little endian 64 bit integers
+const char   s_magic[8]   = { 'G', 'S', 'M', 'O', 'B', 'I', 'N', '\0' };
+const size_t s_version    = 1;
+const size_t s_headerSize = binaryHeaderSize;
+
+// Alignment of the data blocks in the file
+const size_t s_align = 64;
+
+void putUInt64(char * dst, unsigned long long v)
+{
+    for ( int k = 0; k != 8; ++k, v >>= 8 )
+        dst[k] = static_cast<char>(v & 255);
+}
+
+unsigned long long getUInt64(const char * src)
+{
+    unsigned long long v = 0;
+    for ( int k = 7; k >= 0; --k )
+        v = (v << 8) | static_cast<unsigned char>(src[k]);
+    return v;
+}
+
+bool isFormat(gsXmlNode * node, const char * format)
+{
+    const gsXmlAttribute * fmt = node->first_attribute("format");
+    return fmt && !strcmp(fmt->value(), format);
+}
+
+void removeAttribute(gsXmlNode * node, const char * name)
+{
+    if ( gsXmlAttribute * att = node->first_attribute(name) )
+        node->remove_attribute(att);
+}
+
+// Moves the data of all binary nodes below node into blocks, the
+// offsets in the file are shifted by base
+void extractBlocks(gsXmlNode * node, gsXmlTree & data, std::vector<char> & blocks,
+                   const size_t base = 0)
+{
+    for ( gsXmlNode * child = node->first_node(); child; child = child->next_sibling() )
+        extractBlocks(child, data, blocks, base);
+
+    const bool raw = isFormat(node, "raw");
+    if ( !raw && !isFormat(node, "binary") )
+        return;
+
+    const size_t offset = (blocks.size() + s_align - 1) / s_align * s_align;
+    const size_t nbytes = raw ? node->value_size() : decodeBase64(node->value(), NULL, 0);
+    blocks.resize(offset + nbytes);
+    if ( raw )
+        std::copy(node->value(), node->value() + nbytes, blocks.begin() + offset);
+    else
+        decodeBase64(node->value(), nbytes ? &blocks[offset] : NULL, nbytes);
+
+    char tmp[24];
+    node->remove_all_nodes(); // data node of parsed text
+    node->value("", 0);
+    node->first_attribute("format")->value("raw");
+    removeAttribute(node, "offset");
+    removeAttribute(node, "bytes");
+    sprintf(tmp, "%llu", static_cast<unsigned long long>(base + offset));
+    node->append_attribute( makeAttribute("offset", tmp, data) );
+    sprintf(tmp, "%llu", static_cast<unsigned long long>(nbytes));
+    node->append_attribute( makeAttribute("bytes", tmp, data) );
+}
+
+// Points the values of the raw nodes below node to their data blocks
+bool attachBlocks(gsXmlNode * node, const char * blocks, const size_t size)
+{
+    for ( gsXmlNode * child = node->first_node(); child; child = child->next_sibling() )
+        if ( !attachBlocks(child, blocks, size) )
+            return false;
+
+    if ( node->type() != rapidxml::node_element || !isFormat(node, "raw") )
+        return true;
+
+    size_t offset, nbytes;
+    if ( !rawBlock(node, offset, nbytes) || offset + nbytes > size )
+        return false;
+    node->value(blocks + offset, nbytes);
+    return true;
+}
+
+// Sums up the sizes of the aligned blocks of the binary nodes below node
+void blocksSize(const gsXmlNode * node, size_t & size)
+{
+    for ( gsXmlNode * child = node->first_node(); child; child = child->next_sibling() )
+        blocksSize(child, size);
+
+    gsXmlNode * nd = const_cast<gsXmlNode *>(node);
+    const bool raw = isFormat(nd, "raw");
+    if ( !raw && !isFormat(nd, "binary") )
+        return;
+    size = (size + s_align - 1) / s_align * s_align;
+    size += raw ? node->value_size() : decodeBase64(node->value(), NULL, 0);
+}
+
+}
+
+bool rawBlock(const gsXmlNode * node, size_t & offset, size_t & nbytes)
+{
+    gsXmlNode * nd = const_cast<gsXmlNode *>(node);
+    if ( node->type() != rapidxml::node_element || !isFormat(nd, "raw") )
+        return false;
+    const gsXmlAttribute * off = node->first_attribute("offset");
+    const gsXmlAttribute * len = node->first_attribute("bytes");
+    unsigned long long o, n;
+    if ( !off || !len || 1 != sscanf(off->value(), "%llu", &o)
+         || 1 != sscanf(len->value(), "%llu", &n) )
+        return false;
+    offset = static_cast<size_t>(o);
+    nbytes = static_cast<size_t>(n);
+    return true;
+}
+
+size_t xmlBinaryDataSize(const gsXmlNode * root)
+{
+    size_t size = 0;
+    blocksSize(root, size);
+    return (size + s_align - 1) / s_align * s_align;
+}
+
+void packXmlBinary(const gsXmlNode * root, const size_t base,
+                   std::string & xml, std::vector<char> & blocks)
+{
+    GISMO_ASSERT( 0 == base % s_align, "The data blocks must be aligned");
+    gsXmlTree tmp;
+    for ( gsXmlNode * child = root->first_node(); child; child = child->next_sibling() )
+        tmp.append_node( tmp.clone_node(child) );
+
+    blocks.clear();
+    extractBlocks(&tmp, tmp, blocks, base);
+    blocks.resize( (blocks.size() + s_align - 1) / s_align * s_align, '\0' );
+
+    std::ostringstream oss;
+    for ( gsXmlNode * child = tmp.first_node(); child; child = child->next_sibling() )
+        oss << *child;
+    xml = oss.str();
+}
+
+size_t writeXmlBinaryHeader(char * header, const size_t xmlSize, const size_t dataSize)
+{
+    const size_t dataOffset = (s_headerSize + xmlSize + s_align - 1) / s_align * s_align;
+    std::fill(header, header + s_headerSize, '\0');
+    std::copy(s_magic, s_magic + 8, header);
+    putUInt64(header +  8, s_version);
+    putUInt64(header + 16, s_headerSize);
+    putUInt64(header + 24, xmlSize);
+    putUInt64(header + 32, dataOffset);
+    putUInt64(header + 40, dataSize);
+    return dataOffset;
+}
+
+bool readXmlBinaryHeader(const char * header, size_t & xmlOffset, size_t & xmlSize,
+                         size_t & dataOffset, size_t & dataSize)
+{
+    if ( !std::equal(s_magic, s_magic + 8, header) )
+        return false;
+    if ( getUInt64(header + 8) != s_version )
+    {
+        gsWarn << "gsXml: Unsupported version "<< getUInt64(header + 8)
+               <<" of the binary format.\n";
+        return false;
+    }
+    xmlOffset  = static_cast<size_t>( getUInt64(header + 16) );
+    xmlSize    = static_cast<size_t>( getUInt64(header + 24) );
+    dataOffset = static_cast<size_t>( getUInt64(header + 32) );
+    dataSize   = static_cast<size_t>( getUInt64(header + 40) );
+    return true;
+}
+
+bool getBinaryData(gsXmlNode * node, char * dst, const size_t nbytes, const size_t width)
+{
+    if ( !isFormat(node, "raw") )
+        return decodeBinary(node->value(), dst, nbytes, width);
+
+    if ( node->value_size() != nbytes )
+        return false;
+    std::copy(node->value(), node->value() + nbytes, dst);
+    if ( !isLittleEndian() && 1 != width )
+        swapBytes(dst, nbytes, width);
+    return true;
+}
+
+void writeXmlBinary(std::ostream & os, const gsXmlTree & data)
+{
+    // Work on a copy, the names and values are shared
+    gsXmlTree tmp;
+    for ( gsXmlNode * child = data.first_node(); child; child = child->next_sibling() )
+        tmp.append_node( tmp.clone_node(child) );
+
+    std::vector<char> blocks;
+    extractBlocks(&tmp, tmp, blocks);
+
+    std::ostringstream oss;
+    oss << tmp;
+    const std::string xml = oss.str();
+
+    char header[s_headerSize];
+    const size_t dataOffset = writeXmlBinaryHeader(header, xml.size(), blocks.size());
+
+    os.write(header, s_headerSize);
+    os.write(xml.data(), xml.size());
+    const std::vector<char> pad(dataOffset - s_headerSize - xml.size(), '\0');
+    if ( !pad.empty() )
+        os.write(&pad[0], pad.size());
+    if ( !blocks.empty() )
+        os.write(&blocks[0], blocks.size());
+}
+
+bool readXmlBinary(const char * file, const size_t size,
+                   std::vector<char> & buffer, gsXmlTree & data)
+{
+    size_t xmlOffset, xmlSize, dataOffset, dataSize;
+    if ( size < s_headerSize ||
+         !readXmlBinaryHeader(file, xmlOffset, xmlSize, dataOffset, dataSize) ||
+         xmlOffset + xmlSize > size || dataOffset + dataSize > size )
+        return false;
+
+    // Only the XML text is parsed
+    buffer.assign(file + xmlOffset, file + xmlOffset + xmlSize);
+    buffer.push_back('\0');
+    data.parse<0>(&buffer[0]);
+
+    return attachBlocks(&data, file + dataOffset, dataSize);
+}
+
+void encodeRawNodes(gsXmlNode * root, gsXmlTree & data)
+{
+    for ( gsXmlNode * child = root->first_node(); child; child = child->next_sibling() )
+        encodeRawNodes(child, data);
+
+    if ( root->type() != rapidxml::node_element || !isFormat(root, "raw") )
+        return;
+
+    std::string enc;
+    encodeBase64(root->value(), root->value_size(), enc);
+    root->remove_all_nodes();
+    root->value( data.allocate_string(enc.c_str(), enc.size() + 1), enc.size() );
+    root->first_attribute("format")->value("binary");
+    removeAttribute(root, "offset");
+    removeAttribute(root, "bytes");
+}
+
 }// end namespace internal
 
 }// end namespace gismo
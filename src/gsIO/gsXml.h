@@ -216,6 +216,26 @@ public:
     //static void     getId_into   (gsXmlNode * node, int id, Object & result);
 };
 
+/// Helper to fetch the child of \a parent with the given \em id
+/// value and tag \a tag (any tag if NULL). Uses the index of the
+/// XML tree if it was built for \a parent (see
+/// gsXmlTree::indexChildren).
+inline gsXmlNode * childById(gsXmlNode * parent, const int id, const char * tag = NULL)
+{
+    if ( gsXmlTree * doc = parent->document() )
+        return doc->childById(parent, id, tag);
+
+    // Not part of a tree
+    for (gsXmlNode * child = parent->first_node(tag);
+         child; child = child->next_sibling(tag))
+    {
+        const gsXmlAttribute * id_at = child->first_attribute("id");
+        if ( id_at && atoi(id_at->value()) == id )
+            return child;
+    }
+    return NULL;
+}
+
 /// Helper to read an object by a given \em id value:
 /// \param node parent node, we check his children to get the given \em id
 /// \param id
@@ -223,13 +243,8 @@ template<class Object>
 Object * getById(gsXmlNode * node, const int & id)
 {
     std::string tag = internal::gsXml<Object>::tag();
-    for (gsXmlNode * child = node->first_node(tag.c_str()); //note: gsXmlNode object in use
-         child; child = child->next_sibling(tag.c_str()))
-    {
-        const gsXmlAttribute * id_at = child->first_attribute("id");
-        if (id_at && atoi(id_at->value()) == id )
-            return internal::gsXml<Object>::get(child);
-    }
+    if ( gsXmlNode * child = childById(node, id, tag.c_str()) )
+        return internal::gsXml<Object>::get(child);
     std::cerr<<"gsXmlUtils Warning: "<< internal::gsXml<Object>::tag() 
              <<" with id="<<id<<" not found.\n";
     return NULL;
@@ -240,13 +255,8 @@ Object * getById(gsXmlNode * node, const int & id)
 /// \param id the ID number which is seeked for
 inline gsXmlNode * searchId(const int id, gsXmlNode * root)
 {
-    for (gsXmlNode * child = root->first_node();
-         child; child = child->next_sibling())
-    {
-        const gsXmlAttribute * id_at = child->first_attribute("id");
-        if ( id_at &&  atoi(id_at->value()) == id )
-            return child;
-    }
+    if ( gsXmlNode * child = childById(root, id) )
+        return child;
     gsWarn <<"gsXmlUtils: No object with id = "<<id<<" found.\n";
     return NULL;
 }
@@ -275,6 +285,130 @@ GISMO_EXPORT gsXmlNode *  makeComment(const std::string &, gsXmlTree & data);
 /// Helper to convert small unsigned to string
 GISMO_EXPORT std::string to_string(const unsigned & i);
 
+/// \brief Fast, locale-independent parsing of a real number (or a
+/// fraction a/b). Leading whitespace is skipped; on success \a str is
+/// advanced past the number.
+GISMO_EXPORT bool parseReal(const char * & str, double & val);
+
+/// \brief Parsing of a single precision number, correctly rounded
+/// (see parseReal(const char*&,double&))
+GISMO_EXPORT bool parseReal(const char * & str, float & val);
+
+/// \brief Writes the shortest decimal representation of \a val which
+/// reads back to the same value into \a buf (at least 32 characters).
+/// Returns the end of the written characters.
+GISMO_EXPORT char * printReal(double val, char * buf);
+
+/// \brief Writes the shortest decimal representation of the single
+/// precision value \a val (see printReal(double,char*))
+GISMO_EXPORT char * printReal(float val, char * buf);
+
+/// Appends the base64 encoding of \a n bytes at \a data to \a result
+GISMO_EXPORT void encodeBase64(const char * data, size_t n, std::string & result);
+
+/// \brief Decodes the base64 string \a str into \a dst, writing at
+/// most \a n bytes. Characters outside the base64 alphabet are
+/// ignored. Returns the number of bytes encoded in \a str.
+GISMO_EXPORT size_t decodeBase64(const char * str, char * dst, size_t n);
+
+/// \brief Appends the base64 encoding of \a nbytes bytes of values of
+/// size \a width, in little endian byte order, to \a result
+GISMO_EXPORT void encodeBinary(const char * data, size_t nbytes, size_t width,
+                               std::string & result);
+
+/// \brief Decodes exactly \a nbytes bytes of little endian values of
+/// size \a width from the base64 string \a str into \a dst. Returns
+/// false if the size does not match.
+GISMO_EXPORT bool decodeBinary(const char * str, char * dst, size_t nbytes, size_t width);
+
+/// \brief Copies the binary values of \a node into \a dst, which
+/// holds \a nbytes bytes of values of size \a width. The node holds
+/// either base64 encoded (\c format="binary") or raw data (\c
+/// format="raw", see readXmlBinary()). Returns false if the size
+/// does not match.
+GISMO_EXPORT bool getBinaryData(gsXmlNode * node, char * dst, size_t nbytes, size_t width);
+
+/// \brief Writes the tree \a data in the G+Smo binary container
+/// format to \a os.
+///
+/// The container consists of a header, the XML text of the tree
+/// without the binary data, and the data of all binary nodes (\c
+/// format="binary") as raw blocks, aligned to 64 bytes. In the XML
+/// text, these nodes become \c format="raw" with the attributes \c
+/// offset and \c bytes.
+GISMO_EXPORT void writeXmlBinary(std::ostream & os, const gsXmlTree & data);
+
+/// \brief Reads the binary container (see writeXmlBinary()) of \a
+/// size bytes at \a file into \a data. The XML text is copied into
+/// \a buffer and parsed; the values of the raw nodes point to the
+/// data blocks in \a file, which must stay valid as long as \a data
+/// is used. Returns false if the container is invalid.
+GISMO_EXPORT bool readXmlBinary(const char * file, size_t size,
+                                std::vector<char> & buffer, gsXmlTree & data);
+
+/// Size in bytes of the header of the binary container
+const size_t binaryHeaderSize = 64;
+
+/// \brief Writes the header of a binary container with \a xmlSize
+/// bytes of XML text and \a dataSize bytes of data blocks to \a
+/// header (binaryHeaderSize bytes). Returns the offset of the data
+/// blocks in the file; the XML text follows the header directly.
+GISMO_EXPORT size_t writeXmlBinaryHeader(char * header, size_t xmlSize, size_t dataSize);
+
+/// \brief Reads the header (binaryHeaderSize bytes) of a binary
+/// container. Returns false if it is invalid.
+GISMO_EXPORT bool readXmlBinaryHeader(const char * header, size_t & xmlOffset, size_t & xmlSize,
+                                      size_t & dataOffset, size_t & dataSize);
+
+/// \brief Returns the size of the data blocks of the binary nodes
+/// below \a root in the binary container, see packXmlBinary()
+GISMO_EXPORT size_t xmlBinaryDataSize(const gsXmlNode * root);
+
+/// \brief Converts the children of \a root to a part of a binary
+/// container: their XML text is written to \a xml and the data of
+/// their binary nodes to \a blocks (of size xmlBinaryDataSize()).
+/// The offsets of the raw nodes are shifted by \a base, the
+/// position of \a blocks in the data of the container.
+GISMO_EXPORT void packXmlBinary(const gsXmlNode * root, size_t base,
+                                std::string & xml, std::vector<char> & blocks);
+
+/// \brief Gets the position \a offset in the data blocks and the
+/// size \a nbytes of the raw node \a node. Returns false if \a node
+/// is not a raw node.
+GISMO_EXPORT bool rawBlock(const gsXmlNode * node, size_t & offset, size_t & nbytes);
+
+/// \brief Converts the raw nodes (\c format="raw") below \a root
+/// (e.g. the whole tree \a data) into base64 encoded nodes (\c
+/// format="binary"), so that the tree no longer refers to external
+/// data
+GISMO_EXPORT void encodeRawNodes(gsXmlNode * root, gsXmlTree & data);
+
+/// Name of the binary representation of the scalar type T in XML
+/// files, NULL if it has none
+template<class T> struct binaryType { static const char * name() { return NULL; } };
+template<> struct binaryType<double> { static const char * name() { return "Float64"; } };
+template<> struct binaryType<float>  { static const char * name() { return "Float32"; } };
+
+/// Helpers to read a value from the text \a str, advancing \a str
+inline bool readValue(const char * & str, double & val)
+{ return parseReal(str, val); }
+
+inline bool readValue(const char * & str, float & val)
+{ return parseReal(str, val); }
+
+template<class T>
+bool readValue(const char * & str, T & val);
+
+/// Helpers to append a value to the text \a out
+inline void appendValue(std::string & out, const double val)
+{ char buf[32]; out.append(buf, printReal(val, buf)); }
+
+inline void appendValue(std::string & out, const float val)
+{ char buf[32]; out.append(buf, printReal(val, buf)); }
+
+template<class T>
+void appendValue(std::string & out, const T & val);
+
 /// Helper to count the number of Objects (by tag) that exist in the
 /// XML tree
 GISMO_EXPORT int countByTag(const std::string & tag, gsXmlNode * root );
@@ -12,6 +12,7 @@
 */
 
 #include <sstream>
+#include <cctype>
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsCore/gsFunctionExpr.h>
 
@@ -30,31 +31,55 @@ std::string gsXml<Object>::tag ()
 }
 */
 
+template<class T>
+bool readValue(const char * & str, T & val)
+{
+    while ( isspace(*str) ) ++str;
+    const char * end = str;
+    while ( *end && !isspace(*end) ) ++end;
+    std::istringstream is( std::string(str, end) );
+    if ( !gsGetValue(is, val) )
+        return false;
+    str = end;
+    return true;
+}
+
+template<class T>
+void appendValue(std::string & out, const T & val)
+{
+    std::ostringstream oss;
+    oss << std::setprecision(FILE_PRECISION) << val;
+    out += oss.str();
+}
+
 template<class T>
 gsXmlNode * makeNode( const std::string & name, 
                       const gsMatrix<T> & value, gsXmlTree & data,
                       bool transposed)
 {
-    std::ostringstream oss;
-    // Set precision
-    oss << std::setprecision(FILE_PRECISION);
+    std::string str;
+    str.reserve(8 * value.size());
   
     if ( transposed )
         for ( index_t j = 0; j< value.rows(); ++j)
         {
             for ( index_t i = 0; i< value.cols(); ++i)
-                oss << value(j,i) <<" ";
-            //oss << "\n";
+            {
+                appendValue(str, value(j,i));
+                str.push_back(' ');
+            }
         }
     else
         for ( index_t j = 0; j< value.cols(); ++j)
         {
             for ( index_t i = 0; i< value.rows(); ++i)
-                oss << value(i,j) <<" ";
-            //oss << "\n";
+            {
+                appendValue(str, value(i,j));
+                str.push_back(' ');
+            }
         }
   
-    return makeNode(name, oss.str(), data);
+    return makeNode(name, str, data);
 }
 
 template<class T>
@@ -85,14 +110,47 @@ void getMatrixFromXml ( gsXmlNode * node, unsigned const & rows,
                         unsigned const & cols, gsMatrix<T> & result ) 
 {
     //gsWarn<<"Reading "<< node->name() <<" matrix of size "<<rows<<"x"<<cols<<"Geometry..\n";
-    std::istringstream str;
-    str.str( node->value() );
     result.resize(rows,cols);
- 
+
+    const gsXmlAttribute * format = node->first_attribute("format");
+    if ( format && ( !strcmp(format->value(), "binary") || !strcmp(format->value(), "raw") ) )
+    {
+        // Binary data: values in column-major order
+        const gsXmlAttribute * tp = node->first_attribute("type");
+        const char * type = tp ? tp->value() : "Float64";
+        const size_t n    = static_cast<size_t>(result.size());
+        bool ok = false;
+        if ( binaryType<T>::name() && !strcmp(type, binaryType<T>::name()) )
+            ok = getBinaryData(node, reinterpret_cast<char*>(result.data()),
+                               n * sizeof(T), sizeof(T));
+        else if ( !strcmp(type, "Float64") )
+        {
+            std::vector<double> buf(n);
+            ok = getBinaryData(node, reinterpret_cast<char*>(n ? &buf[0] : NULL),
+                               n * sizeof(double), sizeof(double));
+            for ( size_t i = 0; ok && i != n; ++i )
+                result.data()[i] = static_cast<T>(buf[i]);
+        }
+        else if ( !strcmp(type, "Float32") )
+        {
+            std::vector<float> buf(n);
+            ok = getBinaryData(node, reinterpret_cast<char*>(n ? &buf[0] : NULL),
+                               n * sizeof(float), sizeof(float));
+            for ( size_t i = 0; ok && i != n; ++i )
+                result.data()[i] = static_cast<T>(buf[i]);
+        }
+        if ( !ok )
+        {
+            gsWarn<<"XML Warning: Reading binary matrix of size "<<rows<<"x"<<cols<<" failed.\n";
+            gsWarn<<"Tag: "<< node->name() <<", type: "<< type <<".\n";
+        }
+        return;
+    }
+
+    const char * str = node->value();
     for (unsigned i=0; i<rows; ++i)
         for (unsigned j=0; j<cols; ++j)
-            //if ( !(str >> result(i,j) ) )
-              if (! gsGetValue(str,result(i,j)) )
+            if ( !readValue(str, result(i,j)) )
             {
                 gsWarn<<"XML Warning: Reading matrix of size "<<rows<<"x"<<cols<<" failed.\n";
                 gsWarn<<"Tag: "<< node->name() <<", Matrix entry: ("<<i<<", "<<j<<").\n";
@@ -119,18 +177,34 @@ void getSparseEntriesFromXml ( gsXmlNode * node,
 template<class T>
 gsXmlNode * putMatrixToXml ( gsMatrix<T> const & mat, gsXmlTree & data, std::string name) 
 {
-    std::ostringstream str;
-    str << std::setprecision(FILE_PRECISION);
+    const char * type = binaryType<T>::name();
+    if ( type && data.binaryMatrices() )
+    {
+        // Values in column-major order, base64 encoded
+        std::string str;
+        encodeBinary(reinterpret_cast<const char*>(mat.data()),
+                     static_cast<size_t>(mat.size()) * sizeof(T), sizeof(T), str);
+        gsXmlNode* new_node = internal::makeNode(name, str, data);
+        new_node->append_attribute( makeAttribute("format", "binary", data) );
+        new_node->append_attribute( makeAttribute("type", type, data) );
+        return new_node;
+    }
+
+    std::string str;
+    str.reserve(8 * mat.size());
     // Write the matrix entries
     for (index_t i=0; i< mat.rows(); ++i)
     {
         for (index_t j=0; j<mat.cols(); ++j)
-            str << mat(i,j)<< " ";
-        str << "\n";
+        {
+            appendValue(str, mat(i,j));
+            str.push_back(' ');
+        }
+        str.push_back('\n');
     }
 
     // Create XML tree node
-    gsXmlNode* new_node = internal::makeNode(name, str.str(), data);        
+    gsXmlNode* new_node = internal::makeNode(name, str, data);        
     return new_node;
 }
 
@@ -270,28 +270,33 @@ public:
                 &&  ( !strcmp(node->first_attribute("type")->value(),"off") ) );
       
         gsMesh<T> * m = new gsMesh<T>;
-        std::istringstream str;
-        str.str( node->value() );
+        const char * str = node->value();
       
-        unsigned n  = atoi ( node->first_attribute("vertices")->value() ) ;
+        const unsigned nv = atoi ( node->first_attribute("vertices")->value() ) ;
+        const unsigned nf = atoi ( node->first_attribute("faces")->value() ) ;
+        m->reserve(nv, nf);
+
         T x,y, z;
-        for (unsigned i=0; i<n; ++i)
+        for (unsigned i=0; i<nv; ++i)
         {
-            gsGetReal(str, x);
-            gsGetReal(str, y);
-            gsGetReal(str, z);
+            readValue(str, x);
+            readValue(str, y);
+            readValue(str, z);
             m->addVertex(x,y,z);
         }
       
-        n  = atoi ( node->first_attribute("faces")->value() ) ;
-        unsigned c = 0;
+        char * end;
         std::vector<int> face;
-        for (unsigned i=0; i<n; ++i)
+        for (unsigned i=0; i<nf; ++i)
         {
-            gsGetInt(str, c);
+            const long c = strtol(str, &end, 10);
+            str = end;
             face.resize(c);
-            for (unsigned j=0; j<c; ++j)
-                gsGetInt(str, face[j]);
+            for (long j=0; j<c; ++j)
+            {
+                face[j] = static_cast<int>( strtol(str, &end, 10) );
+                str = end;
+            }
             m->addFace(face);
         }
         return m;
@@ -300,7 +305,33 @@ public:
     static gsXmlNode * put (const gsMesh<T> & obj,
                             gsXmlTree & data )
     {
-        return NULL;
+        // Vertex coordinates, followed by the faces as vertex count
+        // and vertex indices (as in the OFF format)
+        std::string str;
+        for (typename std::vector<typename gsMesh<T>::VertexHandle>::const_iterator 
+                 it = obj.vertex.begin(); it != obj.vertex.end(); ++it)
+        {
+            appendValue(str, (*it)->x()); str.push_back(' ');
+            appendValue(str, (*it)->y()); str.push_back(' ');
+            appendValue(str, (*it)->z()); str.push_back('\n');
+        }
+
+        char buf[16];
+        for (typename std::vector<typename gsMesh<T>::FaceHandle>::const_iterator 
+                 it = obj.face.begin(); it != obj.face.end(); ++it)
+        {
+            const std::vector<typename gsMesh<T>::VertexHandle> & vert = (*it)->vertices;
+            str.append(buf, sprintf(buf, "%d", static_cast<int>(vert.size())));
+            for (size_t j = 0; j != vert.size(); ++j)
+                str.append(buf, sprintf(buf, " %d", vert[j]->getId()));
+            str.push_back('\n');
+        }
+
+        gsXmlNode * node = makeNode("Mesh", str, data);
+        node->append_attribute( makeAttribute("type", "off", data) );
+        node->append_attribute( makeAttribute("vertices", static_cast<unsigned>(obj.vertex.size()), data) );
+        node->append_attribute( makeAttribute("faces", static_cast<unsigned>(obj.face.size()), data) );
+        return node;
     }
 };
 
@@ -40,6 +40,21 @@ template<typename T> class gsEigenPardisoLU;
     So in order to solve \f$ A x = b \f$ with a solver \a s two functions must be called:
     s.compute(A) and s.solve(b). The calls can be chained as in  s.compute(A).solve(b).
 
+    The call of compute(A) can be split into analyzePattern(A),
+    which performs the ordering and symbolic analysis depending only
+    on the sparsity pattern, and factorize(A), which performs the
+    numerical factorization. When a sequence of matrices with the same
+    pattern is solved (eg. in Newton or time-stepping iterations),
+    analyzePattern needs to be called only once:
+    \code
+    solver.analyzePattern(A);
+    for (...)
+    {
+        // modify the values (not the pattern) of A
+        x = solver.factorize(A).solve(b);
+    }
+    \endcode
+
 
     Moreover, a collection of available sparse solvers is given as typedefs
     Example of usage:
@@ -86,6 +101,13 @@ public:
 
     virtual gsSparseSolver& compute (const MatrixT &matrix) = 0;
 
+    /// Performs the symbolic analysis, which depends only on the sparsity pattern
+    virtual gsSparseSolver& analyzePattern (const MatrixT &matrix) = 0;
+
+    /// Performs the numerical factorization, requires a previous
+    /// call of analyzePattern on a matrix with the same pattern
+    virtual gsSparseSolver& factorize (const MatrixT &matrix) = 0;
+
     virtual VectorT   solve   (const VectorT &rhs)    const = 0;
 
     virtual bool      succeed ()                      const = 0;
@@ -115,6 +137,18 @@ public:
             gsEigenAdaptor<T>::eigenName::compute(matrix);              \
             return *this;                                               \
         }                                                               \
+        gsname& analyzePattern (const MatrixT &matrix)                  \
+        {                                                               \
+            m_rows=matrix.rows();                                       \
+            m_cols=matrix.cols();                                       \
+            gsEigenAdaptor<T>::eigenName::analyzePattern(matrix);       \
+            return *this;                                               \
+        }                                                               \
+        gsname& factorize (const MatrixT &matrix)                       \
+        {                                                               \
+            gsEigenAdaptor<T>::eigenName::factorize(matrix);            \
+            return *this;                                               \
+        }                                                               \
         VectorT solve  (const VectorT &rhs) const                       \
         {                                                               \
             return gsEigenAdaptor<T>::eigenName::solve(rhs);            \
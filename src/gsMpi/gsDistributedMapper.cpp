@@ -0,0 +1,137 @@
+/** @file gsDistributedMapper.cpp
+
+    @brief Provides the numbering of the degrees of freedom of a
+    multipatch problem which is distributed over several processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsMpi/gsDistributedMapper.h>
+
+namespace gismo
+{
+
+gsDistributedMapper::gsDistributedMapper(const gsDofMapper & mapper,
+                                         const std::vector<index_t> & patchRank,
+                                         int rank, int nRanks)
+: m_rank(rank), m_nRanks(nRanks), m_patchRank(patchRank), m_hasGhosts(false),
+  m_global(mapper)
+{
+    GISMO_ASSERT( 0 == mapper.shift(), "Shifted mappers are not supported");
+    GISMO_ENSURE( patchRank.size() == mapper.numPatches(),
+                  "Expected one process per patch, got "<<patchRank.size() );
+    GISMO_ENSURE( rank >= 0 && rank < nRanks, "Invalid rank "<<rank );
+
+    // The owner of a dof is the lowest process of the patches containing it
+    const index_t nFree = mapper.freeSize();
+    std::vector<index_t> own(nFree, nRanks);
+    for ( size_t k = 0; k != mapper.numPatches(); ++k )
+    {
+        GISMO_ENSURE( patchRank[k] >= 0 && patchRank[k] < nRanks,
+                      "Invalid process "<<patchRank[k]<<" of patch "<<k );
+        const size_t last = (k + 1 == mapper.numPatches() ? mapper.mapSize()
+                             : mapper.offset(k + 1) );
+        for ( size_t n = mapper.offset(k); n != last; ++n )
+        {
+            const index_t g = mapper.mapIndex(n);
+            if ( mapper.is_free_index(g) && patchRank[k] < own[g] )
+                own[g] = patchRank[k];
+        }
+    }
+
+    init(own);
+}
+
+gsDistributedMapper::gsDistributedMapper(const gsDofMapper & mapper, int rank, int nRanks,
+                                         const std::vector<index_t> & dofRank)
+: m_rank(rank), m_nRanks(nRanks), m_hasGhosts(false), m_global(mapper)
+{
+    GISMO_ASSERT( 0 == mapper.shift(), "Shifted mappers are not supported");
+    GISMO_ENSURE( static_cast<index_t>(dofRank.size()) == mapper.freeSize(),
+                  "Expected one process per free dof, got "<<dofRank.size() );
+    GISMO_ENSURE( rank >= 0 && rank < nRanks, "Invalid rank "<<rank );
+    init(dofRank);
+}
+
+void gsDistributedMapper::init(const std::vector<index_t> & own)
+{
+    // Number the dofs of every process contiguously, keeping their order
+    const index_t nFree = m_global.freeSize();
+    const int nRanks = m_nRanks;
+    m_first.assign(nRanks + 1, 0);
+    for ( index_t g = 0; g != nFree; ++g )
+    {
+        GISMO_ASSERT( own[g] >= 0 && own[g] < nRanks, "Invalid owner of dof "<<g );
+        ++m_first[ own[g] + 1 ];
+    }
+    for ( int r = 0; r != nRanks; ++r )
+        m_first[r+1] += m_first[r];
+
+    std::vector<index_t> next(m_first.begin(), m_first.end() - 1);
+    gsVector<index_t> perm(nFree);
+    for ( index_t g = 0; g != nFree; ++g )
+        perm[g] = next[ own[g] ]++;
+    m_global.permuteFreeDofs(perm);
+
+    setGhosts( std::vector<index_t>(), std::vector<index_t>() );
+    m_hasGhosts = false;
+}
+
+int gsDistributedMapper::owner(index_t g) const
+{
+    GISMO_ASSERT( g >= 0 && g < globalSize(), "Invalid global index "<<g );
+    return static_cast<int>( std::upper_bound(m_first.begin(), m_first.end(), g)
+                             - m_first.begin() ) - 1;
+}
+
+index_t gsDistributedMapper::localIndex(index_t g) const
+{
+    if ( isOwned(g) )
+        return g - firstOwned();
+    const std::vector<index_t>::const_iterator it =
+        std::lower_bound(m_ghosts.begin(), m_ghosts.end(), g);
+    return ( it != m_ghosts.end() && *it == g ) ?
+        numOwned() + static_cast<index_t>(it - m_ghosts.begin()) : -1;
+}
+
+void gsDistributedMapper::setGhosts(std::vector<index_t> ghosts,
+                                    std::vector<index_t> ifaceDofs)
+{
+    std::sort(ghosts.begin(), ghosts.end());
+    ghosts.erase( std::unique(ghosts.begin(), ghosts.end()), ghosts.end() );
+    m_ghosts.swap(ghosts);
+    std::sort(ifaceDofs.begin(), ifaceDofs.end());
+    ifaceDofs.erase( std::unique(ifaceDofs.begin(), ifaceDofs.end()), ifaceDofs.end() );
+    m_interface.swap(ifaceDofs);
+    m_hasGhosts = true;
+    for ( size_t i = 0; i != m_ghosts.size(); ++i )
+        GISMO_ASSERT( !isOwned(m_ghosts[i]) && m_ghosts[i] < globalSize(),
+                      "Ghosts must be free dofs which are not owned");
+
+    const index_t nLocal = localSize();
+    const index_t nElim  = m_global.boundarySize();
+    std::vector<index_t> dofs( m_global.mapSize() );
+    for ( size_t n = 0; n != dofs.size(); ++n )
+    {
+        const index_t g = m_global.mapIndex(n);
+        if ( m_global.is_free_index(g) )
+        {
+            const index_t l = localIndex(g);
+            dofs[n] = ( l < 0 ? nLocal + nElim : l );
+        }
+        else
+            dofs[n] = nLocal + m_global.global_to_bindex(g);
+    }
+
+    std::vector<std::size_t> offsets( m_global.numPatches() );
+    for ( size_t k = 0; k != offsets.size(); ++k )
+        offsets[k] = m_global.offset(k);
+
+    m_local.setMapping(dofs, offsets, nLocal, 0, nElim + 1);
+}
+
+} // namespace gismo
@@ -0,0 +1,226 @@
+/** @file gsDistributedMapper.h
+
+    @brief Provides the numbering of the degrees of freedom of a
+    multipatch problem which is distributed over several processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsCore/gsMultiBasis.h>
+#include <gsCore/gsDomainIterator.h>
+
+namespace gismo
+{
+
+/**
+   @brief Distributes the free degrees of freedom of a dof mapper over
+   the processes of a communicator.
+
+   Every patch is assigned to a process. A dof is \em owned by the
+   process with the lowest rank among the processes of the patches
+   containing it, and the free dofs are renumbered such that the
+   dofs owned by process \em r form the contiguous range
+   [firstOwned(r), firstOwned(r) + numOwned(r)) of the global
+   numbering, see globalMapper().
+
+   The \em ghosts of a process are the dofs which are not owned but
+   are coupled to owned dofs, and its \em interface dofs are the
+   owned dofs which are coupled to dofs of other processes, see
+   setGhosts(). The owned dofs followed by the ghosts form the local
+   numbering of the process, see localIndex() and localMapper().
+
+   \ingroup Mpi
+*/
+class GISMO_EXPORT gsDistributedMapper
+{
+public:
+
+    gsDistributedMapper() : m_rank(0), m_nRanks(1), m_hasGhosts(false) { }
+
+    /**
+       \brief Distributes the free dofs of \a mapper
+
+       \param mapper a finalized dof mapper (without shift)
+       \param patchRank the process of every patch of \a mapper
+       \param rank the rank of this process
+       \param nRanks the number of processes
+    */
+    gsDistributedMapper(const gsDofMapper & mapper,
+                        const std::vector<index_t> & patchRank,
+                        int rank, int nRanks);
+
+    /**
+       \brief Distributes the free dofs of \a mapper to given owners
+
+       \param mapper a finalized dof mapper (without shift)
+       \param rank the rank of this process
+       \param nRanks the number of processes
+       \param dofRank the process owning every free dof of \a mapper
+    */
+    gsDistributedMapper(const gsDofMapper & mapper, int rank, int nRanks,
+                        const std::vector<index_t> & dofRank);
+
+    /// The rank of this process
+    int rank() const { return m_rank; }
+
+    /// The number of processes
+    int nRanks() const { return m_nRanks; }
+
+    /// The process of every patch (empty if the owners of the dofs were given)
+    const std::vector<index_t> & patchRank() const { return m_patchRank; }
+
+    /// \brief The renumbered dof mapper, in which the owned dofs of
+    /// every process are contiguous
+    const gsDofMapper & globalMapper() const { return m_global; }
+
+    /// \brief The dof mapper of the local numbering: owned dofs and
+    /// ghosts are free, all other dofs are eliminated (see setGhosts())
+    const gsDofMapper & localMapper() const { return m_local; }
+
+    /// The number of (free) dofs over all processes
+    index_t globalSize() const { return m_first.back(); }
+
+    /// The first global index owned by process \a r
+    index_t firstOwned(int r) const { return m_first[r]; }
+
+    /// The first global index owned by this process
+    index_t firstOwned() const { return m_first[m_rank]; }
+
+    /// The number of dofs owned by process \a r
+    index_t numOwned(int r) const { return m_first[r+1] - m_first[r]; }
+
+    /// The number of dofs owned by this process
+    index_t numOwned() const { return numOwned(m_rank); }
+
+    /// The process owning the global dof \a g
+    int owner(index_t g) const;
+
+    /// True if the global dof \a g is owned by this process
+    bool isOwned(index_t g) const
+    { return g >= m_first[m_rank] && g < m_first[m_rank+1]; }
+
+    /// The global indices of the ghosts, in ascending order
+    const std::vector<index_t> & ghosts() const { return m_ghosts; }
+
+    /// \brief The global indices of the owned dofs which are coupled
+    /// to dofs of other processes, in ascending order
+    const std::vector<index_t> & interfaceDofs() const { return m_interface; }
+
+    /// True if the ghosts have been set by setGhosts()
+    bool hasGhosts() const { return m_hasGhosts; }
+
+    /// The number of owned dofs and ghosts
+    index_t localSize() const { return numOwned() + static_cast<index_t>(m_ghosts.size()); }
+
+    /// \brief The local index of the global dof \a g, or -1 if \a g
+    /// is neither owned nor a ghost
+    index_t localIndex(index_t g) const;
+
+    /// The global index of the local dof \a l
+    index_t globalIndex(index_t l) const
+    { return l < numOwned() ? firstOwned() + l : m_ghosts[l - numOwned()]; }
+
+    /**
+       \brief Sets the ghosts, the interface dofs and the local mapper.
+
+       Two dofs are coupled if they are active on a common element of
+       \a bases. Only the elements of the patches containing owned
+       dofs and dofs of other processes are visited: these are the
+       patches which share an interface of the topology of \a bases
+       with patches of other processes (the dofs on the interfaces
+       being shared by the adjacent patches in the dof mapper), and
+       the patches which are split between processes.
+
+       In the local mapper the dofs of the global mapper keep their
+       boundary index, and all free dofs which are neither owned nor
+       ghosts are mapped to one additional eliminated dof (with
+       boundary index globalMapper().boundarySize()). Hence, a system
+       assembled with the local mapper has the owned rows and the
+       ghost rows, and values of eliminated dofs computed with it
+       contain one more row.
+    */
+    template<class T>
+    void setGhosts(const gsMultiBasis<T> & bases);
+
+private:
+
+    /// Sets the ghosts and the interface dofs and sets up the local mapper
+    void setGhosts(std::vector<index_t> ghosts, std::vector<index_t> ifaceDofs);
+
+    /// Renumbers the free dofs of m_global by their owners \a own
+    void init(const std::vector<index_t> & own);
+
+private:
+
+    int m_rank, m_nRanks;
+
+    std::vector<index_t> m_patchRank;
+
+    /// First owned global index of every process, and the global size
+    std::vector<index_t> m_first;
+
+    std::vector<index_t> m_ghosts, m_interface;
+
+    bool m_hasGhosts;
+
+    gsDofMapper m_global, m_local;
+};
+
+template<class T>
+void gsDistributedMapper::setGhosts(const gsMultiBasis<T> & bases)
+{
+    GISMO_ENSURE( bases.nBases() == m_global.numPatches(),
+                  "The bases do not match the mapper");
+
+    // The patches with owned and not owned dofs; the dofs on the
+    // interfaces of the topology are shared by the adjacent patches
+    const size_t np = bases.nBases();
+    std::vector<bool> scan(np, false);
+    for ( size_t k = 0; k != np; ++k )
+    {
+        const size_t last = (k + 1 == np ? m_global.mapSize() : m_global.offset(k + 1));
+        bool owned = false, other = false;
+        for ( size_t n = m_global.offset(k); n != last && !(owned && other); ++n )
+        {
+            const index_t g = m_global.mapIndex(n);
+            if ( m_global.is_free_index(g) )
+                ( isOwned(g) ? owned : other ) = true;
+        }
+        scan[k] = owned && other;
+    }
+
+    std::vector<index_t> ghosts, ifaceDofs;
+    gsMatrix<unsigned> act;
+    gsMatrix<T> center;
+    for ( size_t k = 0; k != np; ++k )
+    {
+        if ( !scan[k] )
+            continue;
+        typename gsBasis<T>::domainIter domIt = bases[k].makeDomainIterator();
+        for (; domIt->good(); domIt->next() )
+        {
+            center = ( domIt->lowerCorner() + domIt->upperCorner() ) / 2;
+            bases[k].active_into(center, act);
+            m_global.localToGlobal(act, k, act);
+            bool owned = false, other = false;
+            for ( index_t i = 0; i != act.rows(); ++i )
+                if ( m_global.is_free_index(act(i,0)) )
+                    ( isOwned(act(i,0)) ? owned : other ) = true;
+            if ( !owned || !other )
+                continue;
+            for ( index_t i = 0; i != act.rows(); ++i )
+                if ( m_global.is_free_index(act(i,0)) )
+                    ( isOwned(act(i,0)) ? ifaceDofs : ghosts ).push_back(act(i,0));
+        }
+    }
+    setGhosts(ghosts, ifaceDofs);
+}
+
+} // namespace gismo
@@ -0,0 +1,162 @@
+/** @file gsDistributedMatrix.h
+
+    @brief Provides sparse matrices and vectors which are distributed
+    row-wise over several processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsMpi/gsDistributedMapper.h>
+#include <gsMpi/gsMpiComm.h>
+
+namespace gismo
+{
+
+/**
+   @brief A sparse matrix distributed row-wise according to a
+   gsDistributedMapper.
+
+   Every process stores the rows of its owned dofs. The columns are
+   numbered locally, i.e. the owned dofs first and the ghosts after
+   them (see gsDistributedMapper::localIndex()), such that a product
+   with a vector needs the owned entries and the ghost entries of the
+   vector only.
+
+   The mapper is referenced and must outlive the matrix.
+
+   \ingroup Mpi
+*/
+template<class T>
+class gsDistributedMatrix
+{
+public:
+    typedef gsSparseMatrix<T, RowMajor> LocalMatrix;
+
+public:
+
+    gsDistributedMatrix() : m_mapper(NULL) { }
+
+    explicit gsDistributedMatrix(const gsDistributedMapper & mapper)
+    : m_mapper(&mapper), m_local(mapper.numOwned(), mapper.localSize())
+    { }
+
+    const gsDistributedMapper & mapper() const { return *m_mapper; }
+
+    /// Number of rows over all processes
+    index_t rows() const { return m_mapper->globalSize(); }
+
+    /// Number of columns over all processes
+    index_t cols() const { return m_mapper->globalSize(); }
+
+    /// The global index of the first local row
+    index_t firstRow() const { return m_mapper->firstOwned(); }
+
+    /// The owned rows, with local column indices
+    LocalMatrix & local() { return m_local; }
+    const LocalMatrix & local() const { return m_local; }
+
+    /// Returns the owned rows with global column indices
+    void globalRows(LocalMatrix & result) const
+    {
+        result.resize(m_local.rows(), cols());
+        gsVector<index_t> nz(m_local.rows());
+        for ( index_t i = 0; i != m_local.rows(); ++i )
+            nz[i] = m_local.outerIndexPtr()[i+1] - m_local.outerIndexPtr()[i];
+        result.reserve(nz);
+        for ( index_t i = 0; i != m_local.outerSize(); ++i )
+            for ( typename LocalMatrix::InnerIterator it(m_local, i); it; ++it )
+                result.insert(i, m_mapper->globalIndex(it.col())) = it.value();
+        result.makeCompressed();
+    }
+
+private:
+
+    const gsDistributedMapper * m_mapper;
+
+    LocalMatrix m_local;
+};
+
+/**
+   @brief A (multi-column) vector distributed row-wise according to a
+   gsDistributedMapper: every process stores the rows of its owned
+   dofs.
+
+   The mapper is referenced and must outlive the vector.
+
+   \ingroup Mpi
+*/
+template<class T>
+class gsDistributedVector
+{
+public:
+
+    gsDistributedVector() : m_mapper(NULL) { }
+
+    /// Zero vector with \a cols columns
+    explicit gsDistributedVector(const gsDistributedMapper & mapper, index_t cols = 1)
+    : m_mapper(&mapper)
+    { m_local.setZero(mapper.numOwned(), cols); }
+
+    const gsDistributedMapper & mapper() const { return *m_mapper; }
+
+    /// Number of rows over all processes
+    index_t rows() const { return m_mapper->globalSize(); }
+
+    index_t cols() const { return m_local.cols(); }
+
+    /// The global index of the first local row
+    index_t firstRow() const { return m_mapper->firstOwned(); }
+
+    /// The owned rows
+    gsMatrix<T> & local() { return m_local; }
+    const gsMatrix<T> & local() const { return m_local; }
+
+    /// \brief The inner product with \a other (summed over all
+    /// columns) over the processes of \a comm
+    T dot(const gsDistributedVector & other, const gsMpiComm & comm) const
+    {
+        GISMO_ASSERT( other.local().rows() == m_local.rows() &&
+                      other.cols() == cols(), "The vectors do not match");
+        T result = ( m_local.array() * other.local().array() ).sum();
+        return comm.sum(result);
+    }
+
+    /// The Euclidean (Frobenius) norm over the processes of \a comm
+    T norm(const gsMpiComm & comm) const
+    {
+        T result = m_local.squaredNorm();
+        return math::sqrt( comm.sum(result) );
+    }
+
+    /// Collects the complete vector on every process of \a comm
+    void gather(const gsMpiComm & comm, gsMatrix<T> & result) const
+    {
+        const int np = m_mapper->nRanks();
+        GISMO_ENSURE( comm.size() == np, "The communicator does not match the mapper");
+        std::vector<int> len(np), displ(np);
+        for ( int r = 0; r != np; ++r )
+        {
+            len  [r] = static_cast<int>( m_mapper->numOwned(r) );
+            displ[r] = static_cast<int>( m_mapper->firstOwned(r) );
+        }
+        result.resize(rows(), cols());
+        for ( index_t c = 0; c != cols(); ++c )
+            comm.allgatherv(const_cast<T*>(m_local.data()) + c * m_local.rows(),
+                            len[comm.rank()], result.col(c).data(), &len[0], &displ[0]);
+    }
+
+private:
+
+    const gsDistributedMapper * m_mapper;
+
+    gsMatrix<T> m_local;
+};
+
+} // namespace gismo
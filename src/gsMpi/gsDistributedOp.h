@@ -0,0 +1,105 @@
+/** @file gsDistributedOp.h
+
+    @brief Linear operator given by a matrix which is distributed over
+    several processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsLinearOperator.h>
+#include <gsMpi/gsDistributedMatrix.h>
+#include <gsMpi/gsHaloExchange.h>
+
+namespace gismo
+{
+
+/**
+   @brief Applies a gsDistributedMatrix to vectors which hold the
+   owned rows of the process.
+
+   The operator is square of the size of the owned dofs, hence the
+   iterative solvers (e.g. gsConjugateGradient, gsGMRes,
+   gsMinimalResidual) run on the owned parts of the vectors, once the
+   communicator is passed to them (see
+   gsIterativeSolver::setCommunicator()):
+
+   \verbatim
+   gsDistributedOp<>::Ptr op = gsDistributedOp<>::make(A, comm);
+   gsConjugateGradient cg(op);
+   cg.setCommunicator(comm);
+   cg.solve(b.local(), x.local());
+   \endverbatim
+
+   The ghost values are exchanged with gsHaloExchange while the
+   columns of the owned dofs are applied.
+
+   The matrix and its mapper are referenced and must outlive the
+   operator.
+
+   \ingroup Mpi
+*/
+template<class T>
+class gsDistributedOp : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for gsDistributedOp
+    typedef typename memory::shared<gsDistributedOp>::ptr Ptr;
+
+    /// Unique pointer for gsDistributedOp
+    typedef typename memory::unique<gsDistributedOp>::ptr uPtr;
+
+    typedef typename gsDistributedMatrix<T>::LocalMatrix LocalMatrix;
+
+    /// Constructor; collective over \a comm
+    gsDistributedOp(const gsDistributedMatrix<T> & A, const gsMpiComm & comm)
+    : m_mapper(A.mapper()), m_halo(A.mapper(), comm, 1),
+      m_x(A.mapper().localSize(), 1)
+    {
+        // The columns of the owned dofs and of the ghosts
+        const index_t n = m_mapper.numOwned();
+        m_owned = A.local().leftCols(n);
+        m_ghost = A.local().rightCols(A.local().cols() - n);
+    }
+
+    /// Make command returning a shared pointer
+    static Ptr make(const gsDistributedMatrix<T> & A, const gsMpiComm & comm)
+    { return memory::make_shared( new gsDistributedOp(A, comm) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        const index_t n = m_mapper.numOwned();
+        GISMO_ASSERT( input.rows() == n, "Expected the owned rows of a vector");
+        x.resize(n, input.cols());
+        for ( index_t c = 0; c != input.cols(); ++c )
+        {
+            m_x.topRows(n) = input.col(c);
+            m_halo.start(m_x);
+            x.col(c).noalias() = m_owned * input.col(c);
+            m_halo.finish(m_x);
+            x.col(c).noalias() += m_ghost * m_x.bottomRows(m_x.rows() - n);
+        }
+    }
+
+    index_t rows() const { return m_mapper.numOwned(); }
+
+    index_t cols() const { return m_mapper.numOwned(); }
+
+private:
+
+    const gsDistributedMapper & m_mapper;
+
+    // The exchange of the ghost values and the locally numbered vector
+    mutable gsHaloExchange<T> m_halo;
+    mutable gsMatrix<T> m_x;
+
+    LocalMatrix m_owned, m_ghost;
+};
+
+} // namespace gismo
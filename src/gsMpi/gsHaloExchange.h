@@ -0,0 +1,211 @@
+/** @file gsHaloExchange.h
+
+    @brief Provides the exchange of the ghost values of distributed
+    vectors between neighbouring processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsMpi/gsMpi.h>
+#include <gsMpi/gsDistributedMapper.h>
+
+namespace gismo
+{
+
+/**
+   @brief Updates the ghost values of locally numbered vectors (see
+   gsDistributedMapper) with the values of their owners.
+
+   The neighbours of a process are the processes owning its ghosts
+   and the processes having its owned dofs as ghosts, i.e. the
+   processes sharing patch interfaces with it. The communication
+   pattern is set up once by the constructor, and every exchange uses
+   persistent requests on fixed buffers. The exchange can be overlapped
+   with computation on the owned values:
+
+   \verbatim
+   mapper.setGhosts(bases);
+   gsHaloExchange<> halo(mapper, comm);
+   halo.start(x);      // x has mapper.localSize() rows
+   // ... work with the owned rows of x
+   halo.finish(x);     // now the ghost rows of x are up to date
+   \endverbatim
+
+   With a serial communicator (or a single process) there are no
+   neighbours and the exchange does nothing.
+
+   The object can not be copied, since the requests are bound to its
+   buffers.
+
+   \ingroup Mpi
+*/
+template<class T>
+class gsHaloExchange
+{
+public:
+
+    /// \brief Sets up the exchange of vectors with \a cols columns
+    /// numbered locally by \a mapper. Collective over \a comm.
+    gsHaloExchange(const gsDistributedMapper & mapper, const gsMpiComm & comm,
+                   index_t cols = 1)
+    : m_mapper(mapper), m_cols(cols)
+    {
+        GISMO_ENSURE( comm.size() == mapper.nRanks() && comm.rank() == mapper.rank(),
+                      "The communicator does not match the mapper");
+        GISMO_ENSURE( mapper.hasGhosts(), "The ghosts of the mapper are not set");
+        const int np = mapper.nRanks();
+        const std::vector<index_t> & ghosts = mapper.ghosts();
+
+        // The ghosts are sorted, hence grouped by their owners
+        std::vector<int> cnt(np, 0);
+        for ( size_t i = 0; i != ghosts.size(); ++i )
+            ++cnt[ mapper.owner(ghosts[i]) ];
+        m_recvPtr.push_back(0);
+        for ( int q = 0; q != np; ++q )
+            if ( cnt[q] )
+            {
+                m_recvFrom.push_back(q);
+                m_recvPtr.push_back(m_recvPtr.back() + cnt[q]);
+            }
+
+        // Number of ghosts of every process owned by every process
+        std::vector<int> all(np * np);
+        comm.allgather(&cnt[0], np, &all[0]);
+        m_sendPtr.push_back(0);
+        for ( int p = 0; p != np; ++p )
+            if ( const int c = all[p * np + mapper.rank()] )
+            {
+                m_sendTo.push_back(p);
+                m_sendPtr.push_back(m_sendPtr.back() + c);
+            }
+        m_sendIdx.resize(m_sendPtr.back());
+
+#ifdef GISMO_WITH_MPI
+        // Ask the owners for the ghosts
+        std::vector<MPI_Request> req(m_recvFrom.size() + m_sendTo.size());
+        for ( size_t i = 0; i != m_recvFrom.size(); ++i )
+            comm.isend(&ghosts[m_recvPtr[i]], m_recvPtr[i+1] - m_recvPtr[i],
+                       m_recvFrom[i], &req[i]);
+        for ( size_t i = 0; i != m_sendTo.size(); ++i )
+            comm.irecv(&m_sendIdx[m_sendPtr[i]], m_sendPtr[i+1] - m_sendPtr[i],
+                       m_sendTo[i], &req[m_recvFrom.size() + i]);
+        if ( !req.empty() )
+            MPI_Waitall(static_cast<int>(req.size()), &req[0], MPI_STATUSES_IGNORE);
+#endif
+        for ( size_t i = 0; i != m_sendIdx.size(); ++i )
+            m_sendIdx[i] -= mapper.firstOwned();
+
+        // Buffers hold the rows of every neighbour contiguously
+        m_sendBuf.resize(m_sendIdx.size() * cols);
+        m_recvBuf.resize(ghosts.size() * cols);
+#ifdef GISMO_WITH_MPI
+        m_requests.resize(m_sendTo.size() + m_recvFrom.size());
+        for ( size_t i = 0; i != m_sendTo.size(); ++i )
+            comm.sendInit(&m_sendBuf[0] + m_sendPtr[i] * cols,
+                          (m_sendPtr[i+1] - m_sendPtr[i]) * cols,
+                          m_sendTo[i], &m_requests[i], 1);
+        for ( size_t i = 0; i != m_recvFrom.size(); ++i )
+            comm.recvInit(&m_recvBuf[0] + m_recvPtr[i] * cols,
+                          (m_recvPtr[i+1] - m_recvPtr[i]) * cols,
+                          m_recvFrom[i], &m_requests[m_sendTo.size() + i], 1);
+#endif
+    }
+
+    ~gsHaloExchange()
+    {
+#ifdef GISMO_WITH_MPI
+        for ( size_t i = 0; i != m_requests.size(); ++i )
+            MPI_Request_free(&m_requests[i]);
+#endif
+    }
+
+    /// \brief Starts sending the owned values of \a x needed by the
+    /// neighbours and receiving the ghost values
+    void start(const gsMatrix<T> & x)
+    {
+        GISMO_ASSERT( x.rows() == m_mapper.localSize() && x.cols() == m_cols,
+                      "Expected a locally numbered vector with "<<m_cols<<" columns");
+        for ( size_t i = 0; i + 1 < m_sendPtr.size(); ++i )
+        {
+            T * buf = &m_sendBuf[0] + m_sendPtr[i] * m_cols;
+            for ( index_t c = 0; c != m_cols; ++c )
+                for ( index_t k = m_sendPtr[i]; k != m_sendPtr[i+1]; ++k )
+                    *buf++ = x(m_sendIdx[k], c);
+        }
+#ifdef GISMO_WITH_MPI
+        if ( !m_requests.empty() )
+            MPI_Startall(static_cast<int>(m_requests.size()), &m_requests[0]);
+#endif
+    }
+
+    /// \brief Completes the exchange started by start(\a x), writing
+    /// the ghost values into the ghost rows of \a x
+    void finish(gsMatrix<T> & x)
+    {
+#ifdef GISMO_WITH_MPI
+        if ( !m_requests.empty() )
+            MPI_Waitall(static_cast<int>(m_requests.size()), &m_requests[0],
+                        MPI_STATUSES_IGNORE);
+#endif
+        const index_t nOwned = m_mapper.numOwned();
+        for ( size_t i = 0; i + 1 < m_recvPtr.size(); ++i )
+        {
+            const T * buf = &m_recvBuf[0] + m_recvPtr[i] * m_cols;
+            for ( index_t c = 0; c != m_cols; ++c )
+                for ( index_t k = m_recvPtr[i]; k != m_recvPtr[i+1]; ++k )
+                    x(nOwned + k, c) = *buf++;
+        }
+    }
+
+    /// Updates the ghost values of \a x
+    void exchange(gsMatrix<T> & x)
+    {
+        start(x);
+        finish(x);
+    }
+
+    /// The processes sending ghost values to this process
+    const std::vector<int> & recvFrom() const { return m_recvFrom; }
+
+    /// The processes receiving owned values of this process
+    const std::vector<int> & sendTo() const { return m_sendTo; }
+
+    /// The local indices of the owned dofs sent to the neighbour sendTo()[i]
+    gsAsConstVector<index_t> sendIndices(size_t i) const
+    {
+        return gsAsConstVector<index_t>(&m_sendIdx[0] + m_sendPtr[i],
+                                        m_sendPtr[i+1] - m_sendPtr[i]);
+    }
+
+private:
+
+    const gsDistributedMapper & m_mapper;
+
+    index_t m_cols;
+
+    /// Neighbours, and the positions of their rows in the buffers
+    std::vector<int>     m_recvFrom, m_sendTo;
+    std::vector<index_t> m_recvPtr , m_sendPtr;
+
+    /// Local indices of the owned dofs to send
+    std::vector<index_t> m_sendIdx;
+
+    std::vector<T> m_sendBuf, m_recvBuf;
+
+#ifdef GISMO_WITH_MPI
+    std::vector<MPI_Request> m_requests;
+#endif
+
+private:
+    gsHaloExchange(const gsHaloExchange &);
+    gsHaloExchange & operator=(const gsHaloExchange &);
+};
+
+} // namespace gismo
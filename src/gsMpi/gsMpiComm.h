@@ -364,7 +364,7 @@ public:
         }
     }
    
-    gsMpiComm(const gsSerialComm &) : m_comm(MPI_COMM_SELF) { }
+    gsMpiComm(const gsSerialComm &) : rank_(0), size_(1), m_comm(MPI_COMM_SELF) { }
     
     /**
      * @brief The type of the mpi communicator.
@@ -593,6 +593,83 @@ public:
                               m_comm);
     }
 
+    /// @brief Sends \a count values of \a buf to process \a dest
+    template<typename T>
+    int send (const T* buf, int count, int dest, int tag = 0) const
+    {
+        return MPI_Send(const_cast<T*>(buf), count, MPITraits<T>::getType(),
+                        dest, tag, m_comm);
+    }
+
+    /// @brief Receives \a count values from process \a source into \a buf
+    template<typename T>
+    int recv (T* buf, int count, int source, int tag = 0,
+              MPI_Status* status = MPI_STATUS_IGNORE) const
+    {
+        return MPI_Recv(buf, count, MPITraits<T>::getType(),
+                        source, tag, m_comm, status);
+    }
+
+    /// @brief Starts sending \a count values of \a buf to process
+    /// \a dest; \a buf must not be modified until \a req is completed
+    template<typename T>
+    int isend (const T* buf, int count, int dest, MPI_Request* req, int tag = 0) const
+    {
+        return MPI_Isend(const_cast<T*>(buf), count, MPITraits<T>::getType(),
+                         dest, tag, m_comm, req);
+    }
+
+    /// @brief Starts receiving \a count values from process \a source
+    /// into \a buf, which is valid after \a req is completed
+    template<typename T>
+    int irecv (T* buf, int count, int source, MPI_Request* req, int tag = 0) const
+    {
+        return MPI_Irecv(buf, count, MPITraits<T>::getType(),
+                         source, tag, m_comm, req);
+    }
+
+    /// @brief Creates a persistent request for sending \a count
+    /// values of \a buf to process \a dest, see MPI_Startall()
+    template<typename T>
+    int sendInit (const T* buf, int count, int dest, MPI_Request* req, int tag = 0) const
+    {
+        return MPI_Send_init(const_cast<T*>(buf), count, MPITraits<T>::getType(),
+                             dest, tag, m_comm, req);
+    }
+
+    /// @brief Creates a persistent request for receiving \a count
+    /// values from process \a source into \a buf, see MPI_Startall()
+    template<typename T>
+    int recvInit (T* buf, int count, int source, MPI_Request* req, int tag = 0) const
+    {
+        return MPI_Recv_init(buf, count, MPITraits<T>::getType(),
+                             source, tag, m_comm, req);
+    }
+
+    /// @brief Sends the coefficients of the matrix \a m to process \a dest
+    template<typename T, int _Rows, int _Cols, int _Options>
+    int send (const gsMatrix<T,_Rows,_Cols,_Options> & m, int dest, int tag = 0) const
+    { return send(m.data(), static_cast<int>(m.size()), dest, tag); }
+
+    /// @brief Receives the coefficients of the matrix \a m from process
+    /// \a source; \a m must have the size of the sent matrix
+    template<typename T, int _Rows, int _Cols, int _Options>
+    int recv (gsMatrix<T,_Rows,_Cols,_Options> & m, int source, int tag = 0) const
+    { return recv(m.data(), static_cast<int>(m.size()), source, tag); }
+
+    /// @copydoc isend(const T*,int,int,MPI_Request*,int) const
+    template<typename T, int _Rows, int _Cols, int _Options>
+    int isend (const gsMatrix<T,_Rows,_Cols,_Options> & m, int dest,
+               MPI_Request* req, int tag = 0) const
+    { return isend(m.data(), static_cast<int>(m.size()), dest, req, tag); }
+
+    /// @brief Starts receiving the coefficients of the matrix \a m
+    /// from process \a source; \a m must have the size of the sent matrix
+    template<typename T, int _Rows, int _Cols, int _Options>
+    int irecv (gsMatrix<T,_Rows,_Cols,_Options> & m, int source,
+               MPI_Request* req, int tag = 0) const
+    { return irecv(m.data(), static_cast<int>(m.size()), source, req, tag); }
+
 #ifndef MPI_IN_PLACE
  #define MPI_IN_PLACE inout
  #define MASK_MPI_IN_PLACE
@@ -0,0 +1,314 @@
+/** @file gsMpiFileData.cpp
+
+    @brief Collective reading and writing of the objects of several
+    processes in one binary container file.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsMpi/gsMpiFileData.h>
+
+#include <rapidxml/rapidxml.hpp>
+
+#include <climits>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#endif
+
+namespace gismo
+{
+
+namespace
+{
+
+// Calls f(node) for every raw node below node
+template<class F>
+void forRawNodes(internal::gsXmlNode * node, F & f)
+{
+    for ( internal::gsXmlNode * child = node->first_node(); child;
+          child = child->next_sibling() )
+        forRawNodes(child, f);
+    size_t offset, nbytes;
+    if ( internal::rawBlock(node, offset, nbytes) )
+        f(node, offset, nbytes);
+}
+
+// The range of the data blocks of the raw nodes
+struct BlockRange
+{
+    BlockRange() : first(static_cast<size_t>(-1)), last(0) { }
+    void operator()(internal::gsXmlNode *, size_t offset, size_t nbytes)
+    {
+        first = std::min(first, offset);
+        last  = std::max(last , offset + nbytes);
+    }
+    size_t first, last;
+};
+
+// Points the raw nodes to their data in a buffer holding the blocks
+// from position first on
+struct AttachBlocks
+{
+    AttachBlocks(const char * b, size_t f) : buffer(b), first(f) { }
+    void operator()(internal::gsXmlNode * node, size_t offset, size_t nbytes)
+    { node->value(buffer + offset - first, nbytes); }
+    const char * buffer;
+    size_t first;
+};
+
+struct DetachBlocks
+{
+    void operator()(internal::gsXmlNode * node, size_t, size_t)
+    { node->value("", 0); }
+};
+
+// MPI counts are int, larger transfers are split
+const size_t s_maxChunk = INT_MAX / 2;
+
+// Sets the position of fh to offset, also beyond 2 GiB; true on success
+bool seekTo(std::FILE * fh, const size_t offset)
+{
+#if defined(_WIN32)
+    return 0 == _fseeki64(fh, static_cast<__int64>(offset), SEEK_SET);
+#elif defined(__unix__) || defined(__APPLE__)
+    return 0 == fseeko(fh, static_cast<off_t>(offset), SEEK_SET);
+#else
+    return offset <= LONG_MAX && 0 == std::fseek(fh, static_cast<long>(offset), SEEK_SET);
+#endif
+}
+
+}
+
+gsMpiFileData::gsMpiFileData(const gsMpiComm & comm)
+: m_comm(comm), m_data(new FileData), m_dataOffset(0), m_open(false)
+{
+    m_data->makeRoot();
+    // The matrices go to the data blocks
+    m_data->setBinaryMatrices(true);
+}
+
+gsMpiFileData::~gsMpiFileData()
+{
+    closeFile();
+    delete m_data;
+}
+
+void gsMpiFileData::clear()
+{
+    closeFile();
+    m_data->clear();
+    m_data->makeRoot();
+    std::vector<char>().swap(m_buffer);
+}
+
+void gsMpiFileData::closeFile()
+{
+    if ( !m_open )
+        return;
+#ifdef GISMO_WITH_MPI
+    MPI_File_close(&m_file);
+#else
+    std::fclose(m_file);
+#endif
+    m_open = false;
+}
+
+void gsMpiFileData::save(const std::string & fn) const
+{
+    const int rank = m_comm.rank(), np = m_comm.size();
+
+    // Position of the data blocks of every process
+    unsigned long mySize = static_cast<unsigned long>(
+        internal::xmlBinaryDataSize(m_data->getRoot()) );
+    std::vector<unsigned long> sizes(np);
+    m_comm.allgather(&mySize, 1, &sizes[0]);
+    size_t base = 0, dataSize = 0;
+    for ( int r = 0; r != np; ++r )
+    {
+        if ( r == rank )
+            base = dataSize;
+        dataSize += sizes[r];
+    }
+
+    std::string xml;
+    std::vector<char> blocks;
+    internal::packXmlBinary(m_data->getRoot(), base, xml, blocks);
+    GISMO_ASSERT( blocks.size() == mySize, "Unexpected size of the data blocks");
+
+    // Process 0 collects the XML text of all objects
+    int myLen = static_cast<int>(xml.size());
+    std::vector<int> len(np), displ(np, 0);
+    m_comm.gather(&myLen, &len[0], 1, 0);
+    std::vector<char> text;
+    unsigned long dataOffset = 0;
+    if ( 0 == rank )
+    {
+        for ( int r = 1; r != np; ++r )
+            displ[r] = displ[r-1] + len[r-1];
+        const std::string open("<xml>\n"), close("</xml>\n");
+        const size_t xmlSize = open.size() + displ[np-1] + len[np-1] + close.size();
+        text.resize(internal::binaryHeaderSize + xmlSize);
+        dataOffset = internal::writeXmlBinaryHeader(&text[0], xmlSize, dataSize);
+        char * pos = &text[internal::binaryHeaderSize];
+        std::copy(open.begin(), open.end(), pos);
+        m_comm.gatherv(const_cast<char*>(xml.data()), myLen, pos + open.size(),
+                       &len[0], &displ[0], 0);
+        std::copy(close.begin(), close.end(), pos + xmlSize - close.size());
+        text.resize(dataOffset, '\0');
+    }
+    else
+        m_comm.gatherv(const_cast<char*>(xml.data()), myLen, (char*)NULL,
+                       &len[0], &displ[0], 0);
+    m_comm.broadcast(&dataOffset, 1, 0);
+
+#ifdef GISMO_WITH_MPI
+    MPI_File fh;
+    int err = MPI_File_open(m_comm, const_cast<char*>(fn.c_str()),
+                            MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    GISMO_ENSURE( MPI_SUCCESS == err, "gsMpiFileData: Cannot open "<< fn );
+    MPI_File_set_size(fh, 0);
+
+    // The header and the XML text
+    if ( 0 == rank )
+        for ( size_t first = 0; first < text.size(); first += s_maxChunk )
+            MPI_File_write_at(fh, static_cast<MPI_Offset>(first), &text[first],
+                              static_cast<int>( std::min(text.size() - first, s_maxChunk) ),
+                              MPI_BYTE, MPI_STATUS_IGNORE);
+
+    // The data blocks of all processes, in collective chunks
+    unsigned long nChunks = (blocks.size() + s_maxChunk - 1) / s_maxChunk;
+    nChunks = m_comm.max(nChunks);
+    for ( unsigned long c = 0; c != nChunks; ++c )
+    {
+        const size_t first = std::min(blocks.size(), c * s_maxChunk);
+        const size_t n     = std::min(blocks.size() - first, s_maxChunk);
+        MPI_File_write_at_all(fh, static_cast<MPI_Offset>(dataOffset + base + first),
+                              n ? &blocks[first] : NULL, static_cast<int>(n),
+                              MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    MPI_File_close(&fh);
+#else
+    std::FILE * fh = std::fopen(fn.c_str(), "wb");
+    GISMO_ENSURE( fh, "gsMpiFileData: Cannot open "<< fn );
+    std::fwrite(&text[0], 1, text.size(), fh);
+    if ( !blocks.empty() )
+        std::fwrite(&blocks[0], 1, blocks.size(), fh);
+    std::fclose(fh);
+#endif
+}
+
+bool gsMpiFileData::read(const std::string & fn)
+{
+    clear();
+
+    // Process 0 reads the header and the XML text
+    unsigned long info[3] = {0, 0, 0}; // valid, XML size, data offset
+    std::vector<char> text;
+    if ( 0 == m_comm.rank() )
+    {
+        std::FILE * fh = std::fopen(fn.c_str(), "rb");
+        char header[internal::binaryHeaderSize];
+        size_t xmlOffset, xmlSize, dataOffset, dataSize;
+        if ( fh && internal::binaryHeaderSize ==
+             std::fread(header, 1, internal::binaryHeaderSize, fh) &&
+             internal::readXmlBinaryHeader(header, xmlOffset, xmlSize, dataOffset, dataSize) )
+        {
+            text.resize(xmlSize + 1, '\0');
+            if ( seekTo(fh, xmlOffset) &&
+                 xmlSize == std::fread(&text[0], 1, xmlSize, fh) )
+            {
+                info[0] = 1;
+                info[1] = static_cast<unsigned long>(xmlSize);
+                info[2] = static_cast<unsigned long>(dataOffset);
+            }
+        }
+        if ( fh )
+            std::fclose(fh);
+    }
+    m_comm.broadcast(info, 3, 0);
+    if ( !info[0] )
+    {
+        gsWarn << "gsMpiFileData: Invalid binary file: "<< fn <<"\n";
+        return false;
+    }
+
+    m_buffer.resize(info[1] + 1);
+    if ( 0 == m_comm.rank() )
+        m_buffer.swap(text);
+    for ( size_t first = 0; first < info[1]; first += s_maxChunk )
+        m_comm.broadcast(&m_buffer[first],
+                         static_cast<int>( std::min<size_t>(info[1] - first, s_maxChunk) ), 0);
+    m_buffer.back() = '\0';
+    m_data->clear();
+    m_data->parse<0>(&m_buffer[0]);
+    if ( gsXmlNode * root = m_data->getRoot() )
+        m_data->indexChildren(root);
+    m_dataOffset = info[2];
+
+    // Every process reads its data blocks independently
+#ifdef GISMO_WITH_MPI
+    m_open = ( MPI_SUCCESS == MPI_File_open(MPI_COMM_SELF, const_cast<char*>(fn.c_str()),
+                                            MPI_MODE_RDONLY, MPI_INFO_NULL, &m_file) );
+#else
+    m_file = std::fopen(fn.c_str(), "rb");
+    m_open = ( NULL != m_file );
+#endif
+    GISMO_ENSURE( m_open, "gsMpiFileData: Cannot open "<< fn );
+    return true;
+}
+
+gsMpiFileData::gsXmlNode * gsMpiFileData::findId(const int id, const std::string & tag) const
+{
+    gsXmlNode * root = m_data->getRoot();
+    return root ? internal::childById(root, id, tag.c_str()) : NULL;
+}
+
+void gsMpiFileData::loadBlocks(gsXmlNode * node, std::vector<char> & buffer) const
+{
+    BlockRange range;
+    forRawNodes(node, range);
+    if ( range.last <= range.first )
+        return;
+    GISMO_ENSURE( m_open, "gsMpiFileData: No file is open");
+
+    // The blocks of an object are contiguous in the file
+    buffer.resize(range.last - range.first);
+    readAt(m_dataOffset + range.first, &buffer[0], buffer.size());
+    AttachBlocks attach(&buffer[0], range.first);
+    forRawNodes(node, attach);
+}
+
+void gsMpiFileData::unloadBlocks(gsXmlNode * node) const
+{
+    DetachBlocks detach;
+    forRawNodes(node, detach);
+}
+
+void gsMpiFileData::readAt(const size_t offset, char * dst, const size_t n) const
+{
+#ifdef GISMO_WITH_MPI
+    for ( size_t first = 0; first < n; first += s_maxChunk )
+    {
+        MPI_Status status;
+        const int cnt = static_cast<int>( std::min(n - first, s_maxChunk) );
+        int got = 0;
+        const int err = MPI_File_read_at(m_file, static_cast<MPI_Offset>(offset + first),
+                                         dst + first, cnt, MPI_BYTE, &status);
+        MPI_Get_count(&status, MPI_BYTE, &got);
+        GISMO_ENSURE( MPI_SUCCESS == err && got == cnt,
+                      "gsMpiFileData: The file is truncated");
+    }
+#else
+    GISMO_ENSURE( seekTo(m_file, offset) &&
+                  n == std::fread(dst, 1, n, m_file),
+                  "gsMpiFileData: The file is truncated");
+#endif
+}
+
+} // namespace gismo
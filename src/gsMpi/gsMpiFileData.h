@@ -0,0 +1,167 @@
+/** @file gsMpiFileData.h
+
+    @brief Collective reading and writing of the objects of several
+    processes in one binary container file.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsMpi/gsMpi.h>
+#include <gsIO/gsXmlUtils.h>
+
+#include <cstdio>
+
+namespace gismo
+{
+
+/**
+   @brief Reads and writes the objects of the processes of a
+   communicator (e.g. the patches of a partitioned multipatch and the
+   coefficients of a solution) collectively in one G+Smo binary
+   container file (see gsFileData::saveBinary()).
+
+   Every process adds its own objects with ids which are unique over
+   all processes, and save() writes them to one file: process 0
+   writes the XML text of all objects, which serves as an index of
+   the data blocks, and every process writes the coefficients of its
+   objects at their offsets in the file.
+
+   read() reads the XML text on process 0 only and broadcasts it;
+   getId() then reads only the data blocks of the requested object.
+   Hence every process reads its own patches and no process parses or
+   reads the whole file.
+
+   \verbatim
+   gsMpiFileData out(comm);
+   for (size_t i = 0; i != mp.nPatches(); ++i)
+       if ( patchRank[i] == comm.rank() )
+           out.add(mp.patch(i), i);
+   out.save("domain.gsb");
+
+   gsMpiFileData in(comm);
+   in.read("domain.gsb");
+   gsGeometry<>::uPtr patch( in.getId< gsGeometry<> >(i) );
+   \endverbatim
+
+   With MPI the file is accessed with MPI-IO, otherwise with the
+   standard C library. The files can also be read by gsFileData.
+
+   \ingroup Mpi
+*/
+class GISMO_EXPORT gsMpiFileData
+{
+public:
+    typedef internal::gsXmlTree      FileData;
+    typedef internal::gsXmlNode      gsXmlNode;
+
+public:
+
+    explicit gsMpiFileData(const gsMpiComm & comm);
+
+    ~gsMpiFileData();
+
+    const gsMpiComm & comm() const { return m_comm; }
+
+    /// Removes all objects and closes the file
+    void clear();
+
+    /// \brief Adds the object \a obj of this process with the \a id,
+    /// which must be unique over all processes. The matrices of the
+    /// object are stored in binary form.
+    template<class Object>
+    void add(const Object & obj, const int id)
+    {
+        gsXmlNode * node = internal::gsXml<Object>::put(obj, *m_data);
+        GISMO_ENSURE( node, "gsMpiFileData: Cannot write "
+                      << internal::gsXml<Object>::tag() );
+        GISMO_ASSERT( id >= 0, "The ids must be non-negative");
+        node->append_attribute( internal::makeAttribute("id", static_cast<unsigned>(id), *m_data) );
+        m_data->getRoot()->append_node(node);
+    }
+
+    /// \brief Writes the objects of all processes to the binary
+    /// container \a fn (extension .gsb). Collective.
+    void save(const std::string & fn) const;
+
+    /// \brief Opens the binary container \a fn written by save() or
+    /// gsFileData::saveBinary(). Collective; returns false on all
+    /// processes if the file cannot be read.
+    bool read(const std::string & fn);
+
+    /// \brief Returns true if there is an object with tag of \a Object
+    /// and \a id in the file opened by read()
+    template<class Object>
+    bool hasId(const int id) const
+    { return NULL != findId(id, internal::gsXml<Object>::tag()); }
+
+    /// \brief Reads the object with the given \a id from the file
+    /// opened by read(); only the data blocks of this object are read
+    /// from the file. Returns NULL if there is no such object.
+    template<class Object>
+    Object * getId(const int id) const
+    {
+        gsXmlNode * node = findId(id, internal::gsXml<Object>::tag());
+        if ( !node )
+        {
+            gsWarn << "gsMpiFileData: No "<< internal::gsXml<Object>::tag()
+                   <<" with id="<< id <<" found.\n";
+            return NULL;
+        }
+        std::vector<char> buffer;
+        loadBlocks(node, buffer);
+        Object * result = internal::gsXml<Object>::get(node);
+        unloadBlocks(node);
+        return result;
+    }
+
+private:
+
+    /// The child of the root with \a id and \a tag, or NULL
+    gsXmlNode * findId(int id, const std::string & tag) const;
+
+    /// Reads the data blocks of the raw nodes below \a node into
+    /// \a buffer and points the nodes to them
+    void loadBlocks(gsXmlNode * node, std::vector<char> & buffer) const;
+
+    /// Detaches the raw nodes below \a node from their data
+    void unloadBlocks(gsXmlNode * node) const;
+
+    /// Reads \a n bytes at \a offset of the open file into \a dst
+    void readAt(size_t offset, char * dst, size_t n) const;
+
+    /// Closes the file opened by read()
+    void closeFile();
+
+private:
+
+    gsMpiComm m_comm;
+
+    /// The objects as an XML tree
+    FileData * m_data;
+
+    /// The XML text of the file opened by read()
+    std::vector<char> m_buffer;
+
+    /// Position of the data blocks in the file opened by read()
+    size_t m_dataOffset;
+
+#ifdef GISMO_WITH_MPI
+    MPI_File m_file;
+#else
+    std::FILE * m_file;
+#endif
+    bool m_open;
+
+private:
+    // Copying is not allowed
+    gsMpiFileData(const gsMpiFileData &);
+    gsMpiFileData & operator=(const gsMpiFileData &);
+};
+
+} // namespace gismo
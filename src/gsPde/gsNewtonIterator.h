@@ -22,6 +22,16 @@ namespace gismo
 
 /** 
     @brief Performs Newton iterations to solve a nonlinear system of PDEs.
+
+    The sparsity pattern of the Jacobian does not change between the
+    iterations, therefore the ordering and symbolic analysis of the
+    linear solver is performed only once, and only the numerical
+    factorization is repeated.
+
+    Optionally, the Jacobian (i.e. its factorization) can be frozen
+    for a number of iterations (chord method), and the linear systems
+    can be solved inexactly by a preconditioned Krylov method with
+    an adaptive forcing term (Eisenstat-Walker, choice 2).
     
     \tparam T coefficient type
     
@@ -43,7 +53,7 @@ public:
       m_tolerance(1e-12),
       m_converged(false)
     { 
-
+        initLinearSolver();
     }
 
     gsNewtonIterator(gsAssembler<T> & assembler)
@@ -53,7 +63,7 @@ public:
       m_tolerance(1e-12),
       m_converged(false)
     { 
-
+        initLinearSolver();
     }
 
 
@@ -94,6 +104,22 @@ public:
     /// \brief Set the tolerance for convergence
     void setTolerance(T tol) {m_tolerance = tol;}
 
+    /// \brief Use an inexact Newton method, i.e. solve the linear
+    /// systems by a Krylov method (ILUT preconditioned BiCGSTAB) up
+    /// to an adaptive relative tolerance (the forcing term), which is
+    /// bounded by \a maxForcingTerm
+    void setInexact(bool flag, T maxForcingTerm = 0.9)
+    {
+        m_inexact = flag;
+        m_etaMax  = maxForcingTerm;
+        m_factorized = false; // the other solver has to be set up
+        m_pattern.clear();
+    }
+
+    /// \brief Reuse the Jacobian of an iteration for \a nSteps
+    /// subsequent iterations (0 means a new Jacobian in every iteration)
+    void setJacobianFreeze(index_t nSteps) {m_jacobianFreeze = nSteps;}
+
 protected:
 
     virtual void solveLinearProblem(gsMatrix<T> &updateVector);
@@ -101,6 +127,27 @@ protected:
     virtual void solveLinearProblem(const gsMultiPatch<T> & currentSol, gsMatrix<T> &updateVector);
 
     virtual T getResidue() {return m_assembler.rhs().norm();}
+
+    /// \brief Solves the currently assembled linear system, reusing
+    /// the pattern analysis and (if frozen) the factorization
+    void computeUpdate(gsMatrix<T> & updateVector);
+
+    /// Returns true if \a mat has the pattern that was analyzed last
+    bool samePattern(const gsSparseMatrix<T> & mat) const;
+
+private:
+
+    void initLinearSolver()
+    {
+        m_inexact        = false;
+        m_factorized     = false;
+        m_jacobianFreeze = 0;
+        m_frozenSteps    = 0;
+        m_eta            = 0.5;
+        m_etaMax         = 0.9;
+        m_prevResNorm    = 0;
+    }
+
 protected:
 
     /// \brief gsAssemblerBase object to generate the linear system
@@ -117,7 +164,31 @@ protected:
     //gsSparseSolver<>::LU  m_solver;
     //typename gsSparseSolver<T>::BiCGSTABDiagonal m_solver;
     //typename gsSparseSolver<>::CGDiagonal m_solver;
-    gsSparseSolver<>::LU  m_solver;
+    typename gsSparseSolver<T>::LU  m_solver;
+
+    /// Krylov solver employed in inexact mode
+    typename gsSparseSolver<T>::BiCGSTABILUT m_krylov;
+
+    /// Sparsity pattern (outer and inner indices) analyzed last
+    std::vector<index_t> m_pattern;
+
+    /// \brief Whether the linear systems are solved inexactly
+    bool m_inexact;
+
+    /// \brief Whether a factorization is available
+    bool m_factorized;
+
+    /// \brief Number of iterations the Jacobian is kept fixed
+    index_t m_jacobianFreeze;
+
+    /// \brief Number of iterations since the last factorization
+    index_t m_frozenSteps;
+
+    /// \brief Current and maximal forcing term of the inexact method
+    T m_eta, m_etaMax;
+
+    /// \brief Residual norm of the previous linear system
+    T m_prevResNorm;
 
 protected:
 
@@ -160,8 +231,7 @@ void gsNewtonIterator<T>::solveLinearProblem(gsMatrix<T>& updateVector)
     // gsDebugVar( m_assembler.rhs().transpose() );
 
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
-    updateVector = m_solver.solve( m_assembler.rhs() );
+    computeUpdate(updateVector);
     
     // gsDebugVar(updateVector);
 }
@@ -176,12 +246,67 @@ void gsNewtonIterator<T>::solveLinearProblem(const gsMultiPatch<T> & currentSol,
     // gsDebugVar( m_assembler.rhs().transpose() );
     
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
-    updateVector = m_solver.solve( m_assembler.rhs() );
+    computeUpdate(updateVector);
 
     // gsDebugVar(updateVector);
 }
 
+template <class T>
+void gsNewtonIterator<T>::computeUpdate(gsMatrix<T>& updateVector)
+{
+    const gsSparseMatrix<T> & mat = m_assembler.matrix();
+    const T resNorm = m_assembler.rhs().norm();
+
+    gsSparseSolver<T> & solver = m_inexact ?
+        static_cast<gsSparseSolver<T>&>(m_krylov) : m_solver;
+
+    if ( !m_factorized || m_frozenSteps >= m_jacobianFreeze )
+    {
+        // The ordering and symbolic analysis is done once
+        if ( !samePattern(mat) )
+        {
+            solver.analyzePattern(mat);
+            m_pattern.assign(mat.outerIndexPtr(), mat.outerIndexPtr() + mat.outerSize() + 1);
+            m_pattern.insert(m_pattern.end(), mat.innerIndexPtr(), mat.innerIndexPtr() + mat.nonZeros());
+        }
+        solver.factorize(mat);
+        m_factorized  = true;
+        m_frozenSteps = 0;
+    }
+    else
+        ++m_frozenSteps;
+
+    if (m_inexact)
+    {
+        // Eisenstat-Walker forcing term (choice 2) with safeguard
+        if (0 != m_prevResNorm)
+        {
+            const T etaSafe = 0.9 * m_eta * m_eta;
+            m_eta = 0.9 * math::pow(resNorm / m_prevResNorm, 2);
+            if (etaSafe > 0.1)
+                m_eta = math::max(m_eta, etaSafe);
+            m_eta = math::min(m_eta, m_etaMax);
+        }
+        m_krylov.setTolerance(m_eta);
+    }
+
+    updateVector = solver.solve( m_assembler.rhs() );
+    m_prevResNorm = resNorm;
+}
+
+template <class T>
+bool gsNewtonIterator<T>::samePattern(const gsSparseMatrix<T> & mat) const
+{
+    if ( !mat.isCompressed() ||
+         m_pattern.size() != static_cast<size_t>(mat.outerSize() + 1 + mat.nonZeros()) )
+        return false;
+
+    const index_t * outer = mat.outerIndexPtr();
+    const index_t * inner = mat.innerIndexPtr();
+    return std::equal(outer, outer + mat.outerSize() + 1, m_pattern.begin()) &&
+        std::equal(inner, inner + mat.nonZeros(), m_pattern.begin() + mat.outerSize() + 1);
+}
+
 
 template <class T> 
 void gsNewtonIterator<T>::solve()
@@ -216,6 +341,12 @@ void gsNewtonIterator<T>::firstIteration()
     // ----- First iteration -----
     m_converged = false;
 
+    // Start with a fresh Jacobian and forcing term (the analyzed
+    // pattern is kept)
+    m_factorized  = false;
+    m_eta         = 0.5;
+    m_prevResNorm = 0;
+
     // Solve 
     solveLinearProblem(m_updateVector);
 
@@ -0,0 +1,88 @@
+/** @file gsBlockConjugateGradient.cpp
+
+    @brief Block conjugate gradient solver for multiple right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <gsSolver/gsBlockConjugateGradient.h>
+
+namespace gismo
+{
+
+bool gsBlockConjugateGradient::initIteration( const VectorType& rhs, VectorType& x )
+{
+    GISMO_ASSERT( m_precond->rows() == m_mat->rows() && m_precond->cols() == m_mat->cols(),
+                  "The preconditionner does not match the matrix." );
+
+    m_num_iter = 0;
+
+    m_rhs_norms = rhs.colwise().norm();
+    m_rhs_norm  = m_rhs_norms.maxCoeff();
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), rhs.cols());
+    else
+    {
+        GISMO_ENSURE(m_mat->cols() == x.rows(), "Invalid initial solution");
+        GISMO_ENSURE(rhs.cols() == x.cols()   , "Initial solution does not match right-hand side");
+    }
+
+    // Zero columns are solved by zero
+    for (index_t j = 0; j != rhs.cols(); ++j)
+        if (0 == m_rhs_norms(0,j))
+        {
+            x.col(j).setZero();
+            m_rhs_norms(0,j) = 1;
+        }
+
+    m_mat->apply(x, m_ap);
+    m_res = rhs - m_ap;                                                // initial residuals
+
+    m_error = maxRelativeResidual();
+    if (m_error < m_tol)
+        return true;
+
+    m_precond->apply(m_res, m_z);
+    m_p  = m_z;                                                        // initial search directions
+    m_zr.noalias() = m_z.transpose() * m_res;
+
+    return false;
+}
+
+bool gsBlockConjugateGradient::step( VectorType& x )
+{
+    m_mat->apply(m_p, m_ap);                                           // one block operator application
+
+    // Step lengths: (P^T A P) alpha = Z^T R. The LDLT factorization
+    // tolerates (numerically) rank-deficient blocks
+    const gsMatrix<real_t> pap = m_p.transpose() * m_ap;
+    const gsMatrix<real_t> alpha = pap.ldlt().solve(m_zr);
+
+    x.noalias()     += m_p  * alpha;                                   // update solutions
+    m_res.noalias() -= m_ap * alpha;                                   // update residuals
+
+    m_error = maxRelativeResidual();
+    if (m_error < m_tol)
+        return true;
+
+    m_precond->apply(m_res, m_z);
+
+    const gsMatrix<real_t> zrNew = m_z.transpose() * m_res;
+    const gsMatrix<real_t> beta  = m_zr.ldlt().solve(zrNew);
+    m_zr = zrNew;
+
+    m_p = m_z + m_p * beta;                                            // update search directions
+
+    return false;
+}
+
+real_t gsBlockConjugateGradient::maxRelativeResidual() const
+{
+    return ( m_res.colwise().norm().array() / m_rhs_norms.array() ).maxCoeff();
+}
+
+} // namespace gismo
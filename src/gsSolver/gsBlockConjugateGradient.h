@@ -0,0 +1,76 @@
+/** @file gsBlockConjugateGradient.h
+
+    @brief Block conjugate gradient solver for multiple right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/** @brief Preconditioned block conjugate gradient method
+ *  (D.P. O'Leary, 1980).
+ *
+ *  Solves \f$ A X = B \f$ for all columns of \f$ B \f$ together. The
+ *  search space is spanned by the union of the Krylov spaces of all
+ *  right-hand sides, hence fewer iterations are needed than for
+ *  solving the columns one at a time, and each iteration applies the
+ *  operator to a block of vectors (matrix-matrix product) instead of
+ *  a single vector.
+ *
+ *  The preconditioner must accept multi-column input.
+ *
+ *  The iteration stops when the relative residual of every column is
+ *  below the tolerance; error() reports the largest relative residual.
+ *
+ *  \ingroup Solver
+ */
+class GISMO_EXPORT gsBlockConjugateGradient : public gsIterativeSolver<real_t>
+{
+public:
+    typedef gsIterativeSolver<real_t> Base;
+
+    typedef gsMatrix<real_t>  VectorType;
+
+    typedef Base::LinOpPtr LinOpPtr;
+
+    /// Constructor using a matrix (operator) and optionally a preconditionner
+    template< typename OperatorType >
+    explicit gsBlockConjugateGradient( const OperatorType& mat, const LinOpPtr & precond = LinOpPtr() )
+    : Base(mat, precond) {}
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+
+private:
+    /// Computes the largest relative residual of the columns
+    real_t maxRelativeResidual() const;
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    // Residual, preconditioned residual, search directions and A*P
+    gsMatrix<real_t> m_res, m_z, m_p, m_ap;
+
+    // Z^T R of the previous iteration
+    gsMatrix<real_t> m_zr;
+
+    // Norms of the right-hand side columns
+    gsMatrix<real_t> m_rhs_norms;
+};
+
+} // namespace gismo
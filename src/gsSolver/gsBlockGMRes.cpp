@@ -0,0 +1,163 @@
+/** @file gsBlockGMRes.cpp
+
+    @brief Block generalized minimal residual solver for multiple
+    right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <gsSolver/gsBlockGMRes.h>
+
+#include <limits>
+
+namespace gismo
+{
+
+// Thin QR factorization w = Q R, with Q having orthonormal columns
+static void thinQR(const gsMatrix<real_t> & w, gsMatrix<real_t> & Q, gsMatrix<real_t> & R)
+{
+    const index_t n = w.rows(), b = w.cols();
+    Eigen::HouseholderQR< gsMatrix<real_t>::Base > qr(w);
+    Q = qr.householderQ() * gsMatrix<real_t>::Identity(n, b);
+    R = qr.matrixQR().topRows(b).triangularView<Eigen::Upper>();
+}
+
+// Rank revealing thin QR factorization w = Q S, with Q having r
+// orthonormal columns, r the numerical rank of w, and S of size r x
+// w.cols()
+static void deflatedQR(const gsMatrix<real_t> & w, gsMatrix<real_t> & Q, gsMatrix<real_t> & S)
+{
+    const index_t n = w.rows();
+    Eigen::ColPivHouseholderQR< gsMatrix<real_t>::Base > qr(w);
+    const index_t r = qr.rank();
+    Q = qr.householderQ() * gsMatrix<real_t>::Identity(n, r);
+    gsMatrix<real_t> R = qr.matrixQR().topRows(r).triangularView<Eigen::Upper>();
+    S = R * qr.colsPermutation().transpose();
+}
+
+bool gsBlockGMRes::initIteration( const VectorType& rhs, VectorType& x )
+{
+    GISMO_ASSERT( m_precond->rows() == m_mat->rows() && m_precond->cols() == m_mat->cols(),
+                  "The preconditionner does not match the matrix." );
+
+    m_num_iter = 0;
+
+    m_rhs_norms = rhs.colwise().norm();
+    m_rhs_norm  = m_rhs_norms.maxCoeff();
+    for (index_t j = 0; j != rhs.cols(); ++j)
+        if (0 == m_rhs_norms(0,j)) m_rhs_norms(0,j) = 1;
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), rhs.cols());
+    else
+    {
+        GISMO_ENSURE(m_mat->cols() == x.rows(), "Invalid initial solution");
+        GISMO_ENSURE(rhs.cols() == x.cols()   , "Initial solution does not match right-hand side");
+    }
+
+    m_mat->apply(x, m_tmp);
+    m_tmp = rhs - m_tmp;
+    m_precond->apply(m_tmp, m_w);                                      // preconditioned residuals
+
+    m_error = ( m_w.colwise().norm().array() / m_rhs_norms.array() ).maxCoeff();
+    if (m_error < m_tol)
+        return true;
+
+    // Linearly dependent residuals are deflated: the Krylov blocks
+    // have as many columns as the rank of the initial residuals
+    m_V.resize(1);
+    deflatedQR(m_w, m_V[0], m_S);                                      // R_0 = V_0 S
+    m_qr.clear();
+    m_R.resize(0,0);
+    m_g.resize(0,0);
+
+    return false;
+}
+
+bool gsBlockGMRes::step( VectorType& x )
+{
+    GISMO_UNUSED(x); // The iterate x is never updated! Use finalizeIteration to obtain x.
+    const index_t j = m_num_iter - 1;
+    const index_t b = m_S.rows();
+
+    m_mat->apply(m_V[j], m_tmp);
+    m_precond->apply(m_tmp, m_w);
+
+    // New block column of the block Hessenberg matrix, by block
+    // modified Gram-Schmidt
+    gsMatrix<real_t> h((j+2)*b, b);
+    for (index_t i = 0; i <= j; ++i)
+    {
+        h.middleRows(i*b, b).noalias() = m_V[i].transpose() * m_w;
+        m_w.noalias() -= m_V[i] * h.middleRows(i*b, b);
+    }
+    m_V.push_back(gsMatrix<real_t>());
+    gsMatrix<real_t> r;
+    thinQR(m_w, m_V.back(), r);
+    h.bottomRows(b) = r;
+
+    // Apply the previous reflections, then reduce the subdiagonal block
+    for (index_t i = 0; i < j; ++i)
+        h.middleRows(i*b, 2*b).applyOnTheLeft( m_qr[i].householderQ().transpose() );
+    m_qr.push_back( BlockQR(h.bottomRows(2*b)) );
+    h.middleRows(j*b, b) = m_qr.back().matrixQR().topRows(b).triangularView<Eigen::Upper>();
+
+    // A (numerically) singular diagonal block means that the operator
+    // is singular on the Krylov space: stop with the solution over
+    // the previous blocks
+    const real_t minDiag = h.middleRows(j*b, b).diagonal().cwiseAbs().minCoeff();
+    if ( minDiag <= std::numeric_limits<real_t>::epsilon() * (j+2) * b * h.norm() )
+    {
+        gsWarn << "gsBlockGMRes: Breakdown in iteration "<< m_num_iter
+               <<", the operator is singular on the Krylov space.\n";
+        m_V.pop_back();
+        m_qr.pop_back();
+        return true;
+    }
+
+    // Append the block column to the triangular factor
+    if ( m_R.cols() < (j+1)*b )
+    {
+        m_R.conservativeResize(2*(j+1)*b, 2*(j+1)*b);
+        m_g.conservativeResize(2*(j+1)*b + b, m_S.cols());
+    }
+    m_R.block(0, j*b, (j+1)*b, b) = h.topRows((j+1)*b);
+
+    // Transformed right-hand sides: the last block row holds the
+    // residuals of the least squares problems min || E_1 S - H y ||
+    if ( 0 == j )
+        m_g.topRows(b) = m_S;
+    m_g.middleRows((j+1)*b, b).setZero();
+    m_g.middleRows(j*b, 2*b).applyOnTheLeft( m_qr.back().householderQ().transpose() );
+
+    m_error = ( m_g.middleRows((j+1)*b, b).colwise().norm().array()
+                / m_rhs_norms.array() ).maxCoeff();
+    return m_error < m_tol;
+}
+
+void gsBlockGMRes::finalizeIteration( VectorType& x )
+{
+    const index_t b = m_S.rows();
+    const index_t n = static_cast<index_t>(m_qr.size()) * b;
+    if ( n > 0 )
+    {
+        solveUpperTriangular(m_R.topLeftCorner(n, n), m_g.topRows(n));
+        for (index_t i = 0; i != n / b; ++i)
+            x.noalias() += m_V[i] * m_y.middleRows(i*b, b);
+    }
+
+    // cleanup temporaries
+    m_V.clear();
+    m_qr.clear();
+    m_R.clear();
+    m_S.clear();
+    m_g.clear();
+    m_y.clear();
+    m_tmp.clear();
+    m_w.clear();
+}
+
+} // namespace gismo
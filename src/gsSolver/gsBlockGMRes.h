@@ -0,0 +1,106 @@
+/** @file gsBlockGMRes.h
+
+    @brief Block generalized minimal residual solver for multiple
+    right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/** @brief Preconditioned block GMRES method.
+ *
+ *  Solves \f$ A X = B \f$ for all columns of \f$ B \f$ together by
+ *  a block Arnoldi process. Every iteration applies the operator and
+ *  the (left) preconditioner to a block of (at most) \a k vectors,
+ *  where \a k is the number of right-hand sides, and minimizes the residuals of
+ *  all columns over the block Krylov space.
+ *
+ *  As gsGMRes, the method is not restarted, and the iterate is
+ *  constructed only in finalizeIteration(). The preconditioner must
+ *  accept multi-column input.
+ *
+ *  If the initial residuals are linearly dependent (e.g. repeated
+ *  right-hand sides), they are deflated and the blocks have as many
+ *  vectors as their numerical rank.
+ *
+ *  The iteration stops when the relative (preconditioned) residual
+ *  of every column is below the tolerance. If the block Hessenberg
+ *  matrix becomes singular, it stops with a warning and the
+ *  solution over the Krylov space built so far; error() is then not
+ *  below the tolerance.
+ *
+ *  \ingroup Solver
+ */
+class GISMO_EXPORT gsBlockGMRes: public gsIterativeSolver<real_t>
+{
+public:
+    typedef gsIterativeSolver<real_t> Base;
+
+    typedef gsMatrix<real_t>  VectorType;
+
+    typedef Base::LinOpPtr LinOpPtr;
+
+    /// Constructor using a matrix (operator) and optionally a preconditionner
+    template< typename OperatorType >
+    explicit gsBlockGMRes( const OperatorType& mat, const LinOpPtr & precond = LinOpPtr() )
+    : Base(mat, precond) {}
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    /// Solves the upper triangular system R y = gg
+    /// and stores the solution in the private member m_y.
+    void solveUpperTriangular(const gsMatrix<real_t> & R, const gsMatrix<real_t> & gg)
+    {
+       m_y = R.triangularView<Eigen::Upper>().solve(gg);
+    }
+
+private:
+    typedef Eigen::HouseholderQR<gsMatrix<real_t>::Base> BlockQR;
+
+    /// Orthonormal blocks of the Krylov space
+    std::vector<gsMatrix<real_t> > m_V;
+
+    /// QR factorizations of the subdiagonal 2x1 blocks of the block
+    /// Hessenberg matrix, which reduce it to upper triangular form
+    std::vector<BlockQR> m_qr;
+
+    /// The triangular factor of the block Hessenberg matrix (its
+    /// storage grows geometrically)
+    gsMatrix<real_t> m_R;
+
+    /// The initial residual in the basis of m_V (first block row)
+    gsMatrix<real_t> m_S;
+
+    /// The transformed right-hand sides of the least squares problems
+    gsMatrix<real_t> m_g;
+
+    /// Coefficients of the least squares solution
+    gsMatrix<real_t> m_y;
+
+    gsMatrix<real_t> m_tmp, m_w;
+
+    /// Norms of the right-hand side columns
+    gsMatrix<real_t> m_rhs_norms;
+};
+
+} // namespace gismo
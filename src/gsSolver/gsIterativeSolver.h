@@ -16,6 +16,7 @@
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsMatrixOp.h>
 #include <gsIO/gsOptionList.h>
+#include <gsMpi/gsMpi.h>
 
 namespace gismo
 {
@@ -40,7 +41,9 @@ public:
       m_tol(1e-10),
       m_num_iter(0),
       m_rhs_norm(0.),
-      m_error(0.)
+      m_error(0.),
+      m_comm(gsMpi::localComm()),
+      m_distributed(false)
     {
         GISMO_ASSERT(m_mat->rows() == m_mat->cols(), "Matrix is not square.");
         if (!m_precond) m_precond = gsIdentityOp<T>::make(m_mat->rows());
@@ -60,7 +63,9 @@ public:
       m_tol(1e-10),
       m_num_iter(0),
       m_rhs_norm(0.),
-      m_error(0.)
+      m_error(0.),
+      m_comm(gsMpi::localComm()),
+      m_distributed(false)
     {
         GISMO_ASSERT(m_mat->rows() == m_mat->cols(), "Matrix is not square.");
         if (!m_precond) m_precond = gsIdentityOp<T>::make(m_mat->rows());
@@ -111,7 +116,8 @@ public:
     virtual bool initIteration( const VectorType& rhs, VectorType& x )
     {
         GISMO_ASSERT( rhs.cols() == 1,
-                      "Iterative solvers only work for single column right hand side." );
+                      "Iterative solvers only work for single column right hand side,"
+                      " see gsBlockConjugateGradient and gsBlockGMRes." );
      
         GISMO_ASSERT( m_precond->rows() == m_mat->rows(),
                       "The preconditionner does not match the matrix." );
@@ -121,7 +127,7 @@ public:
         
         m_num_iter = 0;
         
-        m_rhs_norm = rhs.norm();
+        m_rhs_norm = norm(rhs);
 
         if (0 == m_rhs_norm) // special case of zero rhs
         {
@@ -164,6 +170,33 @@ public:
     /// The tolerance used in the iterative method
     T tolerance() const                                   { return m_tol; }
 
+    /// @brief Sets the communicator over which the vectors are
+    /// distributed (see gsDistributedOp).
+    ///
+    /// The vectors, the operator and the preconditioner then refer to
+    /// the rows owned by the process, and the inner products and
+    /// norms are summed over the processes.
+    void setCommunicator(const gsMpiComm & comm)
+    { m_comm = comm; m_distributed = true; }
+
+protected:
+
+    /// The inner product of the first columns of \a a and \a b,
+    /// over all processes if a communicator is set
+    T dot(const VectorType & a, const VectorType & b) const
+    {
+        T result = a.col(0).dot(b.col(0));
+        return m_distributed ? m_comm.sum(result) : result;
+    }
+
+    /// The Frobenius norm of \a a, over all processes if a
+    /// communicator is set
+    T norm(const VectorType & a) const
+    {
+        T result = a.squaredNorm();
+        return math::sqrt( m_distributed ? m_comm.sum(result) : result );
+    }
+
 
 protected:
     const LinOpPtr m_mat;            ///< The matrix/operator to be solved for
@@ -173,6 +206,8 @@ protected:
     index_t        m_num_iter;       ///< The number of iterations performed
     T              m_rhs_norm;       ///< The norm of the right-hand-side
     T              m_error;          ///< The relative error as absolute_error/m_rhs_norm
+    gsMpiComm      m_comm;           ///< The processes the vectors are distributed over
+    bool           m_distributed;    ///< True if the vectors are distributed over m_comm
 
 };
 
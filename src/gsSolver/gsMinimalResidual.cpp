@@ -33,7 +33,7 @@ bool gsMinimalResidual::initIteration( const gsMinimalResidual::VectorType& rhs,
     v = -negResidual;
     m_precond->apply(v, z);
 
-    gammaPrev = 1; gamma = math::sqrt(z.col(0).dot(v.col(0))); gammaNew = 1;
+    gammaPrev = 1; gamma = math::sqrt(dot(z, v)); gammaNew = 1;
     eta = gamma;
     sPrev = 0; s = 0; sNew = 0;
     cPrev = 1; c = 1; cNew = 1;
@@ -47,10 +47,10 @@ bool gsMinimalResidual::step( gsMinimalResidual::VectorType& x )
     z /= gamma;
     m_mat->apply(z,Az);
 
-    real_t delta = z.col(0).dot(Az.col(0));
+    real_t delta = dot(z, Az);
     vNew = Az - (delta/gamma)*v - (gamma/gammaPrev)*vPrev;
     m_precond->apply(vNew, zNew);
-    gammaNew = math::sqrt(zNew.col(0).dot(vNew.col(0)));
+    gammaNew = math::sqrt(dot(zNew, vNew));
     const real_t a0 = c*delta - cPrev*s*gamma;
     const real_t a1 = math::sqrt(a0*a0 + gammaNew*gammaNew);
     const real_t a2 = s*delta + cPrev*c*gamma;
@@ -64,7 +64,7 @@ bool gsMinimalResidual::step( gsMinimalResidual::VectorType& x )
     eta = -sNew*eta;
 
     //Test for convergence
-    m_error = negResidual.norm() / m_rhs_norm;
+    m_error = norm(negResidual) / m_rhs_norm;
     if (m_error < m_tol)
         return true;
 
@@ -0,0 +1,119 @@
+/** @file gsPipelinedConjugateGradient.cpp
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <gsSolver/gsPipelinedConjugateGradient.h>
+
+namespace gismo
+{
+
+bool gsPipelinedConjugateGradient::initIteration( const VectorType& rhs, VectorType& x )
+{
+    GISMO_ASSERT( rhs.cols() == 1,
+                  "Iterative solvers only work for single column right hand side." );
+    GISMO_ASSERT( m_precond->rows() == m_mat->rows() && m_precond->cols() == m_mat->cols(),
+                  "The preconditionner does not match the matrix." );
+
+    m_num_iter = 0;
+
+    // The norm of the right-hand side is global, since the
+    // processes must take the same decisions
+    m_rhs_norm = norm(rhs);
+
+    if (0 == m_rhs_norm) // special case of zero rhs
+    {
+        x.setZero(rhs.rows(),1);
+        m_error = 0.;
+        return true;
+    }
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), 1);
+    else
+        GISMO_ENSURE(m_mat->cols() == x.rows(), "Invalid initial solution");
+
+    m_mat->apply(x, m_r);
+    m_r = rhs - m_r;                                                  // r = b - A x
+    m_precond->apply(m_r, m_u);                                       // u = M r
+    m_mat->apply(m_u, m_w);                                           // w = A u
+
+    const index_t n = m_r.rows();
+    m_z.setZero(n,1);
+    m_q.setZero(n,1);
+    m_s.setZero(n,1);
+    m_p.setZero(n,1);
+
+    m_gamma = 0;
+    m_alpha = 0;
+
+    reduce();
+    return m_error < m_tol;
+}
+
+void gsPipelinedConjugateGradient::reduce()
+{
+    // All inner products of the iteration are fused into one reduction
+    m_dots[0] = m_r.col(0).dot(m_u.col(0));                           // gamma = (r,u)
+    m_dots[1] = m_w.col(0).dot(m_u.col(0));                           // delta = (w,u)
+    m_dots[2] = m_r.col(0).squaredNorm();                             // (r,r)
+
+#   ifdef GISMO_WITH_MPI
+    MPI_Request req;
+    if ( m_distributed )
+        m_comm.isum(m_dots, 3, &req);
+#   endif
+
+    // Overlap the reduction with the operator applications
+    m_precond->apply(m_w, m_m);                                       // m = M w
+    m_mat->apply(m_m, m_n);                                           // n = A m
+
+#   ifdef GISMO_WITH_MPI
+    if ( m_distributed )
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+#   endif
+
+    m_error = math::sqrt(m_dots[2]) / m_rhs_norm;
+}
+
+bool gsPipelinedConjugateGradient::step( VectorType& x )
+{
+    const real_t gamma = m_dots[0];
+    const real_t delta = m_dots[1];
+
+    real_t alpha, beta;
+    if (1 == m_num_iter)
+    {
+        beta  = 0;
+        alpha = gamma / delta;
+    }
+    else
+    {
+        beta  = gamma / m_gamma;
+        alpha = gamma / (delta - beta * gamma / m_alpha);
+    }
+    m_gamma = gamma;
+    m_alpha = alpha;
+
+    m_z = m_n + beta * m_z;
+    m_q = m_m + beta * m_q;
+    m_s = m_w + beta * m_s;
+    m_p = m_u + beta * m_p;
+
+    x   += alpha * m_p;                                               // update solution
+    m_r -= alpha * m_s;                                               // update residual
+    m_u -= alpha * m_q;                                               // update preconditioned residual
+    m_w -= alpha * m_z;                                               // update A u
+
+    // The inner products of the next iteration include the norm of
+    // the updated residual
+    reduce();
+    return m_error < m_tol;
+}
+
+} // namespace gismo
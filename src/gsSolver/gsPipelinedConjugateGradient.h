@@ -0,0 +1,87 @@
+/** @file gsPipelinedConjugateGradient.h
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/** @brief Pipelined preconditioned conjugate gradient method
+ *  (P. Ghysels, W. Vanroose, 2014).
+ *
+ *  Mathematically equivalent to gsConjugateGradient, but the
+ *  recurrences are rearranged such that all inner products of one
+ *  iteration are fused into a single global reduction. This
+ *  reduction is started non-blocking and overlaps with the
+ *  application of the preconditioner and of the system matrix.
+ *
+ *  If a communicator is set, the vectors are assumed to be
+ *  distributed row-wise over its processes, i.e., every process
+ *  passes its own part of the right-hand side and the operators act
+ *  on the process-local rows only. The local inner products are
+ *  then summed up over the communicator.
+ *
+ *  \ingroup Solver
+ */
+class GISMO_EXPORT gsPipelinedConjugateGradient : public gsIterativeSolver<real_t>
+{
+public:
+    typedef gsIterativeSolver<real_t> Base;
+
+    typedef gsMatrix<real_t>  VectorType;
+
+    typedef Base::LinOpPtr LinOpPtr;
+
+    /// Constructor using a matrix (operator) and optionally a preconditionner
+    template< typename OperatorType >
+    explicit gsPipelinedConjugateGradient( const OperatorType& mat,
+                                           const LinOpPtr & precond = LinOpPtr() )
+    : Base(mat, precond) { }
+
+    /// Constructor for vectors distributed over the processes of \a
+    /// comm (see setCommunicator())
+    template< typename OperatorType >
+    gsPipelinedConjugateGradient( const OperatorType& mat, const LinOpPtr & precond,
+                                  const gsMpiComm & comm )
+    : Base(mat, precond) { setCommunicator(comm); }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+
+private:
+    /// Computes the inner products of the current vectors and m = M w,
+    /// n = A m, overlapping the reduction with the applications
+    void reduce();
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+    using Base::m_comm;
+    using Base::m_distributed;
+
+    // Auxiliary vectors of the pipelined recurrences
+    VectorType m_r, m_u, m_w, m_m, m_n, m_z, m_q, m_s, m_p;
+
+    // The reduced inner products (r,u), (w,u) and (r,r)
+    real_t m_dots[3];
+
+    real_t m_gamma, m_alpha;
+};
+
+} // namespace gismo
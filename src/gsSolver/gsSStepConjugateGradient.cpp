@@ -0,0 +1,135 @@
+/** @file gsSStepConjugateGradient.cpp
+
+    @brief Communication avoiding (s-step) conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <gsSolver/gsSStepConjugateGradient.h>
+
+namespace gismo
+{
+
+// Solves W x = b for a symmetric positive semi-definite Gram matrix
+// W. The monomial Krylov basis may be numerically rank-deficient, so
+// eigenvalues below a relative threshold are discarded.
+static gsMatrix<real_t> pseudoInverseSolve(const gsMatrix<real_t> & W,
+                                           const gsMatrix<real_t> & b)
+{
+    Eigen::SelfAdjointEigenSolver< gsMatrix<real_t>::Base > es(W);
+    gsMatrix<real_t> d = es.eigenvalues();
+    const real_t tol = 1e-13 * d.cwiseAbs().maxCoeff();
+    for (index_t i = 0; i < d.rows(); ++i)
+        d(i) = ( d(i) > tol ? 1 / d(i) : 0 );
+    return es.eigenvectors() * d.asDiagonal() * (es.eigenvectors().transpose() * b);
+}
+
+bool gsSStepConjugateGradient::initIteration( const VectorType& rhs, VectorType& x )
+{
+    GISMO_ASSERT( rhs.cols() == 1,
+                  "Iterative solvers only work for single column right hand side." );
+    GISMO_ASSERT( m_precond->rows() == m_mat->rows() && m_precond->cols() == m_mat->cols(),
+                  "The preconditionner does not match the matrix." );
+
+    m_num_iter = 0;
+
+    // The norm of the right-hand side is global, since the
+    // processes must take the same decisions
+    m_rhs_norm = norm(rhs);
+
+    if (0 == m_rhs_norm) // special case of zero rhs
+    {
+        x.setZero(rhs.rows(),1);
+        m_error = 0.;
+        return true;
+    }
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), 1);
+    else
+        GISMO_ENSURE(m_mat->cols() == x.rows(), "Invalid initial solution");
+
+    m_mat->apply(x, m_tmp);
+    m_res = rhs - m_tmp;                                              // initial residual
+
+    const index_t n = m_res.rows();
+    m_V .resize(n, m_s);
+    m_AV.resize(n, m_s);
+    m_P .resize(n, 0);                                                // no previous block yet
+    m_AP.resize(n, 0);
+
+    buildBlock();
+    return m_error < m_tol;
+}
+
+void gsSStepConjugateGradient::buildBlock()
+{
+    const index_t s = m_s;
+
+    // Monomial Krylov basis of the preconditioned operator
+    m_precond->apply(m_res, m_tmp);
+    m_V.col(0) = m_tmp;
+    for (index_t j = 0; j < s; ++j)
+    {
+        m_mat->apply(m_V.col(j), m_tmp);
+        m_AV.col(j) = m_tmp;
+        if (j + 1 < s)
+        {
+            m_precond->apply(m_AV.col(j), m_tmp);
+            m_V.col(j+1) = m_tmp;
+        }
+    }
+
+    // Local parts of all inner products of the s steps:
+    // [ V^T A V | (AP)^T V | V^T r | (r,r) ]
+    m_red.resize(s, 2*s+2);
+    m_red.leftCols(s).noalias() = m_V.transpose() * m_AV;
+    if (0 != m_P.cols())
+        m_red.middleCols(s,s).noalias() = m_AP.transpose() * m_V;
+    else
+        m_red.middleCols(s,s).setZero();
+    m_red.col(2*s).noalias() = m_V.transpose() * m_res;
+    m_red.col(2*s+1).setZero();
+    m_red(0,2*s+1) = m_res.squaredNorm();
+
+    // The only global reduction of the s steps
+    if ( m_distributed )
+        m_comm.sum(m_red.data(), m_red.size());
+
+    m_error = math::sqrt(m_red(0,2*s+1)) / m_rhs_norm;
+}
+
+bool gsSStepConjugateGradient::step( VectorType& x )
+{
+    const index_t s = m_s;
+
+    // A-conjugate the new block against the previous one
+    gsMatrix<real_t> Wnew = m_red.leftCols(s);
+    if (0 != m_P.cols())
+    {
+        const gsMatrix<real_t> C = pseudoInverseSolve(m_W, m_red.middleCols(s,s));
+        Wnew.noalias() -= m_red.middleCols(s,s).transpose() * C;
+        m_V .noalias() -= m_P  * C;
+        m_AV.noalias() -= m_AP * C;
+    }
+    m_W = 0.5 * (Wnew + Wnew.transpose());
+    m_P .swap(m_V );
+    m_AP.swap(m_AV);
+    m_V .resize(m_P.rows(), s);
+    m_AV.resize(m_P.rows(), s);
+
+    // Minimize the energy error over the new block
+    const gsMatrix<real_t> a = pseudoInverseSolve(m_W, m_red.col(2*s));
+    x.noalias()     += m_P  * a;                                      // update solution
+    m_res.noalias() -= m_AP * a;                                      // update residual
+
+    // The reduction of the next block includes the norm of the
+    // updated residual
+    buildBlock();
+    return m_error < m_tol;
+}
+
+} // namespace gismo
@@ -0,0 +1,115 @@
+/** @file gsSStepConjugateGradient.h
+
+    @brief Communication avoiding (s-step) conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/** @brief s-step preconditioned conjugate gradient method
+ *  (A.T. Chronopoulos, C.W. Gear, 1989).
+ *
+ *  Every outer step builds the Krylov basis
+ *  \f$ [ M r, (MA) M r, \dots, (MA)^{s-1} M r ] \f$, conjugates it
+ *  against the previous block of search directions and minimizes
+ *  the energy error over the new block. All inner products needed
+ *  for these \a s CG steps are computed by one global reduction,
+ *  instead of 2s reductions for gsConjugateGradient.
+ *
+ *  The monomial Krylov basis becomes ill-conditioned quickly, so
+ *  \a s should be kept small (the default is 4). Each call of
+ *  step() performs \a s matrix applications, hence iterations()
+ *  counts outer (blocked) steps.
+ *
+ *  Distributed vectors are handled as in gsPipelinedConjugateGradient.
+ *
+ *  \ingroup Solver
+ */
+class GISMO_EXPORT gsSStepConjugateGradient : public gsIterativeSolver<real_t>
+{
+public:
+    typedef gsIterativeSolver<real_t> Base;
+
+    typedef gsMatrix<real_t>  VectorType;
+
+    typedef Base::LinOpPtr LinOpPtr;
+
+    /// Constructor using a matrix (operator) and optionally a preconditionner
+    template< typename OperatorType >
+    explicit gsSStepConjugateGradient( const OperatorType& mat,
+                                       const LinOpPtr & precond = LinOpPtr() )
+    : Base(mat, precond), m_s(4) { }
+
+    /// Constructor for vectors distributed over the processes of \a
+    /// comm (see setCommunicator())
+    template< typename OperatorType >
+    gsSStepConjugateGradient( const OperatorType& mat, const LinOpPtr & precond,
+                              const gsMpiComm & comm )
+    : Base(mat, precond), m_s(4) { setCommunicator(comm); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("SSteps", "Number of CG steps fused into one reduction", 4 );
+        return opt;
+    }
+
+    void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        m_s = opt.askInt("SSteps", m_s);
+    }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+
+    /// Set the number of CG steps performed per reduction
+    void setSSteps(index_t s)
+    {
+        GISMO_ASSERT ( s > 0, "Number of steps needs to be positive. ");
+        m_s = s;
+    }
+
+private:
+    /// Builds the Krylov block of the current residual and reduces
+    /// all inner products of the next s steps
+    void buildBlock();
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+    using Base::m_comm;
+    using Base::m_distributed;
+
+    index_t m_s;
+
+    VectorType m_res, m_tmp;
+
+    // Current and previous block of search directions and their images
+    gsMatrix<real_t> m_V, m_AV, m_P, m_AP;
+
+    // Gram matrix P^T A P of the previous block
+    gsMatrix<real_t> m_W;
+
+    // The reduced inner products of the current block
+    gsMatrix<real_t> m_red;
+};
+
+} // namespace gismo
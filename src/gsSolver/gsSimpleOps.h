@@ -14,6 +14,7 @@
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsMatrixOp.h>
 
 namespace gismo
 {
@@ -263,4 +264,159 @@ private:
 };
 
 
+
+/// @brief Chebyshev accelerated Jacobi preconditioner/smoother
+///
+/// Applies a fixed-degree Chebyshev polynomial in \f$ D^{-1}A \f$,
+/// \f$ D \f$ being the diagonal of \f$ A \f$, which is optimal for
+/// the eigenvalue interval [\a lambdaMin, \a lambdaMax]. The largest
+/// eigenvalue is estimated by a few Lanczos steps at construction,
+/// the lower bound is taken as a fixed fraction of it (the range
+/// which a smoother has to damp), unless the bounds are set explicitly.
+///
+/// Contrary to Gauss-Seidel, every step consists only of a matrix
+/// vector product and vector updates, thus it needs no inner
+/// products and is fully parallel. Multi-column input is supported.
+///
+/// Requires a symmetric positive definite matrix.
+template <typename MatrixType>
+class gsChebyshevOp : public gsLinearOperator<typename MatrixType::Scalar>
+{
+public:
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsChebyshevOp
+    typedef typename memory::shared< gsChebyshevOp >::ptr Ptr;
+
+    /// Unique pointer for gsChebyshevOp
+    typedef typename memory::unique< gsChebyshevOp >::ptr uPtr;
+
+    /// @brief Contructor with given matrix
+    ///
+    /// @param _mat         the (symmetric positive definite) matrix
+    /// @param degree       the degree of the polynomial, i.e., the
+    ///                     number of Jacobi steps per application
+    /// @param lanczosSteps number of Lanczos steps for estimating
+    ///                     the largest eigenvalue
+    gsChebyshevOp(const MatrixType& _mat, index_t degree = 3, index_t lanczosSteps = 10)
+    : m_mat(_mat), m_degree(degree), m_ratio(30)
+    {
+        GISMO_ASSERT( m_mat.rows() == m_mat.cols(), "Need square matrix");
+        m_diagInv = m_mat.diagonal().cwiseInverse();
+        m_lambdaMax = (T)(1.1) * estimateMaxEigenvalue(lanczosSteps);
+        m_lambdaMin = m_lambdaMax / m_ratio;
+    }
+
+    static Ptr make(const MatrixType& _mat, index_t degree = 3, index_t lanczosSteps = 10)
+    { return memory::make_shared( new gsChebyshevOp(_mat,degree,lanczosSteps) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_mat.rows() == input.rows(), "Dimensions do not match.");
+
+        const T theta = (m_lambdaMax + m_lambdaMin) / 2;
+        const T delta = (m_lambdaMax - m_lambdaMin) / 2;
+        const T sigma = theta / delta;
+        T rho = 1 / sigma;
+
+        // Three-term recurrence starting from x = 0
+        gsMatrix<T> res = input;
+        gsMatrix<T> d   = (m_diagInv / theta).asDiagonal() * res;
+        x = d;
+        for (index_t k = 1; k < m_degree; ++k)
+        {
+            res.noalias() -= m_mat * d;
+            const T rhoNew = 1 / (2 * sigma - rho);
+            d = (rhoNew * rho) * d
+              + ((2 * rhoNew / delta) * m_diagInv).asDiagonal() * res;
+            x   += d;
+            rho  = rhoNew;
+        }
+    }
+
+    index_t rows() const {return m_mat.rows();}
+    index_t cols() const {return m_mat.cols();}
+
+    /// Set the degree of the Chebyshev polynomial
+    void setDegree(index_t n)
+    {
+        GISMO_ASSERT ( n > 0, "Degree needs to be positive. ");
+        m_degree = n;
+    }
+
+    /// @brief Set the ratio lambdaMax/lambdaMin of the targeted
+    /// eigenvalue interval (default is 30, suitable for smoothing)
+    void setEigenvalueRatio(T ratio)
+    {
+        GISMO_ASSERT ( ratio > 1, "The ratio needs to be larger than one. ");
+        m_ratio = ratio;
+        m_lambdaMin = m_lambdaMax / m_ratio;
+    }
+
+    /// Set the eigenvalue interval of \f$ D^{-1}A \f$ explicitly
+    void setSpectrumBounds(T lambdaMin, T lambdaMax)
+    {
+        GISMO_ASSERT ( 0 < lambdaMin && lambdaMin < lambdaMax, "Invalid eigenvalue bounds. ");
+        m_lambdaMin = lambdaMin;
+        m_lambdaMax = lambdaMax;
+    }
+
+    /// Returns the (estimated) upper bound of the spectrum of \f$ D^{-1}A \f$
+    T lambdaMax() const { return m_lambdaMax; }
+
+    /// Returns the lower bound of the targeted eigenvalue interval
+    T lambdaMin() const { return m_lambdaMin; }
+
+    ///Returns the matrix
+    const MatrixType & matrix() const { return m_mat; }
+
+private:
+
+    /// Estimates the largest eigenvalue of \f$ D^{-1}A \f$ by
+    /// Lanczos steps on the similar matrix \f$ D^{-1/2}AD^{-1/2} \f$
+    T estimateMaxEigenvalue(index_t steps) const
+    {
+        const index_t n = m_mat.rows();
+        steps = math::min(steps, n);
+        const gsMatrix<T> dSqrt = m_diagInv.cwiseSqrt();
+        const gsMatrixOp<MatrixType> op(m_mat);
+
+        gsMatrix<T> T_(steps, steps);
+        T_.setZero();
+
+        // Deterministic start vector, not orthogonal to smooth modes
+        gsMatrix<T> v = gsVector<T>::LinSpaced(n, 1, 2), vPrev, w;
+        v /= v.norm();
+        vPrev.setZero(n, 1);
+        T beta = 0;
+        index_t k = 0;
+        for (; k < steps; ++k)
+        {
+            op.apply(dSqrt.asDiagonal() * v, w);
+            w = dSqrt.asDiagonal() * w;
+            const T alpha = v.col(0).dot(w.col(0));
+            w -= alpha * v + beta * vPrev;
+            T_(k,k) = alpha;
+            beta = w.norm();
+            if ( beta < 1e-12 * math::abs(alpha) || k + 1 == steps )
+                break;
+            T_(k,k+1) = T_(k+1,k) = beta;
+            vPrev.swap(v);
+            v = w / beta;
+        }
+        ++k;
+
+        Eigen::SelfAdjointEigenSolver< typename gsMatrix<T>::Base >
+            eig(T_.topLeftCorner(k,k), Eigen::EigenvaluesOnly);
+        return eig.eigenvalues().maxCoeff();
+    }
+
+private:
+    MatrixType m_mat; // expensive copy
+    gsMatrix<T> m_diagInv;
+    index_t m_degree;
+    T m_ratio;
+    T m_lambdaMin, m_lambdaMax;
+};
+
 } // namespace gismo
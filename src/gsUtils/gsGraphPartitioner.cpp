@@ -0,0 +1,435 @@
+/** @file gsGraphPartitioner.cpp
+
+    @brief Provides the partitioning of weighted graphs by multilevel
+    recursive bisection.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsUtils/gsGraphPartitioner.h>
+#include <gsCore/gsMath.h>
+
+#include <set>
+#include <numeric>
+
+namespace gismo
+{
+
+namespace
+{
+
+// A graph in compressed adjacency form
+struct graph
+{
+    std::vector<index_t> xadj, adj;
+    std::vector<real_t>  ewgt, vwgt;
+
+    index_t size() const { return static_cast<index_t>(vwgt.size()); }
+
+    real_t weight() const
+    { return std::accumulate(vwgt.begin(), vwgt.end(), real_t(0)); }
+};
+
+// Coarsest graphs are bisected directly
+const index_t coarsestSize = 20;
+
+unsigned nextRandom(unsigned & seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) & 0x7fff;
+}
+
+// Contracts the edges of a heavy-edge matching of g into c; cmap is
+// the vertex of c of every vertex of g. Returns false if the graph
+// does not shrink considerably.
+bool coarsen(const graph & g, graph & c, std::vector<index_t> & cmap, unsigned & seed)
+{
+    const index_t n = g.size();
+    // Do not create vertices much heavier than the average coarsest vertex
+    const real_t maxW = real_t(1.5) * g.weight() / coarsestSize;
+
+    std::vector<index_t> perm(n), match(n, -1);
+    for ( index_t i = 0; i != n; ++i )
+        perm[i] = i;
+    for ( index_t i = n - 1; i > 0; --i )
+        std::swap(perm[i], perm[nextRandom(seed) % (i + 1)]);
+
+    for ( index_t i = 0; i != n; ++i )
+    {
+        const index_t v = perm[i];
+        if ( -1 != match[v] )
+            continue;
+        index_t best = v;
+        real_t  bw   = -1;
+        for ( index_t e = g.xadj[v]; e != g.xadj[v+1]; ++e )
+        {
+            const index_t u = g.adj[e];
+            if ( -1 == match[u] && g.ewgt[e] > bw && g.vwgt[v] + g.vwgt[u] <= maxW )
+            {
+                best = u;
+                bw   = g.ewgt[e];
+            }
+        }
+        match[v]    = best;
+        match[best] = v;
+    }
+
+    // Coarse vertices are numbered by their first fine vertex
+    cmap.assign(n, -1);
+    index_t nc = 0;
+    for ( index_t v = 0; v != n; ++v )
+        if ( -1 == cmap[v] )
+            cmap[v] = cmap[match[v]] = nc++;
+    if ( nc > n * 19 / 20 )
+        return false;
+
+    c.vwgt.assign(nc, 0);
+    c.xadj.assign(1, 0);
+    c.adj .clear();
+    c.ewgt.clear();
+    std::vector<index_t> pos(nc, -1);
+    for ( index_t v = 0; v != n; ++v )
+    {
+        if ( match[v] < v )
+            continue; // visited with its partner
+        const index_t cv = cmap[v];
+        const index_t start = static_cast<index_t>(c.adj.size());
+        for ( index_t m = 0; m != (match[v] == v ? 1 : 2); ++m )
+        {
+            const index_t w = (0 == m ? v : match[v]);
+            c.vwgt[cv] += g.vwgt[w];
+            for ( index_t e = g.xadj[w]; e != g.xadj[w+1]; ++e )
+            {
+                const index_t cu = cmap[g.adj[e]];
+                if ( cu == cv )
+                    continue;
+                if ( pos[cu] >= start && c.adj[pos[cu]] == cu )
+                    c.ewgt[pos[cu]] += g.ewgt[e];
+                else
+                {
+                    pos[cu] = static_cast<index_t>(c.adj.size());
+                    c.adj .push_back(cu);
+                    c.ewgt.push_back(g.ewgt[e]);
+                }
+            }
+        }
+        c.xadj.push_back(static_cast<index_t>(c.adj.size()));
+    }
+    return true;
+}
+
+// The state of a bisection: side of every vertex, weights of the sides
+struct bisection
+{
+    const graph & g;
+    std::vector<index_t> & side;
+    real_t w[2], limit[2], cut;
+
+    bisection(const graph & _g, std::vector<index_t> & _side, real_t frac, real_t imb)
+    : g(_g), side(_side)
+    {
+        const real_t total = g.weight();
+        limit[0] = imb * frac * total;
+        limit[1] = imb * (1 - frac) * total;
+        update();
+    }
+
+    void update()
+    {
+        w[0] = w[1] = cut = 0;
+        for ( index_t v = 0; v != g.size(); ++v )
+        {
+            w[side[v]] += g.vwgt[v];
+            for ( index_t e = g.xadj[v]; e != g.xadj[v+1]; ++e )
+                if ( side[g.adj[e]] != side[v] && g.adj[e] > v )
+                    cut += g.ewgt[e];
+        }
+    }
+
+    // Weight exceeding the limits
+    real_t excess() const
+    { return math::max(w[0] - limit[0], real_t(0)) + math::max(w[1] - limit[1], real_t(0)); }
+
+    // Decrease of the cut when moving v to the other side
+    real_t gain(index_t v) const
+    {
+        real_t result = 0;
+        for ( index_t e = g.xadj[v]; e != g.xadj[v+1]; ++e )
+            result += ( side[g.adj[e]] != side[v] ? g.ewgt[e] : -g.ewgt[e] );
+        return result;
+    }
+
+    // True if the state is better than the one with excess ex and cut c
+    bool better(real_t ex, real_t c, real_t eps) const
+    {
+        const real_t e = excess();
+        return e < ex - eps || ( e <= ex + eps && cut < c - eps );
+    }
+
+    // Fiduccia-Mattheyses refinement
+    void refine()
+    {
+        const index_t n = g.size();
+        const real_t eps = 1e-12 * (w[0] + w[1] + 1);
+        std::vector<real_t> gains(n);
+        std::vector<bool> locked(n);
+        std::vector<index_t> moves;
+        for ( index_t pass = 0; pass != 10; ++pass )
+        {
+            std::set<std::pair<real_t,index_t> > queue; // by decreasing gain
+            for ( index_t v = 0; v != n; ++v )
+            {
+                gains[v] = gain(v);
+                queue.insert( std::make_pair(-gains[v], v) );
+            }
+            locked.assign(n, false);
+            moves.clear();
+            real_t bestEx = excess(), bestCut = cut;
+            size_t bestLen = 0;
+            const size_t maxUseless = 50 + n / 10;
+
+            while ( !queue.empty() && moves.size() - bestLen < maxUseless )
+            {
+                // The best move which does not worsen the balance
+                std::set<std::pair<real_t,index_t> >::iterator it = queue.begin();
+                for (; it != queue.end(); ++it )
+                {
+                    const index_t v = it->second, s = side[v];
+                    if ( w[1-s] + g.vwgt[v] <= limit[1-s] || w[s] > limit[s] )
+                        break;
+                }
+                if ( it == queue.end() )
+                    break;
+
+                const index_t v = it->second, s = side[v];
+                queue.erase(it);
+                locked[v] = true;
+                side[v]   = 1 - s;
+                w[s]     -= g.vwgt[v];
+                w[1-s]   += g.vwgt[v];
+                cut      -= gains[v];
+                moves.push_back(v);
+                for ( index_t e = g.xadj[v]; e != g.xadj[v+1]; ++e )
+                {
+                    const index_t u = g.adj[e];
+                    if ( locked[u] )
+                        continue;
+                    queue.erase( std::make_pair(-gains[u], u) );
+                    gains[u] += ( side[u] == side[v] ? -2 : 2 ) * g.ewgt[e];
+                    queue.insert( std::make_pair(-gains[u], u) );
+                }
+
+                if ( better(bestEx, bestCut, eps) )
+                {
+                    bestEx  = excess();
+                    bestCut = cut;
+                    bestLen = moves.size();
+                }
+            }
+
+            // Undo the moves after the best state
+            for ( size_t i = moves.size(); i != bestLen; --i )
+                side[moves[i-1]] = 1 - side[moves[i-1]];
+            update();
+            if ( 0 == bestLen )
+                break;
+        }
+    }
+};
+
+// Grows side 0 from vertex s, adding the vertex with the largest gain
+void grow(const graph & g, index_t s, real_t target, std::vector<index_t> & side)
+{
+    const index_t n = g.size();
+    side.assign(n, 1);
+    std::vector<real_t> conn(n, 0), deg(n, 0);
+    for ( index_t v = 0; v != n; ++v )
+        for ( index_t e = g.xadj[v]; e != g.xadj[v+1]; ++e )
+            deg[v] += g.ewgt[e];
+
+    real_t w0 = 0;
+    for ( index_t v = s; ; )
+    {
+        side[v] = 0;
+        w0 += g.vwgt[v];
+        for ( index_t e = g.xadj[v]; e != g.xadj[v+1]; ++e )
+            conn[g.adj[e]] += g.ewgt[e];
+
+        // Next vertex: the largest gain on the frontier, or any vertex
+        v = -1;
+        real_t best = 0;
+        bool frontier = false;
+        for ( index_t u = 0; u != n; ++u )
+        {
+            if ( 0 == side[u] )
+                continue;
+            const bool f = conn[u] > 0;
+            const real_t gu = 2 * conn[u] - deg[u];
+            if ( -1 == v || (f && !frontier) || (f == frontier && gu > best) )
+            {
+                v = u;
+                best = gu;
+                frontier = f;
+            }
+        }
+        // Stop if the target is met, or is closer than after adding v
+        if ( -1 == v || w0 + g.vwgt[v] - target > target - w0 )
+            break;
+    }
+}
+
+void bisect(const graph & g, real_t frac, real_t imb, std::vector<index_t> & side,
+            unsigned & seed)
+{
+    const index_t n = g.size();
+    side.assign(n, 0);
+    if ( n < 2 )
+        return;
+
+    if ( n > coarsestSize )
+    {
+        graph c;
+        std::vector<index_t> cmap, cside;
+        if ( coarsen(g, c, cmap, seed) )
+        {
+            bisect(c, frac, imb, cside, seed);
+            for ( index_t v = 0; v != n; ++v )
+                side[v] = cside[cmap[v]];
+            bisection(g, side, frac, imb).refine();
+            return;
+        }
+    }
+
+    // Greedy growing from several seeds, keep the best split
+    const real_t target = frac * g.weight();
+    const real_t eps = 1e-12 * (g.weight() + 1);
+    const index_t tries = math::min(n, index_t(n > 1000 ? 4 : 8));
+    std::vector<index_t> trial;
+    real_t bestEx = 0, bestCut = 0;
+    for ( index_t t = 0; t != tries; ++t )
+    {
+        grow(g, 0 == t ? 0 : nextRandom(seed) % n, target, trial);
+        bisection b(g, trial, frac, imb);
+        b.refine();
+        if ( 0 == t || b.better(bestEx, bestCut, eps) )
+        {
+            bestEx  = b.excess();
+            bestCut = b.cut;
+            side    = trial;
+        }
+    }
+}
+
+// Splits the graph g with vertices ids into parts first to first+nParts-1
+void recurse(const graph & g, const std::vector<index_t> & ids, index_t nParts,
+             index_t first, real_t imb, std::vector<index_t> & result, unsigned & seed)
+{
+    const index_t n = g.size();
+    if ( 1 == nParts || 0 == n )
+    {
+        for ( index_t v = 0; v != n; ++v )
+            result[ids[v]] = first;
+        return;
+    }
+
+    const index_t n0 = nParts / 2;
+    std::vector<index_t> side;
+    bisect(g, static_cast<real_t>(n0) / nParts, imb, side, seed);
+
+    // The subgraphs induced by the two sides
+    std::vector<index_t> loc(n);
+    graph sub[2];
+    std::vector<index_t> subIds[2];
+    for ( index_t v = 0; v != n; ++v )
+    {
+        loc[v] = static_cast<index_t>( subIds[side[v]].size() );
+        subIds[side[v]].push_back(ids[v]);
+        sub[side[v]].vwgt.push_back(g.vwgt[v]);
+    }
+    for ( index_t s = 0; s != 2; ++s )
+        sub[s].xadj.assign(1, 0);
+    for ( index_t v = 0; v != n; ++v )
+    {
+        graph & h = sub[side[v]];
+        for ( index_t e = g.xadj[v]; e != g.xadj[v+1]; ++e )
+            if ( side[g.adj[e]] == side[v] )
+            {
+                h.adj .push_back( loc[g.adj[e]] );
+                h.ewgt.push_back( g.ewgt[e] );
+            }
+        h.xadj.push_back( static_cast<index_t>(h.adj.size()) );
+    }
+
+    recurse(sub[0], subIds[0], n0, first, imb, result, seed);
+    recurse(sub[1], subIds[1], nParts - n0, first + n0, imb, result, seed);
+}
+
+} // anonymous namespace
+
+void gsGraphPartitioner::addEdge(index_t u, index_t v, real_t w)
+{
+    GISMO_ASSERT( u >= 0 && v >= 0 && u < numVertices() && v < numVertices(),
+                  "Invalid edge ("<<u<<","<<v<<")");
+    if ( u == v )
+        return;
+    m_edges.push_back( std::make_pair(math::min(u,v), math::max(u,v)) );
+    m_ewgt.push_back(w);
+}
+
+void gsGraphPartitioner::partition(index_t nParts, std::vector<index_t> & result,
+                                   real_t imbalance, unsigned seed) const
+{
+    GISMO_ENSURE( nParts > 0, "Invalid number of parts "<<nParts );
+    const index_t n = numVertices();
+
+    // Adjacency lists, merging repeated edges
+    std::vector<std::vector<std::pair<index_t,real_t> > > nb(n);
+    for ( size_t i = 0; i != m_edges.size(); ++i )
+    {
+        nb[m_edges[i].first ].push_back( std::make_pair(m_edges[i].second, m_ewgt[i]) );
+        nb[m_edges[i].second].push_back( std::make_pair(m_edges[i].first , m_ewgt[i]) );
+    }
+    graph g;
+    g.vwgt = m_vwgt;
+    g.xadj.push_back(0);
+    for ( index_t v = 0; v != n; ++v )
+    {
+        std::sort(nb[v].begin(), nb[v].end());
+        for ( size_t k = 0; k != nb[v].size(); ++k )
+        {
+            if ( k > 0 && nb[v][k].first == nb[v][k-1].first )
+                g.ewgt.back() += nb[v][k].second;
+            else
+            {
+                g.adj .push_back(nb[v][k].first);
+                g.ewgt.push_back(nb[v][k].second);
+            }
+        }
+        g.xadj.push_back( static_cast<index_t>(g.adj.size()) );
+    }
+
+    // Share the tolerance among the levels of the recursion
+    const real_t levels = math::max(math::ceil( math::log(real_t(nParts)) / math::log(real_t(2)) ), real_t(1));
+    const real_t imb = math::pow(math::max(imbalance, real_t(1)), 1 / levels);
+
+    std::vector<index_t> ids(n);
+    for ( index_t v = 0; v != n; ++v )
+        ids[v] = v;
+    result.assign(n, 0);
+    recurse(g, ids, nParts, 0, imb, result, seed);
+}
+
+real_t gsGraphPartitioner::edgeCut(const std::vector<index_t> & part) const
+{
+    real_t result = 0;
+    for ( size_t i = 0; i != m_edges.size(); ++i )
+        if ( part[m_edges[i].first] != part[m_edges[i].second] )
+            result += m_ewgt[i];
+    return result;
+}
+
+} // namespace gismo
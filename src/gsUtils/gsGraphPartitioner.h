@@ -0,0 +1,92 @@
+/** @file gsGraphPartitioner.h
+
+    @brief Provides the partitioning of weighted graphs by multilevel
+    recursive bisection.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+
+namespace gismo
+{
+
+/**
+   @brief Partitions an undirected graph with weighted vertices and
+   edges into parts of approximately equal weight, such that the
+   weight of the edges between different parts (the edge cut) is
+   small.
+
+   The graph is split by recursive bisection. Every bisection is
+   multilevel: the graph is coarsened by heavy-edge matching, the
+   coarsest graph is split by greedy graph growing, and the split is
+   improved by Fiduccia-Mattheyses refinement while the graph is
+   uncoarsened.
+
+   \verbatim
+   gsGraphPartitioner g(4);
+   g.addEdge(0, 1); g.addEdge(1, 2); g.addEdge(2, 3, 10);
+   std::vector<index_t> part;
+   g.partition(2, part); // {0,0,1,1}
+   \endverbatim
+
+   \ingroup Utils
+*/
+class GISMO_EXPORT gsGraphPartitioner
+{
+public:
+
+    /// A graph with \a n vertices of weight one and no edges
+    explicit gsGraphPartitioner(index_t n = 0) : m_vwgt(n, 1) { }
+
+    /// Number of vertices
+    index_t numVertices() const { return static_cast<index_t>(m_vwgt.size()); }
+
+    /// Adds a vertex with weight \a w and returns its index
+    index_t addVertex(real_t w = 1)
+    {
+        m_vwgt.push_back(w);
+        return numVertices() - 1;
+    }
+
+    /// Sets the weight of vertex \a v
+    void setVertexWeight(index_t v, real_t w) { m_vwgt[v] = w; }
+
+    /// The weight of vertex \a v
+    real_t vertexWeight(index_t v) const { return m_vwgt[v]; }
+
+    /// \brief Adds an edge between \a u and \a v with weight \a w;
+    /// the weights of repeated edges are summed up
+    void addEdge(index_t u, index_t v, real_t w = 1);
+
+    /**
+       \brief Computes the part of every vertex.
+
+       \param nParts the number of parts
+       \param[out] result the part (0 to nParts-1) of every vertex
+       \param imbalance the tolerated ratio of the weight of a part
+       to the average weight of the parts
+       \param seed seed of the random choices
+    */
+    void partition(index_t nParts, std::vector<index_t> & result,
+                   real_t imbalance = 1.03, unsigned seed = 1) const;
+
+    /// The weight of the edges between different parts of \a part
+    real_t edgeCut(const std::vector<index_t> & part) const;
+
+private:
+
+    std::vector<real_t> m_vwgt;
+
+    /// Edges (u < v) and their weights
+    std::vector<std::pair<index_t,index_t> > m_edges;
+    std::vector<real_t> m_ewgt;
+};
+
+} // namespace gismo
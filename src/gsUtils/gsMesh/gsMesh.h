@@ -134,6 +134,13 @@ public:
 //        }
 //    }
 
+    /// Reserves memory for \a nVertices vertices and \a nFaces faces
+    void reserve(size_t nVertices, size_t nFaces)
+    {
+        vertex.reserve(nVertices);
+        face.reserve(nFaces);
+    }
+
     /** \brief reorders the vertices of all faces of an .stl mesh, such that only 1 vertex is used instead of #(adjacent triangles) vertices
      */
     void cleanStlMesh();
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <gsUtils/gsMesh/gsVertexHashMap.h>
+
 namespace gismo {
 
 
@@ -173,20 +175,21 @@ void gsMesh<T>::cleanStlMesh()
     // vertices. The old way was more efficient but did not work for
     // non-manifold solids.
     
-    // build up the unique map
+    // build up the unique map, the first vertex with given
+    // coordinates is found by hashing
     std::vector<int> uniquemap;
+    uniquemap.reserve(vertex.size());
+    gsVertexHashMap<T> unique(vertex.size());
     for(std::size_t i = 0; i < vertex.size(); i++)
     {
-        std::size_t buddy = i;
-        for(std::size_t j = 0; j < i; j++)
+        const VertexHandle buddy = unique.find(vertex[i]);
+        if ( buddy )
+            uniquemap.push_back(buddy->getId());
+        else
         {
-            if(*(vertex[i]) == *(vertex[j])) // overload compares coords
-            {
-                buddy = j;
-                break;
-            }
+            unique.insert(vertex[i]);
+            uniquemap.push_back(i);
         }
-        uniquemap.push_back(buddy);
     }
     
     for(std::size_t i = 0; i < face.size(); i++)
@@ -0,0 +1,130 @@
+/** @file gsVertexHashMap.h
+
+    @brief Provides a hash table of mesh vertices, used to merge
+    vertices with equal coordinates.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsUtils/gsMesh/gsVertex.h>
+
+#include <cstring>
+
+namespace gismo {
+
+/**
+   \brief Hash table of vertex handles, keyed by the (exact)
+   coordinates of the vertices.
+
+   Lookup and insertion take constant expected time, hence a mesh
+   with n vertices is merged in O(n) instead of the O(n^2) pairwise
+   comparisons. The table does not own the vertices.
+
+   \ingroup Utils
+*/
+template <class T>
+class gsVertexHashMap
+{
+public:
+    typedef typename gsVertex<T>::gsVertexHandle VertexHandle;
+
+public:
+
+    /// Constructor, \a expected is the expected number of vertices
+    explicit gsVertexHashMap(size_t expected = 0) : m_size(0)
+    {
+        size_t cap = 16;
+        while ( cap < 2 * expected )
+            cap <<= 1;
+        m_table.assign(cap, VertexHandle(NULL));
+    }
+
+    /// Returns the vertex with coordinates (\a x, \a y, \a z), or NULL
+    VertexHandle find(const T & x, const T & y, const T & z) const
+    {
+        const size_t mask = m_table.size() - 1;
+        for ( size_t i = hash(x,y,z) & mask; m_table[i]; i = (i + 1) & mask )
+        {
+            const VertexHandle v = m_table[i];
+            if ( v->x() == x && v->y() == y && v->z() == z )
+                return v;
+        }
+        return NULL;
+    }
+
+    /// Returns the vertex with the coordinates of \a v, or NULL
+    VertexHandle find(const VertexHandle & v) const
+    { return find(v->x(), v->y(), v->z()); }
+
+    /// \brief Inserts \a v. A vertex with the same coordinates must
+    /// not be contained in the table (see find())
+    void insert(const VertexHandle & v)
+    {
+        if ( 2 * (m_size + 1) > m_table.size() )
+            rehash(2 * m_table.size());
+        place(v);
+        ++m_size;
+    }
+
+    /// Number of vertices in the table
+    size_t size() const { return m_size; }
+
+private:
+
+    void place(const VertexHandle & v)
+    {
+        const size_t mask = m_table.size() - 1;
+        size_t i = hash(v->x(), v->y(), v->z()) & mask;
+        while ( m_table[i] )
+            i = (i + 1) & mask;
+        m_table[i] = v;
+    }
+
+    void rehash(const size_t cap)
+    {
+        std::vector<VertexHandle> old(cap, VertexHandle(NULL));
+        old.swap(m_table);
+        for ( typename std::vector<VertexHandle>::const_iterator it = old.begin();
+              it != old.end(); ++it )
+            if ( *it ) place(*it);
+    }
+
+    // FNV-1a on the bytes of the coordinates in double precision
+    // (equal values give equal doubles, -0 is mapped to +0)
+    static size_t hash(const T & x, const T & y, const T & z)
+    {
+        unsigned long long h = 14695981039346656037ULL;
+        hashValue(h, static_cast<double>(x));
+        hashValue(h, static_cast<double>(y));
+        hashValue(h, static_cast<double>(z));
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    static void hashValue(unsigned long long & h, double val)
+    {
+        if ( 0 == val )
+            val = 0;
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, &val, sizeof(double));
+        for ( size_t k = 0; k != sizeof(double); ++k )
+        {
+            h ^= bytes[k];
+            h *= 1099511628211ULL;
+        }
+    }
+
+private:
+
+    /// Open addressing table, the size is a power of two
+    std::vector<VertexHandle> m_table;
+
+    size_t m_size;
+};
+
+} // namespace gismo
@@ -0,0 +1,138 @@
+/** @file gsPatchPartitioner.h
+
+    @brief Provides the load-balanced distribution of the patches of a
+    multipatch discretization to processes or threads.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsIO/gsOptionList.h>
+
+namespace gismo
+{
+
+/**
+   \brief Distributes the patches of a gsMultiBasis to a number of
+   parts (processes or threads) such that the parts have approximately
+   the same cost and the interfaces between the parts are small.
+
+   The cost of a patch is estimated by the number of its elements
+   times \f$\prod_i (p_i+1)^2\f$, i.e. \f$(p+1)^{2d}\f$ for degree
+   \em p in every direction, which is proportional to the assembly
+   work and to the number of non-zeros of its matrix rows. Patches
+   which are heavier than \em BlockFraction times the average weight
+   of a part are split along knot lines into blocks of knot spans
+   (recursively halving the direction with the most spans). The
+   blocks must be small compared to the tolerated imbalance, hence
+   the small default fraction.
+
+   The blocks form a graph: blocks sharing a face, within a patch or
+   across an interface of the topology, are connected by an edge
+   weighted with the number of elements along the face. The graph is
+   partitioned with gsGraphPartitioner.
+
+   \verbatim
+   gsPatchPartitioner<> part(bases);
+   part.compute(comm.size());
+   part.elementParts(k); // the part of every element of patch k
+   \endverbatim
+
+   The multi-basis is referenced and must outlive the partitioner.
+
+   \ingroup Utils
+*/
+template<class T>
+class gsPatchPartitioner
+{
+public:
+
+    /// A box of knot spans of a patch and its part
+    struct block
+    {
+        index_t patch;
+        /// Lower and upper knot span index (exclusive) in every direction
+        gsVector<index_t> lower, upper;
+        index_t numElements;
+        T weight;
+        index_t part;
+    };
+
+public:
+
+    explicit gsPatchPartitioner(const gsMultiBasis<T> & mb,
+                                const gsOptionList & opt = defaultOptions());
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addReal  ("Imbalance", "Tolerated ratio of the weight of a part to the average weight of the parts", 1.05);
+        opt.addSwitch("SplitPatches", "Split heavy patches into blocks of knot spans", true);
+        opt.addReal  ("BlockFraction", "Patches and blocks heavier than this fraction of the average weight of a part are split", 0.02);
+        return opt;
+    }
+
+    /// Returns the options (used by the next call of compute())
+    gsOptionList & options() { return m_options; }
+
+    /// Computes the distribution into \a nParts parts
+    void compute(index_t nParts);
+
+    /// The number of parts
+    index_t numParts() const { return m_nParts; }
+
+    /// The blocks of all patches
+    const std::vector<block> & blocks() const { return m_blocks; }
+
+    /// \brief The part of every element of patch \a k, in the order
+    /// of the domain iterator of the basis
+    const std::vector<index_t> & elementParts(size_t k) const { return m_elParts[k]; }
+
+    /// The part holding the largest share of every patch
+    std::vector<index_t> patchParts() const;
+
+    /// The weight of every part
+    gsVector<T> partWeights() const;
+
+    /// The ratio of the heaviest part to the average part
+    T imbalance() const;
+
+    /// The weight of the graph edges between different parts
+    T edgeCut() const { return m_cut; }
+
+    /// The estimated cost of the basis \a basis
+    static T patchWeight(const gsBasis<T> & basis);
+
+private:
+
+    /// Knot lines and element centers (as span indices) of patch k
+    void patchGrid(size_t k, std::vector<std::vector<T> > & breaks,
+                   gsMatrix<index_t> & centers) const;
+
+private:
+
+    const gsMultiBasis<T> * m_bases;
+
+    gsOptionList m_options;
+
+    index_t m_nParts;
+
+    std::vector<block> m_blocks;
+
+    std::vector<std::vector<index_t> > m_elParts;
+
+    T m_cut;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsPatchPartitioner.hpp)
+#endif
@@ -0,0 +1,303 @@
+/** @file gsPatchPartitioner.hpp
+
+    @brief Provides implementation of the load-balanced distribution
+    of the patches of a multipatch discretization.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsUtils/gsPatchPartitioner.h>
+#include <gsUtils/gsGraphPartitioner.h>
+#include <gsCore/gsMultiBasis.h>
+#include <gsCore/gsDomainIterator.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace gismo
+{
+
+template<class T>
+gsPatchPartitioner<T>::gsPatchPartitioner(const gsMultiBasis<T> & mb,
+                                          const gsOptionList & opt)
+: m_bases(&mb), m_options(opt), m_nParts(0), m_cut(0)
+{ }
+
+template<class T>
+T gsPatchPartitioner<T>::patchWeight(const gsBasis<T> & basis)
+{
+    T result = basis.numElements();
+    for ( index_t i = 0; i != basis.dim(); ++i )
+        result *= (basis.degree(i) + 1) * (basis.degree(i) + 1);
+    return result;
+}
+
+template<class T>
+void gsPatchPartitioner<T>::patchGrid(size_t k, std::vector<std::vector<T> > & breaks,
+                                      gsMatrix<index_t> & centers) const
+{
+    const gsBasis<T> & basis = (*m_bases)[k];
+    const index_t d = basis.dim();
+    breaks.assign(d, std::vector<T>());
+    std::vector<gsVector<T> > mid;
+    typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator();
+    for (; domIt->good(); domIt->next() )
+    {
+        for ( index_t i = 0; i != d; ++i )
+        {
+            breaks[i].push_back( domIt->lowerCorner()[i] );
+            breaks[i].push_back( domIt->upperCorner()[i] );
+        }
+        mid.push_back( (domIt->lowerCorner() + domIt->upperCorner()) / 2 );
+    }
+    for ( index_t i = 0; i != d; ++i )
+    {
+        std::sort(breaks[i].begin(), breaks[i].end());
+        breaks[i].erase( std::unique(breaks[i].begin(), breaks[i].end()), breaks[i].end() );
+    }
+
+    centers.resize(d, mid.size());
+    for ( size_t e = 0; e != mid.size(); ++e )
+        for ( index_t i = 0; i != d; ++i )
+            centers(i, e) = static_cast<index_t>(
+                std::upper_bound(breaks[i].begin(), breaks[i].end(), mid[e][i])
+                - breaks[i].begin() ) - 1;
+}
+
+namespace internal
+{
+
+/// True for the elements whose center lies below \a value in the
+/// direction \a dir
+struct centerBelow
+{
+    centerBelow(const gsMatrix<index_t> & centers, index_t dir, index_t value)
+    : m_centers(&centers), m_dir(dir), m_value(value) { }
+
+    bool operator()(const index_t e) const
+    { return (*m_centers)(m_dir, e) < m_value; }
+
+    const gsMatrix<index_t> * m_centers;
+    index_t m_dir, m_value;
+};
+
+} // namespace internal
+
+template<class T>
+void gsPatchPartitioner<T>::compute(index_t nParts)
+{
+    GISMO_ENSURE( nParts > 0, "Invalid number of parts "<<nParts );
+    const gsMultiBasis<T> & mb = *m_bases;
+    const size_t np = mb.nBases();
+    const index_t d = mb.dim();
+    m_nParts = nParts;
+
+    // Element grid and element weight of every patch
+    std::vector<std::vector<std::vector<T> > > breaks(np);
+    std::vector<gsMatrix<index_t> > centers(np);
+    std::vector<T> elWeight(np), faceWeight(np);
+    T total = 0;
+    for ( size_t k = 0; k != np; ++k )
+    {
+        patchGrid(k, breaks[k], centers[k]);
+        elWeight[k] = faceWeight[k] = 1;
+        for ( index_t i = 0; i != d; ++i )
+        {
+            elWeight  [k] *= (mb[k].degree(i) + 1) * (mb[k].degree(i) + 1);
+            faceWeight[k] *= (mb[k].degree(i) + 1);
+        }
+        total += centers[k].cols() * elWeight[k];
+    }
+
+    // Blocks, splitting the heavy ones. The elements of a block are
+    // a range of els, which is partitioned along with the block.
+    const T maxWeight = m_options.getSwitch("SplitPatches") ?
+        m_options.getReal("BlockFraction") * total / nParts : std::numeric_limits<T>::max();
+    m_blocks.clear();
+    std::vector<size_t> firstBlock(np + 1, 0);
+    std::vector<std::vector<index_t> > elBlock(np);
+    for ( size_t k = 0; k != np; ++k )
+    {
+        const index_t nEl = centers[k].cols();
+        std::vector<index_t> els(nEl);
+        for ( index_t e = 0; e != nEl; ++e )
+            els[e] = e;
+        elBlock[k].resize(nEl);
+
+        std::vector<block> stack(1);
+        std::vector<std::pair<index_t,index_t> > ranges(1, std::make_pair(0, nEl));
+        block & b = stack.front();
+        b.patch = k;
+        b.lower.setZero(d);
+        b.upper.resize(d);
+        for ( index_t i = 0; i != d; ++i )
+            b.upper[i] = static_cast<index_t>(breaks[k][i].size()) - 1;
+        b.numElements = nEl;
+        while ( !stack.empty() )
+        {
+            block cur = stack.back();
+            const std::pair<index_t,index_t> range = ranges.back();
+            stack.pop_back();
+            ranges.pop_back();
+            cur.weight = cur.numElements * elWeight[k];
+            index_t dir;
+            const index_t spans = (cur.upper - cur.lower).maxCoeff(&dir);
+            if ( cur.weight <= maxWeight || spans < 2 )
+            {
+                cur.part = 0;
+                for ( index_t i = range.first; i != range.second; ++i )
+                    elBlock[k][els[i]] = static_cast<index_t>(m_blocks.size());
+                m_blocks.push_back(cur);
+                continue;
+            }
+            block other = cur;
+            cur.upper[dir] = other.lower[dir] = cur.lower[dir] + spans / 2;
+            const index_t split = static_cast<index_t>(
+                std::partition(els.begin() + range.first, els.begin() + range.second,
+                               internal::centerBelow(centers[k], dir, cur.upper[dir]))
+                - els.begin() );
+            cur  .numElements = split - range.first;
+            other.numElements = range.second - split;
+            stack.push_back(other);
+            ranges.push_back( std::make_pair(split, range.second) );
+            stack.push_back(cur);
+            ranges.push_back( std::make_pair(range.first, split) );
+        }
+        firstBlock[k+1] = m_blocks.size();
+    }
+
+    gsGraphPartitioner graph( static_cast<index_t>(m_blocks.size()) );
+    for ( size_t b = 0; b != m_blocks.size(); ++b )
+        graph.setVertexWeight(b, m_blocks[b].weight);
+
+    // Edges between the blocks of a patch sharing a face
+    for ( size_t k = 0; k != np; ++k )
+        for ( size_t a = firstBlock[k]; a != firstBlock[k+1]; ++a )
+            for ( size_t b = a + 1; b != firstBlock[k+1]; ++b )
+            {
+                const block & A = m_blocks[a], & B = m_blocks[b];
+                for ( index_t i = 0; i != d; ++i )
+                {
+                    if ( A.upper[i] != B.lower[i] && B.upper[i] != A.lower[i] )
+                        continue;
+                    T face = faceWeight[k];
+                    for ( index_t j = 0; j != d && face > 0; ++j )
+                        if ( j != i )
+                            face *= math::max<index_t>(0, math::min(A.upper[j], B.upper[j])
+                                                       - math::max(A.lower[j], B.lower[j]) );
+                    if ( face > 0 )
+                        graph.addEdge(a, b, face);
+                }
+            }
+
+    // Edges between the blocks at the interfaces, weighted by the
+    // overlap of their faces
+    const gsBoxTopology & topo = mb.topology();
+    for ( index_t f = 0; f != topo.nInterfaces(); ++f )
+    {
+        const boundaryInterface & bi = topo.bInterface(f);
+        const patchSide & s1 = bi.first(), & s2 = bi.second();
+        const index_t k1 = s1.patch, k2 = s2.patch;
+        const index_t n1 = s1.direction(), n2 = s2.direction();
+        T faces1 = 1, faces2 = 1;
+        for ( index_t i = 0; i != d; ++i )
+        {
+            if ( i != n1 ) faces1 *= breaks[k1][i].size() - 1;
+            if ( i != n2 ) faces2 *= breaks[k2][i].size() - 1;
+        }
+        const T face = math::max(faces1, faces2) * (faceWeight[k1] + faceWeight[k2]) / 2;
+
+        for ( size_t a = firstBlock[k1]; a != firstBlock[k1+1]; ++a )
+        {
+            const block & A = m_blocks[a];
+            if ( s1.parameter() ? A.upper[n1] + 1 != static_cast<index_t>(breaks[k1][n1].size())
+                 : 0 != A.lower[n1] )
+                continue;
+            for ( size_t b = firstBlock[k2]; b != firstBlock[k2+1]; ++b )
+            {
+                const block & B = m_blocks[b];
+                if ( s2.parameter() ? B.upper[n2] + 1 != static_cast<index_t>(breaks[k2][n2].size())
+                     : 0 != B.lower[n2] )
+                    continue;
+
+                // Fraction of the interface shared by the faces
+                T overlap = 1;
+                for ( index_t i = 0; i != d && overlap > 0; ++i )
+                {
+                    if ( i == n1 )
+                        continue;
+                    const index_t j = bi.dirMap()[i];
+                    const std::vector<T> & b1 = breaks[k1][i], & b2 = breaks[k2][j];
+                    const T len1 = b1.back() - b1.front(), len2 = b2.back() - b2.front();
+                    T lo1 = (b1[A.lower[i]] - b1.front()) / len1,
+                      up1 = (b1[A.upper[i]] - b1.front()) / len1;
+                    if ( !bi.dirOrientation()[i] )
+                    {
+                        std::swap(lo1, up1);
+                        lo1 = 1 - lo1;
+                        up1 = 1 - up1;
+                    }
+                    const T lo2 = (b2[B.lower[j]] - b2.front()) / len2,
+                            up2 = (b2[B.upper[j]] - b2.front()) / len2;
+                    overlap *= math::max(T(0), math::min(up1, up2) - math::max(lo1, lo2));
+                }
+                if ( overlap > 0 )
+                    graph.addEdge(a, b, overlap * face);
+            }
+        }
+    }
+
+    std::vector<index_t> part;
+    graph.partition(nParts, part, m_options.getReal("Imbalance"));
+    for ( size_t b = 0; b != m_blocks.size(); ++b )
+        m_blocks[b].part = part[b];
+    m_cut = graph.edgeCut(part);
+
+    // The part of every element
+    m_elParts.resize(np);
+    for ( size_t k = 0; k != np; ++k )
+    {
+        m_elParts[k].resize(elBlock[k].size());
+        for ( size_t e = 0; e != elBlock[k].size(); ++e )
+            m_elParts[k][e] = m_blocks[elBlock[k][e]].part;
+    }
+}
+
+template<class T>
+std::vector<index_t> gsPatchPartitioner<T>::patchParts() const
+{
+    const size_t np = m_bases->nBases();
+    gsMatrix<T> share;
+    share.setZero(np, m_nParts);
+    for ( size_t b = 0; b != m_blocks.size(); ++b )
+        share(m_blocks[b].patch, m_blocks[b].part) += m_blocks[b].weight;
+    std::vector<index_t> result(np);
+    for ( size_t k = 0; k != np; ++k )
+        share.row(k).maxCoeff(&result[k]);
+    return result;
+}
+
+template<class T>
+gsVector<T> gsPatchPartitioner<T>::partWeights() const
+{
+    gsVector<T> result;
+    result.setZero(m_nParts);
+    for ( size_t b = 0; b != m_blocks.size(); ++b )
+        result[m_blocks[b].part] += m_blocks[b].weight;
+    return result;
+}
+
+template<class T>
+T gsPatchPartitioner<T>::imbalance() const
+{
+    const gsVector<T> w = partWeights();
+    return w.maxCoeff() * m_nParts / w.sum();
+}
+
+} // namespace gismo
@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsUtils/gsPatchPartitioner.h>
+#include <gsUtils/gsPatchPartitioner.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsPatchPartitioner<real_t>;
+
+}
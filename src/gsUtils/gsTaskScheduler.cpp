@@ -0,0 +1,489 @@
+/** @file gsTaskScheduler.cpp
+
+    @brief Provides a work-stealing thread pool which is aware of the
+    placement of the MPI processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsUtils/gsTaskScheduler.h>
+
+#include <stdexcept>
+#include <cstdlib>
+
+#ifdef GISMO_BUILD_CPP11
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace gismo
+{
+
+namespace
+{
+
+int numProcessors()
+{
+#ifdef GISMO_BUILD_CPP11
+    const int n = static_cast<int>(std::thread::hardware_concurrency());
+    if ( n > 0 )
+        return n;
+#endif
+#if defined(_SC_NPROCESSORS_ONLN)
+    const long m = sysconf(_SC_NPROCESSORS_ONLN);
+    if ( m > 0 )
+        return static_cast<int>(m);
+#endif
+    return 1;
+}
+
+// Pins the calling thread to a core, returns false on failure
+bool pinToCore(const int core)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return 0 == pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+#else
+    GISMO_UNUSED(core);
+    return false;
+#endif
+}
+
+// The rank of the process among the processes on its node and their
+// number, as exported by the common MPI launchers; false if unknown
+bool localRankFromEnv(int & rank, int & size)
+{
+    static const char * const vars[][2] = {
+        {"OMPI_COMM_WORLD_LOCAL_RANK", "OMPI_COMM_WORLD_LOCAL_SIZE"}, // Open MPI
+        {"MPI_LOCALRANKID"           , "MPI_LOCALNRANKS"           }, // MPICH, Intel MPI
+        {"MV2_COMM_WORLD_LOCAL_RANK" , "MV2_COMM_WORLD_LOCAL_SIZE" }  // MVAPICH2
+    };
+    for ( size_t i = 0; i != sizeof(vars) / sizeof(vars[0]); ++i )
+    {
+        const char * r = std::getenv(vars[i][0]);
+        const char * s = std::getenv(vars[i][1]);
+        if ( r && s && std::atoi(s) > 0 && std::atoi(r) >= 0 && std::atoi(r) < std::atoi(s) )
+        {
+            rank = std::atoi(r);
+            size = std::atoi(s);
+            return true;
+        }
+    }
+    return false;
+}
+
+// The settings of the thread which started the scheduler that are
+// changed by the scheduler; restored on destruction
+class SavedState
+{
+public:
+    SavedState() : m_ompThreads(0), m_pinned(false) { }
+
+    ~SavedState()
+    {
+#ifdef _OPENMP
+        if ( m_ompThreads > 0 )
+            omp_set_num_threads(m_ompThreads);
+#endif
+#if defined(__linux__)
+        if ( m_pinned )
+            pthread_setaffinity_np(m_thread, sizeof(cpu_set_t), &m_affinity);
+#endif
+    }
+
+    // Pins the calling thread to a core, returns false on failure
+    bool pin(const int core)
+    {
+#if defined(__linux__)
+        m_thread = pthread_self();
+        if ( 0 != pthread_getaffinity_np(m_thread, sizeof(cpu_set_t), &m_affinity) )
+            return false;
+        m_pinned = pinToCore(core);
+        return m_pinned;
+#else
+        return pinToCore(core);
+#endif
+    }
+
+    // Sets the number of threads of the OpenMP regions started by the
+    // calling thread
+    void limitOpenMP(const int nThreads)
+    {
+#ifdef _OPENMP
+        m_ompThreads = omp_get_max_threads();
+        omp_set_num_threads(nThreads);
+#else
+        GISMO_UNUSED(nThreads);
+#endif
+    }
+
+private:
+    int  m_ompThreads;
+    bool m_pinned;
+#if defined(__linux__)
+    pthread_t m_thread;
+    cpu_set_t m_affinity;
+#endif
+};
+
+}
+
+#ifdef GISMO_BUILD_CPP11
+
+struct gsTaskScheduler::Impl
+{
+    struct Item
+    {
+        Task  * task;
+        Group * group;
+    };
+
+    // A deque of tasks; index 0 is shared by the threads which are
+    // not workers of the scheduler
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Item> items;
+    };
+
+    Impl() : queued(0), stopping(false) { }
+
+    void run(const int nThreads, const int firstCore)
+    {
+        queues.resize(nThreads);
+        for ( int i = 0; i != nThreads; ++i )
+            queues[i].reset(new Queue);
+        for ( int i = 1; i < nThreads; ++i )
+            workers.push_back( std::thread(&Impl::work, this, i, firstCore) );
+    }
+
+    ~Impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for ( size_t i = 0; i != workers.size(); ++i )
+            workers[i].join();
+    }
+
+    // The queue of the calling thread
+    int self() const { return owner == this ? id : 0; }
+
+    void push(const Item & item)
+    {
+        {
+            Queue & q = *queues[self()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.items.push_back(item);
+            ++queued;
+        }
+        // Locking orders the push before the check of a sleeping thread
+        { std::lock_guard<std::mutex> lock(mutex); }
+        wake.notify_all();
+    }
+
+    // Takes the newest task of the own queue, or else the oldest task
+    // of another queue
+    bool pop(const int me, Item & item)
+    {
+        if ( 0 == queued.load() )
+            return false;
+        const int n = static_cast<int>(queues.size());
+        for ( int k = 0; k != n; ++k )
+        {
+            Queue & q = *queues[(me + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if ( q.items.empty() )
+                continue;
+            if ( 0 == k )
+            {
+                item = q.items.back();
+                q.items.pop_back();
+            }
+            else
+            {
+                item = q.items.front();
+                q.items.pop_front();
+            }
+            --queued;
+            return true;
+        }
+        return false;
+    }
+
+    void execute(const Item & item)
+    {
+        std::string error;
+        try
+        {
+            item.task->run();
+        }
+        catch (std::exception & e)
+        {
+            error = e.what();
+            if ( error.empty() )
+                error = "Unknown exception";
+        }
+        catch (...)
+        {
+            error = "Unknown exception";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if ( !error.empty() && item.group->m_error.empty() )
+                item.group->m_error = error;
+            --item.group->m_pending;
+        }
+        wake.notify_all();
+    }
+
+    void wait(Group & group)
+    {
+        const int me = self();
+        Item item;
+        for (;;)
+        {
+            if ( pop(me, item) )
+            {
+                execute(item);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            if ( 0 == group.m_pending )
+                return;
+            wake.wait(lock, [&]{ return 0 == group.m_pending || queued.load() > 0; });
+            if ( 0 == group.m_pending )
+                return;
+        }
+    }
+
+    void work(const int me, const int firstCore)
+    {
+        owner = this;
+        id    = me;
+        if ( firstCore >= 0 )
+            pinToCore(firstCore + me);
+
+        Item item;
+        for (;;)
+        {
+            if ( pop(me, item) )
+            {
+                execute(item);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]{ return stopping || queued.load() > 0; });
+            if ( stopping && 0 == queued.load() )
+                return;
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue> > queues;
+
+    // The number of queued tasks
+    std::atomic<long> queued;
+
+    // Guards the groups and the sleeping of the threads
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    // The scheduler and the queue of a worker thread
+    static thread_local const Impl * owner;
+    static thread_local int id;
+
+    // Restored after the workers are stopped
+    SavedState saved;
+};
+
+thread_local const gsTaskScheduler::Impl * gsTaskScheduler::Impl::owner = NULL;
+thread_local int gsTaskScheduler::Impl::id = 0;
+
+#else
+
+struct gsTaskScheduler::Impl
+{
+    SavedState saved;
+};
+
+#endif
+
+gsTaskScheduler::gsTaskScheduler(const gsOptionList & opt)
+: m_impl(NULL)
+{
+    start(opt, NULL);
+}
+
+gsTaskScheduler::gsTaskScheduler(const gsOptionList & opt, const gsMpiComm & comm)
+: m_impl(NULL)
+{
+    start(opt, &comm);
+}
+
+gsTaskScheduler::~gsTaskScheduler()
+{
+    stop();
+}
+
+gsOptionList gsTaskScheduler::defaultOptions()
+{
+    gsOptionList opt;
+    opt.addInt   ("Threads", "Number of threads per process (0: the cores of the node shared by its processes)", 0);
+    opt.addSwitch("Pinning", "Pin the threads of every process to separate cores (Linux only)", false);
+    opt.addSwitch("LimitOpenMP", "Let the OpenMP regions of the thread starting the scheduler use the same number of threads", false);
+    return opt;
+}
+
+gsTaskScheduler & gsTaskScheduler::instance()
+{
+    static gsTaskScheduler s_instance;
+    return s_instance;
+}
+
+void gsTaskScheduler::reset(const gsOptionList & opt)
+{
+    stop();
+    start(opt, NULL);
+}
+
+void gsTaskScheduler::reset(const gsOptionList & opt, const gsMpiComm & comm)
+{
+    stop();
+    start(opt, &comm);
+}
+
+void gsTaskScheduler::start(const gsOptionList & opt, const gsMpiComm * comm)
+{
+    // The processes on the node of this process: the ones of comm
+    // (collective), or else the ones started by the MPI launcher
+    m_localRank = 0;
+    m_localSize = 1;
+    bool known = false;
+#ifdef GISMO_WITH_MPI
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if ( comm && initialized )
+    {
+        MPI_Comm node;
+        MPI_Comm_split_type(static_cast<MPI_Comm>(*comm), MPI_COMM_TYPE_SHARED,
+                            0, MPI_INFO_NULL, &node);
+        MPI_Comm_rank(node, &m_localRank);
+        MPI_Comm_size(node, &m_localSize);
+        MPI_Comm_free(&node);
+        known = true;
+    }
+#else
+    GISMO_UNUSED(comm);
+#endif
+    if ( !known )
+        localRankFromEnv(m_localRank, m_localSize);
+
+    m_cores = numProcessors();
+    int nThreads = opt.askInt("Threads", 0);
+    if ( nThreads <= 0 )
+        nThreads = math::max(1, m_cores / m_localSize);
+
+    m_impl = new Impl;
+
+    m_firstCore = -1;
+    if ( opt.askSwitch("Pinning", false) )
+    {
+        if ( (m_localRank + 1) * nThreads <= m_cores )
+            m_firstCore = m_localRank * nThreads;
+        else
+            gsWarn << "gsTaskScheduler: "<< m_localSize <<" processes with "
+                   << nThreads <<" threads exceed the "<< m_cores
+                   <<" cores of the node, the threads are not pinned.\n";
+    }
+    if ( m_firstCore >= 0 && !m_impl->saved.pin(m_firstCore) )
+    {
+        gsWarn << "gsTaskScheduler: Pinning is not supported.\n";
+        m_firstCore = -1;
+    }
+
+    if ( opt.askSwitch("LimitOpenMP", false) )
+        m_impl->saved.limitOpenMP(nThreads);
+
+#ifdef GISMO_BUILD_CPP11
+    m_threads = nThreads;
+    m_impl->run(nThreads, m_firstCore);
+#else
+    m_threads = 1;
+#endif
+}
+
+void gsTaskScheduler::stop()
+{
+    delete m_impl;
+    m_impl = NULL;
+}
+
+void gsTaskScheduler::spawn(Task & task, Group & group)
+{
+#ifdef GISMO_BUILD_CPP11
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        ++group.m_pending;
+    }
+    Impl::Item item = { &task, &group };
+    m_impl->push(item);
+#else
+    try
+    {
+        task.run();
+    }
+    catch (std::exception & e)
+    {
+        if ( group.m_error.empty() )
+            group.m_error = e.what();
+    }
+    catch (...)
+    {
+        if ( group.m_error.empty() )
+            group.m_error = "Unknown exception";
+    }
+#endif
+}
+
+void gsTaskScheduler::wait(Group & group)
+{
+#ifdef GISMO_BUILD_CPP11
+    m_impl->wait(group);
+#endif
+    if ( !group.m_error.empty() )
+    {
+        std::string error;
+        error.swap(group.m_error);
+        throw std::runtime_error(error);
+    }
+}
+
+} // namespace gismo
@@ -0,0 +1,212 @@
+/** @file gsTaskScheduler.h
+
+    @brief Provides a work-stealing thread pool which is aware of the
+    placement of the MPI processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsMath.h>
+#include <gsIO/gsOptionList.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/**
+   \brief A pool of worker threads executing tasks, shared by the
+   components of a process.
+
+   Every worker keeps a deque of tasks: it runs the tasks it spawned
+   last first, and steals the oldest tasks of the other workers when
+   its deque is empty. A thread waiting for a group of tasks (see
+   wait()) executes pending tasks meanwhile, so tasks may spawn and
+   wait for further tasks. Hence the assembly of the next system can
+   overlap with the solution of the current one:
+
+   \verbatim
+   gsTaskScheduler & sched = gsTaskScheduler::instance();
+   gsTaskScheduler::Group next;
+   sched.spawn(assembleNext, next); // a gsTaskScheduler::Task
+   solver.solve(rhs, x);            // meanwhile on this thread
+   sched.wait(next);
+   \endverbatim
+
+   The number of threads is chosen such that the processes which run
+   on the same node share the cores of the node without
+   oversubscription. With \em Pinning, the threads of every process
+   are pinned to consecutive cores, disjoint from the cores of the
+   other processes on the node (Linux only). With \em LimitOpenMP,
+   the OpenMP regions started by the thread which started the
+   scheduler use the same number of threads. Both are off by
+   default; the affinity and the number of OpenMP threads of that
+   thread are restored when the scheduler is stopped.
+
+   Without C++11 support (see the CMake option GISMO_BUILD_CPP11), no
+   threads are started and spawn() runs the task immediately.
+
+   \ingroup Utils
+*/
+class GISMO_EXPORT gsTaskScheduler
+{
+public:
+
+    /// A unit of work, see spawn()
+    class Task
+    {
+    public:
+        virtual ~Task() { }
+
+        /// Performs the work; exceptions are passed to wait()
+        virtual void run() = 0;
+    };
+
+    /// A set of spawned tasks, see wait()
+    class Group
+    {
+    public:
+        Group() : m_pending(0) { }
+
+        /// The number of spawned tasks which are not finished
+        long pending() const { return m_pending; }
+
+    private:
+        friend class gsTaskScheduler;
+        long m_pending;
+        std::string m_error;
+
+        // Copying is not allowed
+        Group(const Group &);
+        Group & operator=(const Group &);
+    };
+
+public:
+
+    /// \brief Starts the workers; the cores are shared with the
+    /// processes which the MPI launcher started on the same node, as
+    /// far as the launcher reports them in the environment (Open
+    /// MPI, MPICH, Intel MPI, MVAPICH2). Not collective.
+    explicit gsTaskScheduler(const gsOptionList & opt = defaultOptions());
+
+    /// \brief Starts the workers; the cores are shared with the
+    /// processes of \a comm which run on the same node. Collective
+    /// over \a comm.
+    gsTaskScheduler(const gsOptionList & opt, const gsMpiComm & comm);
+
+    /// Waits for the pending tasks and stops the workers
+    ~gsTaskScheduler();
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions();
+
+    /// \brief The scheduler of the process, started with the default
+    /// options by the first call, which is not collective. The first
+    /// call must not happen concurrently. To share the cores among
+    /// the processes of a communicator, call reset(opt, comm) on all
+    /// of its processes.
+    static gsTaskScheduler & instance();
+
+    /// \brief Stops the workers and starts them again with the
+    /// options \a opt. No tasks may be pending.
+    void reset(const gsOptionList & opt);
+
+    /// \brief Stops the workers and starts them again with the
+    /// options \a opt for the processes of \a comm. No tasks may be
+    /// pending. Collective over \a comm.
+    void reset(const gsOptionList & opt, const gsMpiComm & comm);
+
+    /// \brief Spawns the \a task as a member of \a group. The task is
+    /// referenced and must be alive until wait(\a group) returns.
+    void spawn(Task & task, Group & group);
+
+    /// \brief Waits until the tasks of \a group are finished, running
+    /// pending tasks meanwhile. Throws if a task has thrown.
+    void wait(Group & group);
+
+    /// \brief Calls \a body(i) for i = \a begin, ..., \a end - 1,
+    /// distributed over the threads in chunks of at least \a grain
+    /// indices. \a body must be safe to call concurrently.
+    template<class Body>
+    void parallelFor(index_t begin, index_t end, Body & body, index_t grain = 1);
+
+    /// The number of threads executing tasks, including the waiting thread
+    int numThreads() const { return m_threads; }
+
+    /// The rank of the process among the processes on its node
+    int localRank() const { return m_localRank; }
+
+    /// The number of processes on the node of the process
+    int localSize() const { return m_localSize; }
+
+    /// The number of cores of the node
+    int numCores() const { return m_cores; }
+
+    /// The first core used by the process if the threads are pinned, or -1
+    int firstCore() const { return m_firstCore; }
+
+private:
+
+    /// Calls body(i) for a range of indices
+    template<class Body>
+    class RangeTask : public Task
+    {
+    public:
+        RangeTask() : m_body(NULL), m_begin(0), m_end(0) { }
+        RangeTask(Body & body, index_t begin, index_t end)
+        : m_body(&body), m_begin(begin), m_end(end) { }
+        void run()
+        {
+            for ( index_t i = m_begin; i != m_end; ++i )
+                (*m_body)(i);
+        }
+    private:
+        Body * m_body;
+        index_t m_begin, m_end;
+    };
+
+    void start(const gsOptionList & opt, const gsMpiComm * comm);
+
+    void stop();
+
+private:
+
+    int m_threads, m_localRank, m_localSize, m_cores, m_firstCore;
+
+    /// The workers and their deques
+    struct Impl;
+    Impl * m_impl;
+
+private:
+    // Copying is not allowed
+    gsTaskScheduler(const gsTaskScheduler &);
+    gsTaskScheduler & operator=(const gsTaskScheduler &);
+};
+
+template<class Body>
+void gsTaskScheduler::parallelFor(const index_t begin, const index_t end,
+                                  Body & body, const index_t grain)
+{
+    if ( end <= begin )
+        return;
+
+    // A few chunks per thread balance the load
+    const index_t n = end - begin;
+    index_t nChunks = math::min<index_t>( 4 * m_threads, (n + grain - 1) / math::max<index_t>(grain, 1) );
+    nChunks = math::max<index_t>(nChunks, 1);
+    std::vector<RangeTask<Body> > tasks(nChunks);
+    Group group;
+    for ( index_t c = 0; c != nChunks; ++c )
+    {
+        tasks[c] = RangeTask<Body>(body, begin + c * n / nChunks, begin + (c + 1) * n / nChunks);
+        spawn(tasks[c], group);
+    }
+    wait(group);
+}
+
+} // namespace gismo